@@ -0,0 +1,102 @@
+// AS3935MI_BinaryStream.ino
+//
+// shows how to send events and calibration results as compact binary frames using AS3935Stream instead of
+// printing text. an event frame takes 14 bytes and fits into the serial transmit buffer, so sending it 
+// does not block the loop. use extras/host/stream_decode.cpp to decode the frames on the receiving side.
+//
+// Copyright (c) 2018-2019 Gregor Christandl
+//
+// connect the AS3935 to the Arduino like this:
+//
+// Arduino - AS3935
+// 5V ------ VCC
+// GND ----- GND
+// D2 ------ IRQ		must be a pin supporting external interrupts, e.g. D2 or D3 on an Arduino Uno.
+// SDA ----- MOSI
+// SCL ----- SCL
+// 5V ------ SI		(activates I2C for the AS3935)
+// 5V ------ A0		(sets the AS3935' I2C address to 0x01)
+// GND ----- A1		(sets the AS3935' I2C address to 0x01)
+// 5V ------ EN_VREG !IMPORTANT when using 5V Arduinos (Uno, Mega2560, ...)
+// other pins can be left unconnected.
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <AS3935I2C.h>
+#include <AS3935Stream.h>
+
+#define PIN_IRQ 2
+
+AS3935I2C as3935(AS3935I2C::AS3935I2C_A01, PIN_IRQ);
+
+//frames are encoded into this buffer. large enough for a calibration frame.
+uint8_t stream_buffer_[96];
+AS3935Stream stream_(stream_buffer_, sizeof(stream_buffer_));
+
+//this value will be set to true by the AS3935 interrupt service routine.
+volatile bool interrupt_ = false;
+
+void setup() {
+	// put your setup code here, to run once:
+	Serial.begin(9600);
+
+	//wait for serial connection to open (only necessary on some boards)
+	while (!Serial);
+
+	pinMode(PIN_IRQ, INPUT);
+
+	Wire.begin();
+
+	//frames can not report errors, so stop if the sensor can not be initialized.
+	if (!as3935.begin() || !as3935.checkConnection())
+		while (1);
+
+	as3935.calibrateResonanceFrequency();
+	as3935.calibrateRCO();
+
+	//send the calibration results
+	if (stream_.encodeCalibration(as3935))
+		Serial.write(stream_.data(), stream_.size());
+
+	as3935.writeAFE(AS3935MI::AS3935_INDOORS);
+
+	attachInterrupt(digitalPinToInterrupt(PIN_IRQ), AS3935ISR, RISING);
+}
+
+void loop() {
+	// put your main code here, to run repeatedly:
+
+	if (interrupt_)
+	{
+		//the Arduino should wait at least 2ms after the IRQ pin has been pulled high
+		delay(2);
+
+		interrupt_ = false;
+
+		AS3935Event event;
+		as3935.readEvent(event);
+
+		if (stream_.encodeEvent(event))
+			Serial.write(stream_.data(), stream_.size());
+	}
+}
+
+//interrupt service routine. this function is called each time the AS3935 reports an event by pulling 
+//the IRQ pin high.
+#if defined(ESP32)
+ICACHE_RAM_ATTR void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#elif defined(ESP8266)
+ICACHE_RAM_ATTR void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#else
+void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#endif
@@ -0,0 +1,163 @@
+// AS3935MI_EventJournal.ino
+//
+// shows how to store events in the EEPROM using AS3935Journal, so they survive a power loss. 
+// events are collected in RAM and written to the EEPROM one page at a time. 
+//
+// Copyright (c) 2018-2019 Gregor Christandl
+//
+// connect the AS3935 to the Arduino like this:
+//
+// Arduino - AS3935
+// 5V ------ VCC
+// GND ----- GND
+// D2 ------ IRQ		must be a pin supporting external interrupts, e.g. D2 or D3 on an Arduino Uno.
+// SDA ----- MOSI
+// SCL ----- SCL
+// 5V ------ SI		(activates I2C for the AS3935)
+// 5V ------ A0		(sets the AS3935' I2C address to 0x01)
+// GND ----- A1		(sets the AS3935' I2C address to 0x01)
+// 5V ------ EN_VREG !IMPORTANT when using 5V Arduinos (Uno, Mega2560, ...)
+// other pins can be left unconnected.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <EEPROM.h>
+
+#include <AS3935I2C.h>
+#include <AS3935Journal.h>
+
+#define PIN_IRQ 2
+
+//EEPROM area used for the journal
+constexpr uint16_t JOURNAL_PAGE_SIZE = 64;
+constexpr uint16_t JOURNAL_PAGE_COUNT = 8;
+
+//block device storing pages in the EEPROM. 
+class EEPROMBlockDevice : public AS3935BlockDevice
+{
+public:
+	uint16_t pageSize() const { return JOURNAL_PAGE_SIZE; }
+
+	uint16_t pageCount() const { return JOURNAL_PAGE_COUNT; }
+
+	bool read(uint16_t page, uint16_t offset, uint8_t *data, uint16_t length)
+	{
+		for (uint16_t i = 0; i < length; i++)
+			data[i] = EEPROM.read(page * JOURNAL_PAGE_SIZE + offset + i);
+
+		return true;
+	}
+
+	bool writePage(uint16_t page, const uint8_t *data)
+	{
+		for (uint16_t i = 0; i < JOURNAL_PAGE_SIZE; i++)
+			EEPROM.write(page * JOURNAL_PAGE_SIZE + i, data[i]);
+
+#if defined(ESP8266) || defined(ESP32)
+		return EEPROM.commit();
+#else
+		return true;
+#endif
+	}
+};
+
+AS3935I2C as3935(AS3935I2C::AS3935I2C_A01, PIN_IRQ);
+
+EEPROMBlockDevice eeprom_;
+uint8_t page_buffer_[JOURNAL_PAGE_SIZE];
+AS3935Journal journal_(&eeprom_, page_buffer_);
+
+//this value will be set to true by the AS3935 interrupt service routine.
+volatile bool interrupt_ = false;
+
+void setup() {
+	// put your setup code here, to run once:
+	Serial.begin(9600);
+
+	//wait for serial connection to open (only necessary on some boards)
+	while (!Serial);
+
+#if defined(ESP8266) || defined(ESP32)
+	EEPROM.begin(JOURNAL_PAGE_SIZE * JOURNAL_PAGE_COUNT);
+#endif
+
+	//find the most recent page in the EEPROM and continue the journal after it. 
+	if (!journal_.begin())
+	{
+		Serial.println("journal begin() failed. ");
+		while (1);
+	}
+
+	//print the events stored before the last reset
+	AS3935Journal::Iterator it = journal_.iterator();
+	AS3935Event event;
+	while (it.next(event))
+	{
+		Serial.print(event.timestamp);
+		Serial.print(" ms: source ");
+		Serial.print(event.source);
+		Serial.print(", energy ");
+		Serial.print(event.energy);
+		Serial.print(", distance ");
+		Serial.print(event.distance);
+		Serial.println(" km");
+	}
+
+	pinMode(PIN_IRQ, INPUT);
+
+	Wire.begin();
+
+	if (!as3935.begin())
+	{
+		Serial.println("begin() failed. Check the I2C address passed to the AS3935I2C constructor. ");
+		while (1);
+	}
+
+	as3935.calibrateResonanceFrequency();
+	as3935.calibrateRCO();
+
+	as3935.writeAFE(AS3935MI::AS3935_INDOORS);
+
+	attachInterrupt(digitalPinToInterrupt(PIN_IRQ), AS3935ISR, RISING);
+
+	Serial.println("Initialization complete, waiting for events...");
+}
+
+void loop() {
+	// put your main code here, to run repeatedly:
+
+	if (interrupt_)
+	{
+		//the Arduino should wait at least 2ms after the IRQ pin has been pulled high
+		delay(2);
+
+		interrupt_ = false;
+
+		AS3935Event event;
+		as3935.readEvent(event);
+
+		//the event is written to the EEPROM together with other events when the page buffer is full. 
+		//call journal_.flush() to write the buffered events immediately, e.g. before going to sleep.
+		if (!journal_.append(event))
+			Serial.println("writing journal page failed. ");
+	}
+}
+
+//interrupt service routine. this function is called each time the AS3935 reports an event by pulling 
+//the IRQ pin high.
+#if defined(ESP32)
+ICACHE_RAM_ATTR void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#elif defined(ESP8266)
+ICACHE_RAM_ATTR void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#else
+void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#endif
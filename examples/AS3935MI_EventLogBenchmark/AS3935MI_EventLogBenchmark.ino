@@ -0,0 +1,121 @@
+// AS3935MI_EventLogBenchmark.ino
+//
+// shows how to store events in an AS3935EventLog and reports the number of bytes used per event 
+// when logging a synthetic storm trace. no sensor needs to be connected to run this example. 
+//
+// Copyright (c) 2018-2019 Gregor Christandl
+
+#include <Arduino.h>
+
+#include <AS3935MI.h>
+#include <AS3935EventLog.h>
+
+//number of events in the synthetic storm trace
+constexpr uint16_t NR_EVENTS = 200;
+
+//memory used to store events. when the buffer is full, the oldest events are dropped. 
+uint8_t log_buffer_[512];
+
+AS3935EventLog event_log_(log_buffer_, sizeof(log_buffer_));
+
+//simple pseudo random number generator so the trace is identical on all platforms.
+uint32_t random_state_ = 0x12345678;
+
+uint32_t nextRandom()
+{
+	random_state_ ^= random_state_ << 13;
+	random_state_ ^= random_state_ >> 17;
+	random_state_ ^= random_state_ << 5;
+	return random_state_;
+}
+
+//creates the next event of a storm approaching from 40km, passing overhead and moving away again. 
+AS3935Event nextStormEvent(uint16_t index, uint32_t &timestamp)
+{
+	AS3935Event event;
+
+	//up to 20 seconds between events
+	timestamp += nextRandom() % 20000;
+	event.timestamp = timestamp;
+	event.energy = 0;
+	event.distance = 0;
+
+	int16_t distance = 40 - (80 * static_cast<int32_t>(index)) / NR_EVENTS;
+	if (distance < 0)
+		distance = -distance;
+	if (distance == 0)
+		distance = 1;
+
+	const uint8_t type = nextRandom() % 20;
+	if (type < 12)
+	{
+		event.source = AS3935MI::AS3935_INT_L;
+		event.energy = nextRandom() & 0xFFFFF;
+		event.distance = distance;
+	}
+	else if (type < 18)
+	{
+		event.source = AS3935MI::AS3935_INT_D;
+	}
+	else if (type < 19)
+	{
+		event.source = AS3935MI::AS3935_INT_NH;
+	}
+	else
+	{
+		event.source = AS3935MI::AS3935_INT_DUPDATE;
+		event.distance = distance;
+	}
+
+	return event;
+}
+
+void setup() {
+	// put your setup code here, to run once:
+	Serial.begin(9600);
+
+	//wait for serial connection to open (only necessary on some boards)
+	while (!Serial);
+
+	uint32_t timestamp = 0;
+	for (uint16_t i = 0; i < NR_EVENTS; i++)
+		event_log_.append(nextStormEvent(i, timestamp));
+
+	//read back all events and make sure they match the trace
+	random_state_ = 0x12345678;
+	timestamp = 0;
+
+	//skip the events that have been dropped from the log
+	uint16_t nr_events = 0;
+	while (nr_events < event_log_.dropped())
+		nextStormEvent(nr_events++, timestamp);
+
+	AS3935Event event;
+	AS3935EventLog::Iterator it = event_log_.iterator();
+	while (it.next(event))
+	{
+		AS3935Event expected = nextStormEvent(nr_events++, timestamp);
+		if ((event.timestamp != expected.timestamp) || (event.source != expected.source) ||
+			(event.energy != expected.energy) || (event.distance != expected.distance))
+		{
+			Serial.print("event ");
+			Serial.print(nr_events - 1);
+			Serial.println(" does not match the trace.");
+		}
+	}
+
+	Serial.print("events: ");
+	Serial.println(event_log_.count());
+	Serial.print("events dropped: ");
+	Serial.println(event_log_.dropped());
+	Serial.print("bytes used: ");
+	Serial.println(event_log_.bytesUsed());
+	Serial.print("bytes per event: ");
+	Serial.println(static_cast<float>(event_log_.bytesUsed()) / event_log_.count());
+	Serial.print("bytes per event (raw AS3935Event): ");
+	Serial.println(sizeof(AS3935Event));
+}
+
+void loop() {
+	// put your main code here, to run repeatedly:
+}
@@ -0,0 +1,96 @@
+// AS3935MI_Polling.ino
+//
+// shows how to use a sensor whose IRQ pin is not connected. AS3935Poller polls the interrupt register every 2ms 
+// while events arrive and backs off to 256ms when idle, spending at most 1% of the time on the bus. 
+// the antenna can not be calibrated without IRQ pin, write a tuning capacitor setting determined with another board 
+// instead.
+//
+// Copyright (c) 2018-2019 Gregor Christandl
+//
+// connect the AS3935 to the Arduino like this:
+//
+// Arduino - AS3935
+// 5V ------ VCC
+// GND ----- GND
+// SDA ----- MOSI
+// SCL ----- SCL
+// 5V ------ SI		(activates I2C for the AS3935)
+// 5V ------ A0		(sets the AS3935' I2C address to 0x01)
+// GND ----- A1		(sets the AS3935' I2C address to 0x01)
+// 5V ------ EN_VREG !IMPORTANT when using 5V Arduinos (Uno, Mega2560, ...)
+// other pins can be left unconnected.
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <AS3935I2C.h>
+#include <AS3935Poller.h>
+
+//tuning capacitor setting of the antenna
+#define ANTENNA_TUNING 7
+
+AS3935I2C as3935(AS3935I2C::AS3935I2C_A01, AS3935MI::AS3935_NO_IRQ);
+
+AS3935Poller poller_(as3935, 2000, 256000, 10);
+
+void setup() {
+	// put your setup code here, to run once:
+	Serial.begin(115200);
+
+	//wait for serial connection to open (only necessary on some boards)
+	while (!Serial);
+
+	Wire.begin();
+
+	if (!as3935.begin())
+	{
+		Serial.println("begin() failed. check your AS3935 Interface setting.");
+		while (1);
+	}
+
+	as3935.writeAntennaTuning(ANTENNA_TUNING);
+
+	if (!as3935.calibrateRCO())
+		Serial.println("RCO calibration failed.");
+
+	as3935.writeAFE(AS3935MI::AS3935_INDOORS);
+}
+
+void loop() {
+	// put your main code here, to run repeatedly:
+	AS3935Event event;
+
+	switch (poller_.update(event))
+	{
+	case AS3935MI::AS3935_INT_NH:
+		Serial.println("Noise level too high");
+		as3935.increaseNoiseFloorThreshold();
+		break;
+	case AS3935MI::AS3935_INT_D:
+		Serial.println("Disturber detected");
+		break;
+	case AS3935MI::AS3935_INT_L:
+		Serial.print("Lightning detected, storm distance ");
+		Serial.print(event.distance);
+		Serial.println(" km");
+		break;
+	default:
+		break;
+	}
+
+	//print the polling statistics once per minute
+	static uint32_t last_report = 0;
+	if (millis() - last_report >= 60000)
+	{
+		last_report = millis();
+
+		const AS3935Poller::statistics_t statistics = poller_.getStatistics();
+		Serial.print("polls: ");
+		Serial.print(statistics.polls);
+		Serial.print(", bus load: ");
+		Serial.print(poller_.getBusLoad());
+		Serial.print(" per mille, highest detection latency: ");
+		Serial.print(statistics.latency_max_usec / 1000);
+		Serial.println(" ms");
+	}
+}
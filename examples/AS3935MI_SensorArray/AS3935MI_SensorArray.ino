@@ -0,0 +1,169 @@
+// AS3935MI_SensorArray.ino
+//
+// shows how to run three AS3935 sensors on one I2C bus with AS3935Array. the array reads the events of the 
+// sensors by deadline, changes settings of the sensors between events and checks their antennas once per hour. 
+// lightnings reported by several sensors within 1ms are merged into one strike by AS3935Fusion. 
+//
+// Copyright (c) 2018-2019 Gregor Christandl
+//
+// connect the AS3935s to the Arduino like this:
+//
+// Arduino - AS3935
+// 5V ------ VCC
+// GND ----- GND
+// D2 ------ IRQ		of the first sensor, D3 and D4 for the second and third sensor. 
+// SDA ----- MOSI
+// SCL ----- SCL
+// 5V ------ SI		(activates I2C for the AS3935)
+// A0, A1 sets the I2C address: 5V / GND (0x01), GND / 5V (0x02), 5V / 5V (0x03) for the first, second and third sensor.
+// 5V ------ EN_VREG !IMPORTANT when using 5V Arduinos (Uno, Mega2560, ...)
+// other pins can be left unconnected.
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <AS3935Array.h>
+#include <AS3935Fusion.h>
+#include <AS3935TwoWire.h>
+
+#define NR_SENSORS 3
+
+AS3935TwoWire sensor_0_(&Wire, AS3935TwoWire::AS3935I2C_A01, 2);
+AS3935TwoWire sensor_1_(&Wire, AS3935TwoWire::AS3935I2C_A10, 3);
+AS3935TwoWire sensor_2_(&Wire, AS3935TwoWire::AS3935I2C_A11, 4);
+
+AS3935MI *sensors_[NR_SENSORS] = { &sensor_0_, &sensor_1_, &sensor_2_ };
+
+AS3935ArrayEntry entries_[NR_SENSORS];
+AS3935Array array_(entries_, NR_SENSORS);
+
+//strikes are reported 1ms after the last sensor could have seen them, plus the event deadline
+AS3935FusionSlot slots_[4];
+AS3935Fusion fusion_(slots_, 4, 1000, 100000);
+
+//raises the noise floor threshold of a sensor, scheduled when it reports noise
+void increaseNoiseFloor(AS3935MI &sensor, void *)
+{
+	sensor.increaseNoiseFloorThreshold();
+}
+
+void setup() {
+	// put your setup code here, to run once:
+	Serial.begin(115200);
+
+	//wait for serial connection to open (only necessary on some boards)
+	while (!Serial);
+
+	Wire.begin();
+
+	for (uint8_t i = 0; i < NR_SENSORS; i++)
+	{
+		pinMode(2 + i, INPUT);
+
+		if (!sensors_[i]->begin())
+		{
+			Serial.print("begin() failed for sensor ");
+			Serial.println(i);
+			while (1);
+		}
+
+		sensors_[i]->calibrateRCO();
+		sensors_[i]->writeAFE(AS3935MI::AS3935_INDOORS);
+
+		//events must be read within 100ms after the IRQ
+		array_.add(*sensors_[i], 100);
+		array_.setDriftCheckInterval(i, 3600000ul);
+	}
+
+	//calibrates all sensors at once on cores with attachInterruptArg(), e.g. ESP32
+	if (!array_.calibrateResonanceFrequency())
+		Serial.println("antenna calibration failed for at least one sensor");
+
+	//the interrupt service routines record the IRQ time of each sensor
+	for (uint8_t i = 0; i < NR_SENSORS; i++)
+		sensors_[i]->setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+}
+
+void loop() {
+	// put your main code here, to run repeatedly:
+	uint8_t index = 0;
+	AS3935Event event;
+
+	switch (array_.update(index, event))
+	{
+	case AS3935Array::AS3935_ARRAY_EVENT:
+		Serial.print("sensor ");
+		Serial.print(index);
+
+		switch (event.source)
+		{
+		case AS3935MI::AS3935_INT_NH:
+			Serial.println(": noise level too high");
+			array_.scheduleTask(index, increaseNoiseFloor, nullptr, 1000);
+			break;
+		case AS3935MI::AS3935_INT_D:
+			Serial.println(": disturber detected");
+			break;
+		case AS3935MI::AS3935_INT_L:
+			Serial.print(": lightning at ");
+			Serial.print(event.distance);
+			Serial.println(" km");
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+			//on cores without attachInterruptArg() (e.g. AVR) the interrupt time is shared by all sensors, see AS3935Fusion::add()
+			fusion_.add(index, event, array_.getSensor(index).getInterruptMicros());
+#else
+			//without the interrupt time the strike is timed when the event is read, up to the event deadline late
+			fusion_.add(index, event, micros());
+#endif
+			break;
+		default:
+			Serial.println(": distance update");
+			break;
+		}
+		break;
+
+	case AS3935Array::AS3935_ARRAY_DRIFT_CHECK:
+	{
+		int32_t frequency = 0;
+		if (!array_.getDriftCheckResult(index, frequency))
+		{
+			Serial.print("sensor ");
+			Serial.print(index);
+			Serial.print(": antenna detuned, ");
+			Serial.print(frequency);
+			Serial.println(" Hz");
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+
+	AS3935Strike strike;
+	while (fusion_.next(strike, micros()))
+	{
+		Serial.print("strike seen by ");
+		Serial.print(strike.count);
+		Serial.print(" sensors at ");
+		Serial.print(strike.distance);
+		Serial.println(" km");
+	}
+
+	//print bus utilization and missed deadlines once per minute
+	static uint32_t last_report = 0;
+	if (millis() - last_report >= 60000)
+	{
+		last_report = millis();
+
+		for (uint8_t i = 0; i < NR_SENSORS; i++)
+		{
+			Serial.print("sensor ");
+			Serial.print(i);
+			Serial.print(": bus utilization ");
+			Serial.print(array_.getBusUtilization(i));
+			Serial.print(" per mille, missed deadlines ");
+			Serial.println(array_.getStatistics(i).missed_deadlines);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+// AS3935MI_TraceRecorder.ino
+//
+// shows how to record the bus traffic and IRQ pin activity of a sensor with AS3935Recorder. 
+// the trace is written to the serial port, no other output is sent. capture it on the host, e.g. 
+//   stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > trace.bin
+// and inspect it with extras/host/trace_dump or replay it with AS3935Replay (see extras/host/trace_test.cpp). 
+//
+// Copyright (c) 2018-2019 Gregor Christandl
+//
+// connect the AS3935 to the Arduino like this:
+//
+// Arduino - AS3935
+// 5V ------ VCC
+// GND ----- GND
+// D2 ------ IRQ		must be a pin supporting external interrupts, e.g. D2 or D3 on an Arduino Uno.
+// SDA ----- MOSI
+// SCL ----- SCL
+// 5V ------ SI		(activates I2C for the AS3935)
+// 5V ------ A0		(sets the AS3935' I2C address to 0x01)
+// GND ----- A1		(sets the AS3935' I2C address to 0x01)
+// 5V ------ EN_VREG !IMPORTANT when using 5V Arduinos (Uno, Mega2560, ...)
+// other pins can be left unconnected.
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <AS3935I2C.h>
+#include <AS3935Recorder.h>
+
+#define PIN_IRQ 2
+
+//the sensor to record. do not call any functions of this object, use the recorder instead. 
+AS3935I2C sensor_(AS3935I2C::AS3935I2C_A01, PIN_IRQ);
+
+AS3935Recorder as3935(sensor_, Serial);
+
+//this value will be set to true by the AS3935 interrupt service routine.
+volatile bool interrupt_ = false;
+
+void setup() {
+	// put your setup code here, to run once:
+	Serial.begin(115200);
+
+	//wait for serial connection to open (only necessary on some boards)
+	while (!Serial);
+
+	pinMode(PIN_IRQ, INPUT);
+
+	Wire.begin();
+
+	//begin() writes the trace header. 
+	if (!as3935.begin())
+		while (1);
+
+	//the calibration is recorded including the oscillator signals measured on the IRQ pin.
+	as3935.calibrateResonanceFrequency();
+	as3935.calibrateRCO();
+
+	as3935.writeAFE(AS3935MI::AS3935_INDOORS);
+	as3935.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_2);
+
+	attachInterrupt(digitalPinToInterrupt(PIN_IRQ), AS3935ISR, RISING);
+}
+
+void loop() {
+	// put your main code here, to run repeatedly:
+
+	if (interrupt_)
+	{
+		//the Arduino should wait at least 2ms after the IRQ pin has been pulled high
+		delay(2);
+
+		interrupt_ = false;
+
+		AS3935Event event;
+		if (as3935.readEvent(event) == AS3935MI::AS3935_INT_NH)
+			as3935.increaseNoiseFloorThreshold();
+	}
+}
+
+//interrupt service routine. this function is called each time the AS3935 reports an event by pulling 
+//the IRQ pin high.
+#if defined(ESP32)
+ICACHE_RAM_ATTR void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#elif defined(ESP8266)
+ICACHE_RAM_ATTR void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#else
+void AS3935ISR()
+{
+  interrupt_ = true;
+}
+#endif
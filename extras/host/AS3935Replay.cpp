@@ -0,0 +1,160 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Replay.h"
+
+#include "ArduinoHost.h"
+
+AS3935Replay::AS3935Replay(uint8_t irq, const uint8_t *data, size_t length) :
+	AS3935MI(irq),
+	irq_pin_(irq),
+	valid_(false),
+	next_(0),
+	start_(0),
+	start_ns_(0),
+	divergences_(0),
+	first_divergence_(-1),
+	alive_(std::make_shared<bool>(true))
+{
+	hostSetVirtualTime(true);
+	hostWritePin(irq_pin_, LOW);
+
+	AS3935TraceReader reader(data, length);
+	valid_ = reader.valid();
+
+	start_ns_ = hostNanos();
+
+	bool first = true;
+	AS3935TraceRecord record;
+	while (reader.next(record))
+	{
+		if (first)
+		{
+			start_ = record.timestamp;
+			first = false;
+		}
+
+		std::shared_ptr<bool> alive = alive_;
+
+		switch (record.type)
+		{
+		case AS3935TraceRecord::AS3935_TRACE_READ:
+		case AS3935TraceRecord::AS3935_TRACE_WRITE:
+			accesses_.push_back(record);
+			break;
+		case AS3935TraceRecord::AS3935_TRACE_IRQ:
+			hostSchedule(toVirtual(record.timestamp), [this, alive, record]() {
+				if (*alive)
+					hostWritePin(irq_pin_, record.value);
+			});
+			break;
+		case AS3935TraceRecord::AS3935_TRACE_OSCILLATOR:
+			if (record.period)
+			{
+				//the signal starts low, the first edge follows after half a period
+				const uint64_t time = toVirtual(record.timestamp);
+				scheduleOscillator(time + record.period / 2, time + record.duration * 1000ull, record.period / 2);
+			}
+			break;
+		}
+	}
+}
+
+AS3935Replay::~AS3935Replay()
+{
+	*alive_ = false;
+}
+
+bool AS3935Replay::beginInterface()
+{
+	return valid_;
+}
+
+uint8_t AS3935Replay::readRegister(uint8_t reg)
+{
+	const AS3935TraceRecord *record = replay(AS3935TraceRecord::AS3935_TRACE_READ, reg);
+
+	return record ? record->value : 0xFF;
+}
+
+void AS3935Replay::writeRegister(uint8_t reg, uint8_t value)
+{
+	const AS3935TraceRecord *record = replay(AS3935TraceRecord::AS3935_TRACE_WRITE, reg);
+
+	if (record && (record->value != value))
+	{
+		divergences_++;
+		if (first_divergence_ < 0)
+			first_divergence_ = static_cast<long>(next_ - 1);
+	}
+}
+
+uint64_t AS3935Replay::toVirtual(uint32_t timestamp) const
+{
+	//recorded timestamps may wrap around
+	const int64_t offset = static_cast<int32_t>(timestamp - start_);
+
+	return start_ns_ + offset * 1000;
+}
+
+const AS3935TraceRecord *AS3935Replay::replay(uint8_t type, uint8_t reg)
+{
+	if (finished())
+	{
+		divergences_++;
+		if (first_divergence_ < 0)
+			first_divergence_ = static_cast<long>(next_);
+		return nullptr;
+	}
+
+	const AS3935TraceRecord *record = &accesses_[next_++];
+
+	const uint64_t time = toVirtual(record->timestamp);
+	if (time > hostNanos())
+		hostAdvanceTime(time - hostNanos());
+
+	if ((record->type != type) || (record->reg != reg))
+	{
+		divergences_++;
+		if (first_divergence_ < 0)
+			first_divergence_ = static_cast<long>(next_ - 1);
+	}
+
+	return record;
+}
+
+void AS3935Replay::scheduleOscillator(uint64_t time, uint64_t end, uint32_t half_period)
+{
+	std::shared_ptr<bool> alive = alive_;
+
+	//one edge at a time, so a long oscillator record does not fill the schedule
+	hostSchedule(time, [this, alive, time, end, half_period]() {
+		if (!*alive)
+			return;
+
+		const uint64_t next = time + half_period;
+		if (next >= end)
+		{
+			hostWritePin(irq_pin_, LOW);
+			return;
+		}
+
+		hostWritePin(irq_pin_, (digitalRead(irq_pin_) == HIGH) ? LOW : HIGH);
+		scheduleOscillator(next, end, half_period);
+	});
+}
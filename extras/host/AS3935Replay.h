@@ -0,0 +1,110 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935REPLAY_H_
+#define AS3935REPLAY_H_
+
+#include "AS3935MI.h"
+#include "AS3935Trace.h"
+
+#include <memory>
+#include <vector>
+
+//replays a trace recorded by AS3935Recorder in virtual time (see ArduinoHost.h). register reads return the 
+//recorded values, register accesses advance the virtual time to the recorded time, IRQ pin level changes and 
+//oscillator signals are reproduced on the IRQ pin at the recorded times. the driver must issue the same 
+//sequence of register accesses as during recording, deviations are counted as divergences. 
+class AS3935Replay :
+	public AS3935MI
+{
+public:
+	/*
+	@param irq IRQ pin.
+	@param data trace. 
+	@param length length of the trace in bytes. */
+	AS3935Replay(uint8_t irq, const uint8_t *data, size_t length);
+	virtual ~AS3935Replay();
+
+	/*
+	@return true if the trace has a valid header, false otherwise. */
+	bool valid() const {
+		return valid_;
+	}
+
+	/*
+	@return true if all recorded register accesses have been replayed. */
+	bool finished() const {
+		return next_ >= accesses_.size();
+	}
+
+	/*
+	@return number of register accesses replayed. */
+	size_t getReplayed() const {
+		return next_;
+	}
+
+	/*
+	@return number of register accesses that did not match the trace. */
+	uint32_t getDivergences() const {
+		return divergences_;
+	}
+
+	/*
+	@return index of the first register access that did not match the trace, -1 if none. */
+	long getFirstDivergence() const {
+		return first_divergence_;
+	}
+
+private:
+	virtual bool beginInterface();
+
+	virtual uint8_t readRegister(uint8_t reg);
+
+	virtual void writeRegister(uint8_t reg, uint8_t value);
+
+	/*
+	@param timestamp recorded time in microseconds.
+	@return virtual time in nanoseconds. */
+	uint64_t toVirtual(uint32_t timestamp) const;
+
+	/*
+	checks the next recorded register access and advances the virtual time to it. 
+	@return recorded access, nullptr at the end of the trace. */
+	const AS3935TraceRecord *replay(uint8_t type, uint8_t reg);
+
+	/*
+	schedules the edges of an oscillator signal on the IRQ pin. */
+	void scheduleOscillator(uint64_t time, uint64_t end, uint32_t half_period);
+
+	uint8_t irq_pin_;
+
+	bool valid_;
+
+	std::vector<AS3935TraceRecord> accesses_;	//recorded register reads and writes
+	size_t next_;
+
+	uint32_t start_;			//timestamp of the first record
+	uint64_t start_ns_;			//virtual time of the first record
+
+	uint32_t divergences_;
+	long first_divergence_;
+
+	std::shared_ptr<bool> alive_;	//cleared by the destructor to cancel scheduled pin changes
+};
+
+#endif /* AS3935REPLAY_H_ */
@@ -0,0 +1,430 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Sim.h"
+
+#include <math.h>
+
+#include "ArduinoHost.h"
+
+namespace
+{
+	const uint8_t AS3935SIM_DIRECT_CMD = 0x96;
+
+	const uint8_t AS3935SIM_REG_AFE = 0x00;
+	const uint8_t AS3935SIM_REG_INT = 0x03;
+	const uint8_t AS3935SIM_REG_ENERGY_L = 0x04;
+	const uint8_t AS3935SIM_REG_ENERGY_M = 0x05;
+	const uint8_t AS3935SIM_REG_ENERGY_MM = 0x06;
+	const uint8_t AS3935SIM_REG_DISTANCE = 0x07;
+	const uint8_t AS3935SIM_REG_DISP = 0x08;
+	const uint8_t AS3935SIM_REG_TRCO_CALIB = 0x3A;
+	const uint8_t AS3935SIM_REG_SRCO_CALIB = 0x3B;
+	const uint8_t AS3935SIM_REG_PRESET_DEFAULT = 0x3C;
+	const uint8_t AS3935SIM_REG_CALIB_RCO = 0x3D;
+
+	const uint8_t AS3935SIM_MASK_PWD = 0b00000001;
+	const uint8_t AS3935SIM_MASK_MASK_DIST = 0b00100000;
+	const uint8_t AS3935SIM_MASK_INT = 0b00001111;
+	const uint8_t AS3935SIM_MASK_LCO_FDIV = 0b11000000;
+	const uint8_t AS3935SIM_MASK_DISP_LCO = 0b10000000;
+	const uint8_t AS3935SIM_MASK_DISP_SRCO = 0b01000000;
+	const uint8_t AS3935SIM_MASK_DISP_TRCO = 0b00100000;
+	const uint8_t AS3935SIM_MASK_TUN_CAP = 0b00001111;
+
+	const uint8_t AS3935SIM_CALIB_DONE = 0b10000000;
+	const uint8_t AS3935SIM_CALIB_NOK = 0b01000000;
+
+	//time the RCO calibration takes to complete
+	const uint64_t AS3935SIM_RCO_CALIBRATION_NS = 1000000ull;
+}
+
+AS3935Sim::AS3935Sim(uint8_t irq) :
+	AS3935MI(irq),
+	irq_pin_(irq),
+	inductance_uH_(100.0),
+	capacitance_pF_(960.0),
+	srco_hz_(1100000.0),
+	trco_hz_(32768.0),
+	rco_calibration_failure_(false),
+	rco_calibration_pending_(false),
+	rco_calibration_start_ns_(0),
+	nak_while_displaying_(false),
+	bus_read_ns_(0),
+	bus_write_ns_(0),
+	bus_burst_ns_(0),
+	display_(AS3935SIM_DISPLAY_NONE),
+	display_generation_(std::make_shared<uint32_t>(0)),
+	display_start_ns_(0),
+	display_half_period_ns_(0.0),
+	display_edges_(0),
+	irq_level_(LOW),
+	interrupt_pending_(false),
+	lost_interrupts_(0),
+	register_reads_(0),
+	burst_reads_(0),
+	register_writes_(0)
+{
+	hostSetVirtualTime(true);
+
+	presetDefault();
+
+	//the calibration status registers are only updated by a calibration
+	registers_[AS3935SIM_REG_TRCO_CALIB] = 0;
+	registers_[AS3935SIM_REG_SRCO_CALIB] = 0;
+
+	hostWritePin(irq_pin_, LOW);
+}
+
+AS3935Sim::~AS3935Sim()
+{
+	//cancel scheduled edges, they may run after this object has been destroyed
+	(*display_generation_)++;
+}
+
+void AS3935Sim::setAntenna(double inductance_uH, double capacitance_pF)
+{
+	inductance_uH_ = inductance_uH;
+	capacitance_pF_ = capacitance_pF;
+	updateDisplay();
+}
+
+double AS3935Sim::getResonanceFrequency(uint8_t tuning) const
+{
+	const double inductance = inductance_uH_ * 1e-6;
+	const double capacitance = (capacitance_pF_ + 8.0 * (tuning & AS3935SIM_MASK_TUN_CAP)) * 1e-12;
+
+	return 1.0 / (2.0 * M_PI * sqrt(inductance * capacitance));
+}
+
+void AS3935Sim::setRCOFrequencies(double srco_hz, double trco_hz)
+{
+	srco_hz_ = srco_hz;
+	trco_hz_ = trco_hz;
+	updateDisplay();
+}
+
+void AS3935Sim::setRCOCalibrationFailure(bool fail)
+{
+	rco_calibration_failure_ = fail;
+}
+
+void AS3935Sim::setNakWhileDisplaying(bool nak)
+{
+	nak_while_displaying_ = nak;
+}
+
+void AS3935Sim::setBusTiming(uint32_t read_ns, uint32_t write_ns, uint32_t burst_ns)
+{
+	bus_read_ns_ = read_ns;
+	bus_write_ns_ = write_ns;
+	bus_burst_ns_ = burst_ns ? burst_ns : read_ns / 4;
+}
+
+void AS3935Sim::injectLightning(uint32_t energy, uint8_t distance)
+{
+	if (poweredDown())
+		return;
+
+	registers_[AS3935SIM_REG_ENERGY_L] = static_cast<uint8_t>(energy);
+	registers_[AS3935SIM_REG_ENERGY_M] = static_cast<uint8_t>(energy >> 8);
+	registers_[AS3935SIM_REG_ENERGY_MM] = static_cast<uint8_t>((energy >> 16) & 0x1F);
+	registers_[AS3935SIM_REG_DISTANCE] = (registers_[AS3935SIM_REG_DISTANCE] & ~0x3F) | (distance & 0x3F);
+
+	raiseInterrupt(AS3935MI::AS3935_INT_L);
+}
+
+void AS3935Sim::injectDisturber()
+{
+	if (poweredDown() || (registers_[AS3935SIM_REG_INT] & AS3935SIM_MASK_MASK_DIST))
+		return;
+
+	raiseInterrupt(AS3935MI::AS3935_INT_D);
+}
+
+void AS3935Sim::injectNoise()
+{
+	if (poweredDown())
+		return;
+
+	raiseInterrupt(AS3935MI::AS3935_INT_NH);
+}
+
+void AS3935Sim::injectDistanceUpdate(uint8_t distance)
+{
+	if (poweredDown())
+		return;
+
+	registers_[AS3935SIM_REG_DISTANCE] = (registers_[AS3935SIM_REG_DISTANCE] & ~0x3F) | (distance & 0x3F);
+
+	raiseInterrupt(AS3935MI::AS3935_INT_DUPDATE);
+}
+
+void AS3935Sim::powerOnReset()
+{
+	presetDefault();
+
+	registers_[AS3935SIM_REG_TRCO_CALIB] = 0;
+	registers_[AS3935SIM_REG_SRCO_CALIB] = 0;
+	rco_calibration_pending_ = false;
+
+	updateDisplay();
+}
+
+uint8_t AS3935Sim::peekRegister(uint8_t reg) const
+{
+	return (reg < AS3935SIM_NR_REGISTERS) ? registers_[reg] : 0;
+}
+
+void AS3935Sim::pokeRegister(uint8_t reg, uint8_t value)
+{
+	if (reg >= AS3935SIM_NR_REGISTERS)
+		return;
+
+	registers_[reg] = value;
+
+	if (reg == AS3935SIM_REG_INT)
+	{
+		interrupt_pending_ = (value & AS3935SIM_MASK_INT) != 0;
+		if (display_ == AS3935SIM_DISPLAY_NONE)
+			setIrq(interrupt_pending_ ? HIGH : LOW);
+	}
+}
+
+bool AS3935Sim::beginInterface()
+{
+	return true;
+}
+
+uint8_t AS3935Sim::readRegister(uint8_t reg)
+{
+	register_reads_++;
+
+	if (bus_read_ns_)
+		hostAdvanceTime(bus_read_ns_);
+
+	return accessRegister(reg);
+}
+
+void AS3935Sim::readRegisters(uint8_t reg, uint8_t *values, uint8_t count)
+{
+	register_reads_ += count;
+	burst_reads_++;
+
+	if (bus_read_ns_ && count)
+		hostAdvanceTime(bus_read_ns_ + static_cast<uint64_t>(count - 1) * bus_burst_ns_);
+
+	for (uint8_t i = 0; i < count; i++)
+		values[i] = accessRegister(reg + i);
+}
+
+uint8_t AS3935Sim::accessRegister(uint8_t reg)
+{
+	if (reg >= AS3935SIM_NR_REGISTERS)
+		return 0xFF;
+
+	if (nak_while_displaying_ && (display_ != AS3935SIM_DISPLAY_NONE))
+		return 0xFF;
+
+	if (rco_calibration_pending_ && ((reg == AS3935SIM_REG_TRCO_CALIB) || (reg == AS3935SIM_REG_SRCO_CALIB)) &&
+		(hostNanos() - rco_calibration_start_ns_ >= AS3935SIM_RCO_CALIBRATION_NS))
+	{
+		rco_calibration_pending_ = false;
+
+		const uint8_t status = rco_calibration_failure_ ? AS3935SIM_CALIB_NOK : AS3935SIM_CALIB_DONE;
+		registers_[AS3935SIM_REG_TRCO_CALIB] = status;
+		registers_[AS3935SIM_REG_SRCO_CALIB] = status;
+	}
+
+	const uint8_t value = registers_[reg];
+
+	//reading the interrupt register clears the interrupt, including a distance update whose source is 0
+	if ((reg == AS3935SIM_REG_INT) && interrupt_pending_)
+	{
+		interrupt_pending_ = false;
+		registers_[AS3935SIM_REG_INT] &= ~AS3935SIM_MASK_INT;
+		if (display_ == AS3935SIM_DISPLAY_NONE)
+			setIrq(LOW);
+	}
+
+	return value;
+}
+
+void AS3935Sim::writeRegister(uint8_t reg, uint8_t value)
+{
+	register_writes_++;
+
+	if (bus_write_ns_)
+		hostAdvanceTime(bus_write_ns_);
+
+	if (reg >= AS3935SIM_NR_REGISTERS)
+		return;
+
+	switch (reg)
+	{
+	case AS3935SIM_REG_PRESET_DEFAULT:
+		if (value == AS3935SIM_DIRECT_CMD)
+		{
+			presetDefault();
+			updateDisplay();
+		}
+		return;
+	case AS3935SIM_REG_CALIB_RCO:
+		if ((value == AS3935SIM_DIRECT_CMD) && !poweredDown())
+		{
+			registers_[AS3935SIM_REG_TRCO_CALIB] = 0;
+			registers_[AS3935SIM_REG_SRCO_CALIB] = 0;
+			rco_calibration_pending_ = true;
+			rco_calibration_start_ns_ = hostNanos();
+		}
+		return;
+	case AS3935SIM_REG_INT:
+		//the interrupt bits are read only
+		registers_[reg] = (value & ~AS3935SIM_MASK_INT) | (registers_[reg] & AS3935SIM_MASK_INT);
+		updateDisplay();
+		return;
+	case AS3935SIM_REG_ENERGY_L:
+	case AS3935SIM_REG_ENERGY_M:
+	case AS3935SIM_REG_ENERGY_MM:
+	case AS3935SIM_REG_DISTANCE:
+	case AS3935SIM_REG_TRCO_CALIB:
+	case AS3935SIM_REG_SRCO_CALIB:
+		//read only
+		return;
+	default:
+		registers_[reg] = value;
+		break;
+	}
+
+	if ((reg == AS3935SIM_REG_DISP) || (reg == AS3935SIM_REG_AFE))
+		updateDisplay();
+}
+
+void AS3935Sim::presetDefault()
+{
+	for (uint8_t i = 0; i < AS3935SIM_NR_REGISTERS; i++)
+	{
+		if ((i != AS3935SIM_REG_TRCO_CALIB) && (i != AS3935SIM_REG_SRCO_CALIB))
+			registers_[i] = 0;
+	}
+
+	registers_[0x00] = 0x24;		//AFE_GB indoors, powered up
+	registers_[0x01] = 0x22;		//NF_LEV 2, WDTH 2
+	registers_[0x02] = 0xC2;		//CL_STAT 1, MIN_NUM_LIGH 1, SREJ 2
+	registers_[0x03] = 0x00;		//LCO_FDIV 16, disturbers not masked
+	registers_[AS3935SIM_REG_DISTANCE] = 0x3F;	//out of range
+
+	//the interrupt register has been cleared
+	interrupt_pending_ = false;
+	if (display_ == AS3935SIM_DISPLAY_NONE)
+		setIrq(LOW);
+}
+
+bool AS3935Sim::poweredDown() const
+{
+	return (registers_[AS3935SIM_REG_AFE] & AS3935SIM_MASK_PWD) != 0;
+}
+
+void AS3935Sim::raiseInterrupt(uint8_t source)
+{
+	if (interrupt_pending_)
+		lost_interrupts_++;
+
+	interrupt_pending_ = true;
+
+	registers_[AS3935SIM_REG_INT] = (registers_[AS3935SIM_REG_INT] & ~AS3935SIM_MASK_INT) | (source & AS3935SIM_MASK_INT);
+
+	//distance updates set no bits, but still pulse the IRQ pin
+	if (display_ == AS3935SIM_DISPLAY_NONE)
+	{
+		setIrq(LOW);
+		setIrq(HIGH);
+	}
+}
+
+void AS3935Sim::updateDisplay()
+{
+	const uint8_t disp = registers_[AS3935SIM_REG_DISP];
+
+	display_t display = AS3935SIM_DISPLAY_NONE;
+	double frequency = 0.0;
+
+	if (!poweredDown())
+	{
+		if (disp & AS3935SIM_MASK_DISP_LCO)
+		{
+			const uint8_t fdiv = (registers_[AS3935SIM_REG_INT] & AS3935SIM_MASK_LCO_FDIV) >> 6;
+			display = AS3935SIM_DISPLAY_LCO;
+			frequency = getResonanceFrequency(disp & AS3935SIM_MASK_TUN_CAP) / (16 << fdiv);
+		}
+		else if (disp & AS3935SIM_MASK_DISP_SRCO)
+		{
+			display = AS3935SIM_DISPLAY_SRCO;
+			frequency = srco_hz_;
+		}
+		else if (disp & AS3935SIM_MASK_DISP_TRCO)
+		{
+			display = AS3935SIM_DISPLAY_TRCO;
+			frequency = trco_hz_;
+		}
+	}
+
+	const double half_period_ns = (frequency > 0.0) ? 0.5e9 / frequency : 0.0;
+
+	if ((display == display_) && (half_period_ns == display_half_period_ns_))
+		return;
+
+	(*display_generation_)++;
+	display_ = display;
+	display_half_period_ns_ = half_period_ns;
+
+	if (display_ == AS3935SIM_DISPLAY_NONE)
+	{
+		//the IRQ pin shows the interrupt state again
+		setIrq(interrupt_pending_ ? HIGH : LOW);
+		return;
+	}
+
+	display_start_ns_ = hostNanos();
+	display_edges_ = 0;
+	setIrq(LOW);
+	scheduleEdge(*display_generation_);
+}
+
+void AS3935Sim::scheduleEdge(uint32_t generation)
+{
+	//compute edge times from the start time to avoid accumulating rounding errors
+	display_edges_++;
+	const uint64_t time = display_start_ns_ + static_cast<uint64_t>(display_edges_ * display_half_period_ns_);
+
+	std::shared_ptr<uint32_t> current = display_generation_;
+
+	hostSchedule(time, [this, generation, current]() {
+		if (generation != *current)
+			return;
+
+		setIrq((irq_level_ == HIGH) ? LOW : HIGH);
+		scheduleEdge(generation);
+	});
+}
+
+void AS3935Sim::setIrq(uint8_t level)
+{
+	irq_level_ = level;
+	hostWritePin(irq_pin_, level);
+}
@@ -0,0 +1,217 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935SIM_H_
+#define AS3935SIM_H_
+
+#include "AS3935MI.h"
+
+#include <memory>
+
+//register accurate simulation of an AS3935 for the host build. implements the register file including the 
+//direct commands PRESET_DEFAULT and CALIB_RCO and the calibration status bits, generates the LCO, SRCO and TRCO 
+//signals on the simulated IRQ pin when displayed, and raises interrupts for injected events. 
+//
+//the simulation runs in virtual time (see ArduinoHost.h), which is enabled by the constructor. 
+//the antenna is modelled as an LC tank: f = 1 / (2 * pi * sqrt(L * (C + tuning capacitance))), where the 
+//tuning capacitance is 8pF per step of the tuning capacitor setting. 
+class AS3935Sim :
+	public AS3935MI
+{
+public:
+	static const uint8_t AS3935SIM_NR_REGISTERS = 0x40;
+
+	AS3935Sim(uint8_t irq);
+	virtual ~AS3935Sim();
+
+	/*
+	sets the antenna model. 
+	@param inductance_uH antenna inductance in microhenry.
+	@param capacitance_pF antenna capacitance without tuning capacitors in picofarad. */
+	void setAntenna(double inductance_uH, double capacitance_pF);
+
+	/*
+	@param tuning tuning capacitor setting, 0 - 15.
+	@return simulated resonance frequency in Hz for the given tuning capacitor setting. */
+	double getResonanceFrequency(uint8_t tuning) const;
+
+	/*
+	sets the frequencies of the RC oscillators. 
+	@param srco_hz SRCO frequency in Hz, nominally 1.1 MHz.
+	@param trco_hz TRCO frequency in Hz, nominally 32.768 kHz. */
+	void setRCOFrequencies(double srco_hz, double trco_hz);
+
+	/*
+	@param fail true to make the next RCO calibrations fail, false to make them succeed. */
+	void setRCOCalibrationFailure(bool fail);
+
+	/*
+	@param nak true to make register reads fail (return 0xFF) while an oscillator is displayed on the IRQ pin,
+	as observed on some I2C boards. */
+	void setNakWhileDisplaying(bool nak);
+
+	/*
+	sets the time a register access takes on the simulated bus. every access advances the virtual time accordingly. 
+	@param read_ns duration of a register read in nanoseconds.
+	@param write_ns duration of a register write in nanoseconds. 
+	@param burst_ns duration of every further register of a burst read in nanoseconds, 0 for a quarter of read_ns 
+	(I2C: one of about four bytes transferred for a single register read). */
+	void setBusTiming(uint32_t read_ns, uint32_t write_ns, uint32_t burst_ns = 0);
+
+	/*
+	reports a lightning. the interrupt is not raised if the sensor is powered down. 
+	@param energy lightning energy, 20 bits.
+	@param distance storm distance in km. */
+	void injectLightning(uint32_t energy, uint8_t distance);
+
+	/*
+	reports a disturber. the interrupt is not raised if disturbers are masked or the sensor is powered down. */
+	void injectDisturber();
+
+	/*
+	reports a noise level too high event. */
+	void injectNoise();
+
+	/*
+	reports a change of the storm distance estimation. 
+	@param distance storm distance in km. */
+	void injectDistanceUpdate(uint8_t distance);
+
+	/*
+	resets the sensor as after a brownout: all registers are set to their default values and the RCOs are not 
+	calibrated. the driver is not notified. */
+	void powerOnReset();
+
+	/*
+	@param reg register address.
+	@return register content without side effects. */
+	uint8_t peekRegister(uint8_t reg) const;
+
+	/*
+	sets a register content without the side effects of a write, e.g. to copy the state of another simulated sensor. 
+	the IRQ pin follows the interrupt register. 
+	@param reg register address.
+	@param value register content. */
+	void pokeRegister(uint8_t reg, uint8_t value);
+
+	/*
+	@return number of interrupts whose interrupt source was overwritten by a later interrupt before it was read. */
+	uint32_t getLostInterrupts() const {
+		return lost_interrupts_;
+	}
+
+	/*
+	@return number of register reads. */
+	uint32_t getRegisterReads() const {
+		return register_reads_;
+	}
+
+	/*
+	@return number of burst reads. the registers read are counted by getRegisterReads(). */
+	uint32_t getBurstReads() const {
+		return burst_reads_;
+	}
+
+	/*
+	@return number of register writes, including direct commands. */
+	uint32_t getRegisterWrites() const {
+		return register_writes_;
+	}
+
+private:
+	enum display_t : uint8_t
+	{
+		AS3935SIM_DISPLAY_NONE,
+		AS3935SIM_DISPLAY_LCO,
+		AS3935SIM_DISPLAY_SRCO,
+		AS3935SIM_DISPLAY_TRCO
+	};
+
+	virtual bool beginInterface();
+
+	virtual uint8_t readRegister(uint8_t reg);
+
+	virtual void writeRegister(uint8_t reg, uint8_t value);
+
+	virtual void readRegisters(uint8_t reg, uint8_t *values, uint8_t count);
+
+	/*
+	reads a register with the side effects of a read (clearing the interrupt, completing the RCO calibration) 
+	but without counting it or advancing the time. */
+	uint8_t accessRegister(uint8_t reg);
+
+	/*
+	sets all registers to their default values. */
+	void presetDefault();
+
+	/*
+	@return true if the sensor is powered down. */
+	bool poweredDown() const;
+
+	/*
+	raises an interrupt. 
+	@param source interrupt source. */
+	void raiseInterrupt(uint8_t source);
+
+	/*
+	starts or stops displaying an oscillator according to register 0x08. */
+	void updateDisplay();
+
+	/*
+	schedules the next edge of the displayed oscillator. 
+	@param generation display generation the edge belongs to. */
+	void scheduleEdge(uint32_t generation);
+
+	/*
+	sets the level of the IRQ pin. */
+	void setIrq(uint8_t level);
+
+	uint8_t irq_pin_;
+
+	uint8_t registers_[AS3935SIM_NR_REGISTERS];
+
+	double inductance_uH_;
+	double capacitance_pF_;
+	double srco_hz_;
+	double trco_hz_;
+
+	bool rco_calibration_failure_;
+	bool rco_calibration_pending_;
+	uint64_t rco_calibration_start_ns_;
+
+	bool nak_while_displaying_;
+
+	uint32_t bus_read_ns_;
+	uint32_t bus_write_ns_;
+	uint32_t bus_burst_ns_;
+
+	display_t display_;
+	std::shared_ptr<uint32_t> display_generation_;	//incremented on every display change to cancel scheduled edges
+	uint64_t display_start_ns_;
+	double display_half_period_ns_;
+	uint64_t display_edges_;
+	uint8_t irq_level_;
+	bool interrupt_pending_;		//set by every interrupt until register 0x03 is read, distance updates have source 0
+
+	uint32_t lost_interrupts_;
+	uint32_t register_reads_;
+	uint32_t burst_reads_;
+	uint32_t register_writes_;
+};
+
+#endif /* AS3935SIM_H_ */
@@ -0,0 +1,197 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Workload.h"
+
+#include <math.h>
+
+#include "ArduinoHost.h"
+
+AS3935Workload::config_t AS3935Workload::defaultConfig()
+{
+	config_t config;
+
+	config.pattern = AS3935WORKLOAD_POISSON;
+	config.lightning_rate = 1.0;
+	config.disturber_rate = 0.5;
+	config.noise_rate = 0.1;
+	config.burst_factor = 8.0;
+	config.burst_fraction = 0.1;
+	config.burst_length = 0.5;
+	config.energy_min = 1000;
+	config.energy_max = 1000000;
+	config.distance_start = 40;
+	config.distance_end = 5;
+	config.duration = 60.0;
+	config.seed = 1;
+
+	return config;
+}
+
+AS3935Workload::AS3935Workload(AS3935Sim &sim, const config_t &config) :
+	sim_(sim),
+	config_(config),
+	state_(config.seed ? config.seed : 1),
+	start_ns_(0),
+	end_ns_(0),
+	burst_(false),
+	phase_end_ns_(0.0),
+	lightnings_(0),
+	disturbers_(0),
+	noises_(0),
+	alive_(std::make_shared<bool>(true))
+{
+}
+
+AS3935Workload::~AS3935Workload()
+{
+	*alive_ = false;
+}
+
+void AS3935Workload::setCallback(std::function<void(uint8_t, uint64_t)> callback)
+{
+	callback_ = callback;
+}
+
+void AS3935Workload::start()
+{
+	start_ns_ = hostNanos();
+	end_ns_ = start_ns_ + static_cast<uint64_t>(config_.duration * 1e9);
+
+	burst_ = false;
+	phase_end_ns_ = start_ns_;
+
+	scheduleNext(static_cast<double>(start_ns_));
+}
+
+uint32_t AS3935Workload::getInjected(uint8_t source) const
+{
+	switch (source)
+	{
+	case AS3935MI::AS3935_INT_L:
+		return lightnings_;
+	case AS3935MI::AS3935_INT_D:
+		return disturbers_;
+	case AS3935MI::AS3935_INT_NH:
+		return noises_;
+	default:
+		return 0;
+	}
+}
+
+uint32_t AS3935Workload::getInjected() const
+{
+	return lightnings_ + disturbers_ + noises_;
+}
+
+double AS3935Workload::random()
+{
+	//xorshift32
+	state_ ^= state_ << 13;
+	state_ ^= state_ >> 17;
+	state_ ^= state_ << 5;
+
+	return (state_ + 0.5) / 4294967296.0;
+}
+
+double AS3935Workload::interval(double rate)
+{
+	return -log(random()) / rate * 1e9;
+}
+
+void AS3935Workload::scheduleNext(double time_ns)
+{
+	const double rate = config_.lightning_rate + config_.disturber_rate + config_.noise_rate;
+	if (rate <= 0.0)
+		return;
+
+	//candidates are generated at the highest rate and thinned to the current rate
+	const double max_multiplier = (config_.pattern == AS3935WORKLOAD_BURSTY) ? config_.burst_factor : 1.0;
+
+	do
+	{
+		time_ns += interval(rate * max_multiplier);
+		if (time_ns >= end_ns_)
+			return;
+	} while (random() * max_multiplier > multiplier(time_ns));
+
+	const uint64_t time = static_cast<uint64_t>(time_ns);
+	std::shared_ptr<bool> alive = alive_;
+
+	hostSchedule(time, [this, alive, time, time_ns]() {
+		if (!*alive)
+			return;
+
+		inject(time);
+		scheduleNext(time_ns);
+	});
+}
+
+double AS3935Workload::multiplier(double time_ns)
+{
+	if (config_.pattern != AS3935WORKLOAD_BURSTY)
+		return 1.0;
+
+	//the rate during quiet phases keeps the mean rate
+	const double burst = config_.burst_factor;
+	const double quiet = (1.0 - config_.burst_fraction * burst) / (1.0 - config_.burst_fraction);
+	const double quiet_length = config_.burst_length * (1.0 - config_.burst_fraction) / config_.burst_fraction;
+
+	while (time_ns >= phase_end_ns_)
+	{
+		burst_ = !burst_;
+		phase_end_ns_ += interval(1.0 / (burst_ ? config_.burst_length : quiet_length));
+	}
+
+	return burst_ ? burst : ((quiet > 0.0) ? quiet : 0.0);
+}
+
+void AS3935Workload::inject(uint64_t time_ns)
+{
+	const double rate = config_.lightning_rate + config_.disturber_rate + config_.noise_rate;
+	const double choice = random() * rate;
+
+	uint8_t source = AS3935MI::AS3935_INT_NH;
+
+	if (choice < config_.lightning_rate)
+	{
+		const double progress = static_cast<double>(time_ns - start_ns_) / static_cast<double>(end_ns_ - start_ns_);
+		const double distance = config_.distance_start + (config_.distance_end - config_.distance_start) * progress;
+
+		const double ratio = static_cast<double>(config_.energy_max) / config_.energy_min;
+		const uint32_t energy = static_cast<uint32_t>(config_.energy_min * pow(ratio, random()));
+
+		source = AS3935MI::AS3935_INT_L;
+		lightnings_++;
+		sim_.injectLightning(energy, static_cast<uint8_t>(distance + 0.5));
+	}
+	else if (choice < config_.lightning_rate + config_.disturber_rate)
+	{
+		source = AS3935MI::AS3935_INT_D;
+		disturbers_++;
+		sim_.injectDisturber();
+	}
+	else
+	{
+		noises_++;
+		sim_.injectNoise();
+	}
+
+	if (callback_)
+		callback_(source, time_ns);
+}
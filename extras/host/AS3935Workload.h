@@ -0,0 +1,136 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935WORKLOAD_H_
+#define AS3935WORKLOAD_H_
+
+#include "AS3935Sim.h"
+
+#include <functional>
+#include <memory>
+
+//generates synthetic storms on a simulated sensor. lightnings, disturbers and noise level too high events are 
+//injected in virtual time (see ArduinoHost.h) as a Poisson process with the configured mean rates, or as a 
+//bursty process alternating between bursts with a multiple of the mean rate and quiet phases, keeping the 
+//configured mean rates. lightning energies are log-uniformly distributed, the storm distance moves linearly 
+//from the start to the end distance. runs are reproducible for a given seed. 
+class AS3935Workload
+{
+public:
+	enum pattern_t : uint8_t
+	{
+		AS3935WORKLOAD_POISSON,
+		AS3935WORKLOAD_BURSTY
+	};
+
+	struct config_t
+	{
+		pattern_t pattern;
+		double lightning_rate;		//mean lightnings per second
+		double disturber_rate;		//mean disturbers per second
+		double noise_rate;			//mean noise level too high events per second
+		double burst_factor;		//rate during bursts as multiple of the mean rate, bursty pattern only
+		double burst_fraction;		//fraction of time spent in bursts, burst_factor * burst_fraction must be < 1
+		double burst_length;		//mean burst length in seconds
+		uint32_t energy_min;		//minimum lightning energy
+		uint32_t energy_max;		//maximum lightning energy, 20 bits
+		uint8_t distance_start;		//storm distance at the start in km
+		uint8_t distance_end;		//storm distance at the end in km
+		double duration;			//duration in seconds
+		uint32_t seed;				//random seed, must not be 0
+	};
+
+	/*
+	@return a configuration with a Poisson storm of 1 lightning, 0.5 disturbers and 0.1 noise events 
+	per second over 60 seconds, approaching from 40km to 5km. */
+	static config_t defaultConfig();
+
+	/*
+	@param sim sensor to inject events into. must stay valid during the lifetime of this object.
+	@param config workload configuration. */
+	AS3935Workload(AS3935Sim &sim, const config_t &config);
+	~AS3935Workload();
+
+	/*
+	@param callback function called after each injected event with the interrupt source and the virtual 
+	time of the injection in nanoseconds. */
+	void setCallback(std::function<void(uint8_t, uint64_t)> callback);
+
+	/*
+	schedules the events, starting at the current virtual time. */
+	void start();
+
+	/*
+	@return virtual time in nanoseconds the last event can be injected at. */
+	uint64_t getEndTime() const {
+		return end_ns_;
+	}
+
+	/*
+	@param source interrupt source (AS3935_INT_L, AS3935_INT_D or AS3935_INT_NH).
+	@return number of events of the given interrupt source injected. */
+	uint32_t getInjected(uint8_t source) const;
+
+	/*
+	@return total number of events injected. */
+	uint32_t getInjected() const;
+
+private:
+	/*
+	@return uniformly distributed random number in (0, 1). */
+	double random();
+
+	/*
+	@param rate events per second.
+	@return exponentially distributed interval in nanoseconds. */
+	double interval(double rate);
+
+	/*
+	schedules the next event after the given time. */
+	void scheduleNext(double time_ns);
+
+	/*
+	@param time_ns virtual time.
+	@return current rate multiplier, 1.0 for the Poisson pattern. */
+	double multiplier(double time_ns);
+
+	/*
+	injects an event. */
+	void inject(uint64_t time_ns);
+
+	AS3935Sim &sim_;
+	config_t config_;
+
+	std::function<void(uint8_t, uint64_t)> callback_;
+
+	uint32_t state_;			//xorshift state
+
+	uint64_t start_ns_;
+	uint64_t end_ns_;
+
+	bool burst_;				//bursty pattern: currently in a burst
+	double phase_end_ns_;		//bursty pattern: end of the current burst or quiet phase
+
+	uint32_t lightnings_;
+	uint32_t disturbers_;
+	uint32_t noises_;
+
+	std::shared_ptr<bool> alive_;	//cleared by the destructor to cancel scheduled events
+};
+
+#endif /* AS3935WORKLOAD_H_ */
@@ -0,0 +1,297 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// array_test.cpp
+//
+// test of AS3935Array scheduling the bus transactions of three simulated sensors. runs in virtual time.
+
+#include <math.h>
+#include <stdio.h>
+
+#include "AS3935Array.h"
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+static void countTask(AS3935MI &sensor, void *context)
+{
+	sensor.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_3);
+	(*static_cast<int*>(context))++;
+}
+
+//events are read by deadline, tasks wait until no IRQ is pending
+static void testPriority()
+{
+	hostResetTime();
+
+	AS3935Sim sim_0(2), sim_1(3), sim_2(4);
+	AS3935Sim *sims[] = { &sim_0, &sim_1, &sim_2 };
+	const uint32_t deadlines[] = { 50, 10, 100 };
+
+	AS3935ArrayEntry entries[3];
+	AS3935Array array(entries, 3);
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		CHECK(sims[i]->begin());
+		sims[i]->writeMaskDisturbers(false);
+		CHECK(array.add(*sims[i], deadlines[i]) == i);
+	}
+	AS3935Sim sim_3(5);
+	CHECK(array.add(sim_3) == -1);
+	CHECK(array.count() == 3);
+
+	int runs = 0;
+	CHECK(array.scheduleTask(0, countTask, &runs, 1000));
+	CHECK(!array.scheduleTask(0, countTask, &runs, 1000));
+	CHECK(array.isTaskPending(0));
+
+	sim_0.injectLightning(1000, 10);
+	sim_1.injectDisturber();
+	sim_2.injectLightning(2000, 20);
+
+	//events are read 2ms after the IRQ, tasks must not run before
+	uint8_t index = 0xFF;
+	AS3935Event event;
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_IDLE);
+	CHECK(runs == 0);
+
+	delay(AS3935Array::AS3935_ARRAY_IRQ_DELAY);
+
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_EVENT);
+	CHECK(index == 1);
+	CHECK(event.source == AS3935MI::AS3935_INT_D);
+
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_EVENT);
+	CHECK(index == 0);
+	CHECK(event.source == AS3935MI::AS3935_INT_L);
+	CHECK(event.energy == 1000);
+	CHECK(event.distance == 10);
+
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_EVENT);
+	CHECK(index == 2);
+	CHECK(event.energy == 2000);
+	CHECK(event.distance == 20);
+
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_TASK);
+	CHECK(index == 0);
+	CHECK(runs == 1);
+	CHECK(!array.isTaskPending(0));
+	CHECK(sim_0.readNoiseFloorThreshold() == AS3935MI::AS3935_NFL_3);
+
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_IDLE);
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		const AS3935Array::statistics_t statistics = array.getStatistics(i);
+		CHECK(statistics.events == 1);
+		CHECK(statistics.tasks == ((i == 0) ? 1u : 0u));
+		CHECK(statistics.missed_deadlines == 0);
+	}
+}
+
+//late reads count as missed deadlines, the bus time is accounted to the sensor
+static void testDeadlines()
+{
+	hostResetTime();
+
+	AS3935Sim sim_0(2), sim_1(3);
+	sim_0.setBusTiming(390000, 290000);
+	sim_1.setBusTiming(390000, 290000);
+
+	AS3935ArrayEntry entries[2];
+	AS3935Array array(entries, 2);
+
+	CHECK(sim_0.begin());
+	CHECK(sim_1.begin());
+	array.add(sim_0, 5);
+	array.add(sim_1, 5);
+	array.resetStatistics();
+
+	sim_0.injectLightning(1000, 10);
+	sim_1.injectLightning(1000, 10);
+
+	uint8_t index = 0xFF;
+	AS3935Event event;
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_IDLE);
+
+	//both IRQs are seen at the same time. reading a lightning takes 5 register reads, 2ms on a 100kHz bus, 
+	//so the second read ends after its deadline
+	delay(AS3935Array::AS3935_ARRAY_IRQ_DELAY);
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_EVENT);
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_EVENT);
+	CHECK(array.getStatistics(0).missed_deadlines + array.getStatistics(1).missed_deadlines == 1);
+
+	sim_0.injectLightning(1000, 10);
+	array.update(index, event);
+	delay(10);
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_EVENT);
+	CHECK(index == 0);
+
+	const AS3935Array::statistics_t statistics = array.getStatistics(0);
+	CHECK(statistics.events == 2);
+	CHECK(statistics.busy_usec >= 10 * 390);
+	CHECK(statistics.elapsed_usec >= 14000);
+	CHECK(array.getBusUtilization(0) == (statistics.busy_usec * 1000ul) / statistics.elapsed_usec);
+
+	array.resetStatistics();
+	CHECK(array.getStatistics(0).events == 0);
+	CHECK(array.getStatistics(0).missed_deadlines == 0);
+}
+
+//drift checks run when due, but not while an IRQ is pending
+static void testDriftCheck()
+{
+	hostResetTime();
+
+	AS3935Sim sim_0(2), sim_1(3);
+	AS3935ArrayEntry entries[2];
+	AS3935Array array(entries, 2);
+
+	CHECK(sim_0.begin());
+	CHECK(sim_1.begin());
+	array.add(sim_0);
+	array.add(sim_1);
+
+	int32_t frequency = 0;
+	CHECK(!array.getDriftCheckResult(0, frequency));
+
+	array.setDriftCheckInterval(0, 1000);
+
+	uint8_t index = 0xFF;
+	AS3935Event event;
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_IDLE);
+
+	delay(1000);
+	sim_1.injectLightning(1000, 10);
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_IDLE);
+	delay(AS3935Array::AS3935_ARRAY_IRQ_DELAY);
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_EVENT);
+	CHECK(index == 1);
+
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_DRIFT_CHECK);
+	CHECK(index == 0);
+	array.getDriftCheckResult(0, frequency);
+	CHECK(fabs(frequency - sim_0.getResonanceFrequency(sim_0.readAntennaTuning())) < 1000.0);
+	CHECK(array.getStatistics(0).tasks == 1);
+	CHECK(array.getStatistics(0).missed_deadlines == 0);
+
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_IDLE);
+
+	//not run for more than one interval
+	delay(2500);
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_DRIFT_CHECK);
+	CHECK(array.getStatistics(0).missed_deadlines == 1);
+	CHECK(array.update(index, event) == AS3935Array::AS3935_ARRAY_IDLE);
+}
+
+//calibrating four sensors at once gives the results of calibrating them one after another, in about the time of one
+static void testCalibration()
+{
+	const double capacitances[] = { 900.0, 960.0, 1000.0, 1040.0 };
+	int32_t expected[4];
+	int8_t expected_cap[4];
+	uint32_t sequential_ms = 0;
+	uint32_t longest_ms = 0;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		hostResetTime();
+
+		AS3935Sim sim(2);
+		sim.setAntenna(100.0, capacitances[i]);
+		CHECK(sim.begin());
+
+		const uint32_t start = millis();
+		CHECK(sim.calibrateResonanceFrequency(expected[i]));
+		expected_cap[i] = sim.getCalibratedAntCap();
+
+		sequential_ms += millis() - start;
+		if (millis() - start > longest_ms)
+			longest_ms = millis() - start;
+	}
+
+	hostResetTime();
+
+	AS3935Sim sim_0(2), sim_1(3), sim_2(4), sim_3(5);
+	AS3935Sim *sims[] = { &sim_0, &sim_1, &sim_2, &sim_3 };
+
+	AS3935ArrayEntry entries[4];
+	AS3935Array array(entries, 4);
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		sims[i]->setAntenna(100.0, capacitances[i]);
+		CHECK(sims[i]->begin());
+		array.add(*sims[i]);
+	}
+
+	const uint32_t start = millis();
+	CHECK(array.calibrateResonanceFrequency());
+	const uint32_t parallel_ms = millis() - start;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		int32_t frequency = 0;
+		CHECK(array.getCalibrationResult(i, frequency));
+		CHECK(frequency == expected[i]);
+		CHECK(sims[i]->getCalibratedAntCap() == expected_cap[i]);
+		CHECK(sims[i]->readAntennaTuning() == expected_cap[i]);
+		CHECK(sims[i]->getAntCapFrequency(expected_cap[i]) == expected[i]);
+	}
+
+	printf("calibration of 4 sensors: %lu ms sequential, %lu ms parallel, %lu ms longest single\n", 
+		static_cast<unsigned long>(sequential_ms), static_cast<unsigned long>(parallel_ms), 
+		static_cast<unsigned long>(longest_ms));
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+	CHECK(parallel_ms <= longest_ms + longest_ms / 4);
+#else
+	//the sensors are calibrated one after another
+	CHECK(parallel_ms <= sequential_ms + sequential_ms / 4);
+#endif
+
+	//a powered down sensor fails, the others are calibrated
+	sim_1.writePowerDown(true);
+	CHECK(!array.calibrateResonanceFrequency());
+
+	int32_t frequency = 0;
+	CHECK(!array.getCalibrationResult(1, frequency));
+	CHECK(array.getCalibrationResult(0, frequency));
+	CHECK(frequency == expected[0]);
+}
+
+int main()
+{
+	testPriority();
+	testDeadlines();
+	testDriftCheck();
+	testCalibration();
+
+	printf("result: %s\n", (failures_ == 0) ? "pass" : "fail");
+
+	return (failures_ == 0) ? 0 : 1;
+}
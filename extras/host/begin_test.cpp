@@ -0,0 +1,167 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// begin_test.cpp
+//
+// test of beginWarm() on simulated sensors: a restarted MCU takes over a configured sensor without resetting it. 
+// runs in virtual time.
+
+#include <stdio.h>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//duration of a register access on a 100 kHz I2C bus
+static const uint32_t ACCESS_NS = 300000;
+
+//the sensor state survives the restart of the MCU, the driver state does not
+static void restart(const AS3935Sim &sensor, AS3935Sim &mcu)
+{
+	for (uint8_t reg = 0; reg < AS3935Sim::AS3935SIM_NR_REGISTERS; reg++)
+		mcu.pokeRegister(reg, sensor.peekRegister(reg));
+}
+
+static void configure(AS3935Sim &sim)
+{
+	sim.writeAFE(AS3935MI::AS3935_OUTDOORS);
+	sim.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_5);
+	sim.writeSpikeRejection(AS3935MI::AS3935_SREJ_6);
+	sim.writeMaskDisturbers(true);
+}
+
+//a configured sensor is taken over in three transfers, an event pending since before the restart is kept
+static void testWarm()
+{
+	hostResetTime();
+
+	uint64_t start = hostNanos();
+
+	AS3935Sim sensor(2);
+	sensor.setBusTiming(ACCESS_NS, ACCESS_NS);
+	CHECK(sensor.beginWarm() == AS3935MI::AS3935_BEGIN_COLD);
+	CHECK(sensor.calibrateResonanceFrequency());
+	CHECK(sensor.calibrateRCO());
+	configure(sensor);
+	sensor.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	const uint32_t cold_usec = static_cast<uint32_t>((hostNanos() - start) / 1000);
+	const uint8_t tuning = sensor.readAntennaTuning();
+
+	//the MCU restarts after the sensor reported a lightning
+	sensor.injectLightning(5000, 12);
+	delay(100);
+
+	AS3935Sim mcu(2);
+	mcu.setBusTiming(ACCESS_NS, ACCESS_NS);
+	restart(sensor, mcu);
+
+	start = hostNanos();
+	CHECK(mcu.beginWarm() == AS3935MI::AS3935_BEGIN_WARM);
+	const uint32_t warm_usec = static_cast<uint32_t>((hostNanos() - start) / 1000);
+
+	CHECK(mcu.getRegisterWrites() == 0);
+	CHECK(mcu.getRegisterReads() == 6);
+	CHECK(mcu.getBurstReads() == 2);
+	CHECK(warm_usec == ((ACCESS_NS + 2 * ACCESS_NS / 4) + ACCESS_NS + (ACCESS_NS + ACCESS_NS / 4)) / 1000);
+
+	CHECK(mcu.getInterruptMode() == AS3935MI::AS3935_INTERRUPT_NORMAL);
+	CHECK(mcu.getInterruptTimestamp() != 0);
+	CHECK(mcu.readAntennaTuning() == tuning);
+	CHECK(mcu.readAFE() == AS3935MI::AS3935_OUTDOORS);
+	CHECK(mcu.readSpikeRejection() == AS3935MI::AS3935_SREJ_6);
+
+	AS3935Event event;
+	CHECK(mcu.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.distance == 12);
+
+	//later events raise the interrupt
+	mcu.injectLightning(1000, 8);
+	CHECK(mcu.getInterruptTimestamp() != 0);
+
+	printf("warm begin: %u us, cold begin and calibration: %u us\n", warm_usec, cold_usec);
+}
+
+//a sensor that was reset, powered down or interrupted during a calibration is reset by beginWarm()
+static void testCold()
+{
+	hostResetTime();
+
+	AS3935Sim sensor(2);
+	CHECK(sensor.begin());
+	CHECK(sensor.calibrateRCO());
+	configure(sensor);
+
+	//not calibrated after a brownout
+	sensor.powerOnReset();
+	configure(sensor);
+	{
+		AS3935Sim mcu(2);
+		restart(sensor, mcu);
+		CHECK(mcu.beginWarm() == AS3935MI::AS3935_BEGIN_COLD);
+		CHECK(mcu.getInterruptMode() == AS3935MI::AS3935_INTERRUPT_DETACHED);
+		CHECK(mcu.readAFE() == AS3935MI::AS3935_INDOORS);
+	}
+
+	CHECK(sensor.calibrateRCO());
+
+	//powered down
+	sensor.writePowerDown(true);
+	{
+		AS3935Sim mcu(2);
+		restart(sensor, mcu);
+		CHECK(mcu.beginWarm() == AS3935MI::AS3935_BEGIN_COLD);
+		CHECK(!mcu.readPowerDown());
+	}
+
+	sensor.writePowerDown(false);
+	CHECK(sensor.calibrateRCO());
+
+	//restarted while the LCO was displayed on the IRQ pin
+	{
+		AS3935Sim mcu(2);
+		restart(sensor, mcu);
+		mcu.pokeRegister(0x08, sensor.peekRegister(0x08) | 0x80);
+		CHECK(mcu.beginWarm() == AS3935MI::AS3935_BEGIN_COLD);
+		CHECK((mcu.peekRegister(0x08) & 0xE0) == 0);
+	}
+
+	{
+		AS3935Sim mcu(2);
+		restart(sensor, mcu);
+		CHECK(mcu.beginWarm() == AS3935MI::AS3935_BEGIN_WARM);
+	}
+}
+
+int main()
+{
+	testWarm();
+	testCold();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+	return (failures_ == 0) ? 0 : 1;
+}
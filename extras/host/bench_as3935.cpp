@@ -0,0 +1,268 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// bench_as3935.cpp
+//
+// benchmark of the driver's hot paths against the simulated sensor. every register access is charged the 
+// duration of a transaction on the selected bus in virtual time, the driver's bus statistics 
+// (AS3935MI_ENABLE_BUS_STATISTICS) report transactions, bus time and delay time per iteration. the host CPU time 
+// includes the simulation. 
+//
+// prints one JSON object per benchmark and bus. with --baseline, fails if a benchmark needs more transactions 
+// than recorded in a previous output, e.g. extras/host/bench_as3935_baseline.jsonl:
+//
+//   bench_as3935 [--baseline FILE]
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+#ifndef AS3935MI_ENABLE_BUS_STATISTICS
+#error "bench_as3935 must be built with AS3935MI_ENABLE_BUS_STATISTICS"
+#endif
+
+#define PIN_IRQ 2
+
+namespace
+{
+	struct bus_t
+	{
+		const char *name;
+		uint32_t clock_hz;
+		uint8_t read_bits;		//clock periods of a register read including start / stop conditions or chip select
+		uint8_t write_bits;		//clock periods of a register write including start / stop conditions or chip select
+	};
+
+	//I2C read: S, address + W, register, Sr, address + R, data, P. I2C write: S, address + W, register, data, P.
+	//SPI: 16 clocks plus about 2 clock periods of chip select setup and hold time.
+	const bus_t buses[] = {
+		{ "i2c_100k", 100000, 39, 29 },
+		{ "i2c_400k", 400000, 39, 29 },
+		{ "spi_1m", 1000000, 18, 18 },
+		{ "spi_2m", 2000000, 18, 18 },
+	};
+
+	struct result_t
+	{
+		char benchmark[32];
+		char bus[32];
+		double reads;
+		double writes;
+	};
+
+	const size_t MAX_RESULTS = 32;
+
+	result_t results_[MAX_RESULTS];
+	size_t nr_results_ = 0;
+
+	bool failed_ = false;
+
+	double cpuMicros()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+		return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+	}
+
+	//the sensor configuration written by the examples' setup()
+	void configure(AS3935Sim &sim)
+	{
+		sim.writeAFE(AS3935MI::AS3935_INDOORS);
+		sim.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_2);
+		sim.writeWatchdogThreshold(AS3935MI::AS3935_WDTH_2);
+		sim.writeSpikeRejection(AS3935MI::AS3935_SREJ_2);
+		sim.writeMinLightnings(AS3935MI::AS3935_MNL_1);
+		sim.writeMaskDisturbers(false);
+	}
+
+	bool benchSetup(AS3935Sim &sim)
+	{
+		bool ok = sim.begin() && sim.checkConnection() && sim.checkIRQ();
+		configure(sim);
+		return ok;
+	}
+
+	bool benchEvent(AS3935Sim &sim)
+	{
+		sim.injectLightning(123456, 14);
+
+		const uint8_t source = sim.readInterruptSource();
+		const uint32_t energy = sim.readEnergy();
+		const uint8_t distance = sim.readStormDistance();
+
+		return (source == AS3935MI::AS3935_INT_L) && (energy == 123456) && (distance == 14);
+	}
+
+	bool benchCalibration(AS3935Sim &sim)
+	{
+		int32_t frequency = 0;
+		return sim.calibrateResonanceFrequency(frequency, AS3935MI::AS3935_DR_16) && sim.calibrateRCO();
+	}
+
+	//one full cycle of the examples' sensitivity adjustment: disturbers raise watchdog threshold and spike 
+	//rejection to their maximum, then the periodic adjustment lowers them back to their minimum.
+	bool benchSensitivity(AS3935Sim &sim)
+	{
+		while (true)
+		{
+			sim.injectDisturber();
+			if (sim.readInterruptSource() != AS3935MI::AS3935_INT_D)
+				return false;
+
+			uint8_t wdth = sim.readWatchdogThreshold();
+			uint8_t srej = sim.readSpikeRejection();
+
+			if ((wdth >= AS3935MI::AS3935_WDTH_10) && (srej >= AS3935MI::AS3935_SREJ_10))
+				break;
+
+			if (srej < wdth)
+				sim.increaseSpikeRejection(srej);
+			else
+				sim.increaseWatchdogThreshold(wdth);
+		}
+
+		while (true)
+		{
+			uint8_t wdth = sim.readWatchdogThreshold();
+			uint8_t srej = sim.readSpikeRejection();
+
+			if ((wdth == AS3935MI::AS3935_WDTH_0) && (srej == AS3935MI::AS3935_SREJ_0))
+				break;
+
+			if (srej > wdth)
+				sim.decreaseSpikeRejection();
+			else
+				sim.decreaseWatchdogThreshold();
+		}
+
+		return true;
+	}
+
+	void run(const char *name, bool (*benchmark)(AS3935Sim&), const bus_t &bus, uint32_t iterations)
+	{
+		hostResetTime();
+
+		AS3935Sim sim(PIN_IRQ);
+
+		//one clock period in nanoseconds
+		const uint32_t period_ns = 1000000000ul / bus.clock_hz;
+		sim.setBusTiming(bus.read_bits * period_ns, bus.write_bits * period_ns);
+
+		//benchmarks other than setup start with a configured sensor
+		if (benchmark != benchSetup)
+			benchSetup(sim);
+
+		sim.resetBusStatistics();
+		const double cpu_start = cpuMicros();
+
+		bool ok = true;
+		for (uint32_t i = 0; i < iterations; i++)
+			ok &= benchmark(sim);
+
+		const double cpu_usec = cpuMicros() - cpu_start;
+		const AS3935MI::bus_statistics_t statistics = sim.getBusStatistics();
+
+		const double n = iterations;
+		printf("{\"benchmark\":\"%s\",\"bus\":\"%s\",\"iterations\":%lu,\"reads\":%.1f,\"writes\":%.1f,\"bytes\":%.1f,"
+			"\"bus_us\":%.1f,\"delay_us\":%.1f,\"duration_us\":%.1f,\"cpu_us\":%.2f,\"ok\":%s}\n",
+			name, bus.name, static_cast<unsigned long>(iterations), statistics.reads / n, statistics.writes / n,
+			statistics.bytes / n, statistics.bus_usec / n, statistics.delay_usec / n, statistics.duration_usec / n,
+			cpu_usec / n, ok ? "true" : "false");
+
+		if (!ok)
+			failed_ = true;
+
+		if (nr_results_ < MAX_RESULTS)
+		{
+			result_t &result = results_[nr_results_++];
+			snprintf(result.benchmark, sizeof(result.benchmark), "%s", name);
+			snprintf(result.bus, sizeof(result.bus), "%s", bus.name);
+			result.reads = statistics.reads / n;
+			result.writes = statistics.writes / n;
+		}
+	}
+
+	//compares the number of transactions against a previous output. 
+	bool compareBaseline(const char *path)
+	{
+		FILE *file = fopen(path, "r");
+		if (!file)
+		{
+			fprintf(stderr, "cannot open baseline %s\n", path);
+			return false;
+		}
+
+		bool ok = true;
+		char line[512];
+		while (fgets(line, sizeof(line), file))
+		{
+			result_t baseline;
+			if (sscanf(line, "{\"benchmark\":\"%31[^\"]\",\"bus\":\"%31[^\"]\",\"iterations\":%*u,\"reads\":%lf,\"writes\":%lf",
+				baseline.benchmark, baseline.bus, &baseline.reads, &baseline.writes) != 4)
+				continue;
+
+			for (size_t i = 0; i < nr_results_; i++)
+			{
+				const result_t &result = results_[i];
+				if (strcmp(result.benchmark, baseline.benchmark) || strcmp(result.bus, baseline.bus))
+					continue;
+
+				const double transactions = result.reads + result.writes;
+				const double baseline_transactions = baseline.reads + baseline.writes;
+
+				if (transactions > baseline_transactions + 0.05)
+				{
+					fprintf(stderr, "regression: %s on %s needs %.1f transactions, baseline %.1f\n",
+						result.benchmark, result.bus, transactions, baseline_transactions);
+					ok = false;
+				}
+			}
+		}
+
+		fclose(file);
+		return ok;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *baseline = nullptr;
+	if ((argc == 3) && !strcmp(argv[1], "--baseline"))
+		baseline = argv[2];
+	else if (argc != 1)
+	{
+		fprintf(stderr, "usage: %s [--baseline FILE]\n", argv[0]);
+		return 2;
+	}
+
+	for (const bus_t &bus : buses)
+	{
+		run("setup", benchSetup, bus, 10);
+		run("event", benchEvent, bus, 1000);
+		run("calibration", benchCalibration, bus, 3);
+		run("sensitivity", benchSensitivity, bus, 20);
+	}
+
+	if (baseline && !compareBaseline(baseline))
+		failed_ = true;
+
+	return failed_ ? 1 : 0;
+}
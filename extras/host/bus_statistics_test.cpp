@@ -0,0 +1,100 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// bus_statistics_test.cpp
+//
+// checks the bus statistics (AS3935MI_ENABLE_BUS_STATISTICS) against the accesses seen by the simulated sensor.
+
+#include <stdio.h>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+#ifndef AS3935MI_ENABLE_BUS_STATISTICS
+#error "bus_statistics_test must be built with AS3935MI_ENABLE_BUS_STATISTICS"
+#endif
+
+#define PIN_IRQ 2
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+static void print(const char *name, const AS3935MI::bus_statistics_t &s)
+{
+	printf("%-28s reads %4lu writes %4lu bytes %5lu bus %8lu us delay %8lu us duration %8lu us\n", name, 
+		static_cast<unsigned long>(s.reads), static_cast<unsigned long>(s.writes), static_cast<unsigned long>(s.bytes), 
+		static_cast<unsigned long>(s.bus_usec), static_cast<unsigned long>(s.delay_usec), static_cast<unsigned long>(s.duration_usec));
+}
+
+int main()
+{
+	AS3935Sim sim(PIN_IRQ);
+	sim.resetBusStatistics();
+
+	CHECK(sim.begin());
+	AS3935MI::bus_statistics_t op = sim.getOperationStatistics();
+	print("begin()", op);
+	CHECK(op.reads == sim.getRegisterReads());
+	CHECK(op.writes == sim.getRegisterWrites());
+	CHECK(op.bytes == 2 * (op.reads + op.writes));
+	CHECK(op.delay_usec > 0);
+	CHECK(op.duration_usec >= op.delay_usec);
+
+	//single read-modify-write
+	uint32_t reads = sim.getRegisterReads();
+	uint32_t writes = sim.getRegisterWrites();
+	sim.increaseSpikeRejection();
+	op = sim.getOperationStatistics();
+	print("increaseSpikeRejection()", op);
+	CHECK(op.reads == sim.getRegisterReads() - reads);
+	CHECK(op.writes == sim.getRegisterWrites() - writes);
+	CHECK(op.writes == 1);
+
+	//nested public calls are accounted to the outermost call
+	reads = sim.getRegisterReads();
+	writes = sim.getRegisterWrites();
+	int32_t frequency = 0;
+	const bool calibrated = sim.calibrateResonanceFrequency(frequency);
+	op = sim.getOperationStatistics();
+	print("calibrateResonanceFrequency()", op);
+	CHECK(calibrated);
+	CHECK(op.reads == sim.getRegisterReads() - reads);
+	CHECK(op.writes == sim.getRegisterWrites() - writes);
+	CHECK(op.delay_usec > 0);
+
+	AS3935MI::bus_statistics_t total = sim.getBusStatistics();
+	print("total", total);
+	CHECK(total.reads == sim.getRegisterReads());
+	CHECK(total.writes == sim.getRegisterWrites());
+	CHECK(total.duration_usec >= total.delay_usec);
+
+	sim.resetBusStatistics();
+	total = sim.getBusStatistics();
+	CHECK(total.reads == 0 && total.writes == 0 && total.bytes == 0);
+
+	printf("result: %s\n", (failures_ == 0) ? "pass" : "fail");
+
+	return (failures_ == 0) ? 0 : 1;
+}
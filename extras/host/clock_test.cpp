@@ -0,0 +1,161 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// clock_test.cpp
+//
+// runs hour long scenarios in virtual time using an AS3935VirtualClock (AS3935MI_ENABLE_CLOCK) and checks 
+// that timestamps stay valid across 32 bit overflows.
+
+#include <stdio.h>
+
+#include <chrono>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+#ifndef AS3935MI_ENABLE_CLOCK
+#error "clock_test must be built with AS3935MI_ENABLE_CLOCK"
+#endif
+
+#define PIN_IRQ 2
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+static const uint64_t SECOND = 1000000ull;
+static const uint64_t MINUTE = 60 * SECOND;
+
+//delays of the driver advance the clock set with setClock(), not the time of the Arduino core
+static void testDelays()
+{
+	hostResetTime();
+
+	AS3935Sim sim(PIN_IRQ);
+	AS3935VirtualClock clock;
+	sim.setClock(&clock);
+
+	const uint64_t core_ns = hostNanos();
+
+	CHECK(sim.begin());
+	CHECK(clock.micros64() >= 2000);
+	CHECK(hostNanos() == core_ns);
+}
+
+//two 15 minute AFE probing windows. the register writes between the windows take a few milliseconds. 
+//@return time the probe finished at, relative to the start
+static uint64_t probe(AS3935Sim &sim, AS3935VirtualClock &clock)
+{
+	const uint64_t start = clock.micros64();
+
+	sim.beginAFEProbe(15ul * 60 * 1000);
+
+	//a noise level too high event every 10 seconds, updated once per second
+	for (uint32_t second = 1; second <= 40 * 60; second++)
+	{
+		clock.advance(SECOND);
+
+		uint8_t source = 0;
+		if (second % 10 == 0)
+		{
+			sim.injectNoise();
+			source = sim.readInterruptSource();
+		}
+
+		if (sim.updateAFEProbe(source))
+			return clock.micros64() - start;
+	}
+
+	return 0;
+}
+
+static void testVirtualClockOverflow()
+{
+	hostResetTime();
+
+	AS3935Sim sim(PIN_IRQ);
+	CHECK(sim.begin());
+
+	//micros() overflows after 2^32 microseconds, millis() after 2^32 milliseconds
+	AS3935VirtualClock clock((1ull << 32) - 5 * MINUTE);
+	sim.setClock(&clock);
+
+	const uint64_t finished = probe(sim, clock);
+	CHECK((finished >= 30 * MINUTE) && (finished < 30 * MINUTE + SECOND));
+	CHECK(!sim.isAFEProbeRunning());
+
+	const AS3935MI::afe_probe_stats_t indoors = sim.getAFEProbeStats(AS3935MI::AS3935_INDOORS);
+	const AS3935MI::afe_probe_stats_t outdoors = sim.getAFEProbeStats(AS3935MI::AS3935_OUTDOORS);
+	CHECK(indoors.noise_high == 90);
+	CHECK(outdoors.noise_high == 90);
+
+	//event timestamps are the lower 32 bits of the time in milliseconds
+	clock.set((1ull << 32) * 1000 + 1234567);
+	sim.injectLightning(1000, 10);
+
+	AS3935Event event;
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.timestamp == 1234);
+}
+
+//without a clock, micros() of the Arduino core is extended to 64 bits
+static void testCoreOverflow()
+{
+	hostResetTime();
+
+	AS3935Sim sim(PIN_IRQ);
+	CHECK(sim.begin());
+
+	hostAdvanceTime(((1ull << 32) - 5 * MINUTE) * 1000);
+
+	const uint64_t start = hostNanos() / 1000;
+
+	sim.beginAFEProbe(15ul * 60 * 1000);
+
+	uint64_t finished = 0;
+	for (uint32_t second = 1; (second <= 40 * 60) && !finished; second++)
+	{
+		hostAdvanceTime(SECOND * 1000);
+
+		if (sim.updateAFEProbe(0))
+			finished = hostNanos() / 1000 - start;
+	}
+
+	CHECK((finished >= 30 * MINUTE) && (finished < 30 * MINUTE + SECOND));
+}
+
+int main()
+{
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	testDelays();
+	testVirtualClockOverflow();
+	testCoreOverflow();
+
+	const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("ran an hour of virtual time in %.3f s\n", elapsed);
+	printf("result: %s\n", (failures_ == 0) ? "pass" : "fail");
+
+	return (failures_ == 0) ? 0 : 1;
+}
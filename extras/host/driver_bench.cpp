@@ -0,0 +1,206 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// driver_bench.cpp
+//
+// compares AS3935MI, which accesses the bus through virtual functions, with AS3935Driver<Bus>, which binds the 
+// bus at compile time. both drivers access the same register file in memory, so the host CPU time per operation 
+// is the cost of the driver code and bus dispatch alone. the AS3935MI code is the instance compiled into the 
+// library, as in an application; AS3935Driver<Bus> is instantiated here, where the bus functions can be inlined.
+//
+// prints one JSON object per operation and driver, and fails if the drivers return different results or leave 
+// the registers in a different state:
+//
+//   driver_bench [ITERATIONS]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "AS3935MI.h"
+#include "AS3935SPIClass.h"
+#include "AS3935TwoWire.h"
+#include "ArduinoHost.h"
+
+#define PIN_IRQ 2
+
+//the buses of the library must compile with the driver
+template class AS3935Driver<AS3935TwoWireBus>;
+template class AS3935Driver<AS3935SPIClassBus>;
+
+namespace
+{
+	const uint8_t REGISTERS = 0x40;
+
+	//sensor registers after a lightning interrupt
+	void initRegisters(uint8_t *registers)
+	{
+		memset(registers, 0, REGISTERS);
+		registers[0x00] = 0b00100100;		//AS3935_INDOORS
+		registers[0x01] = 0b00100010;
+		registers[0x02] = 0b11000010;
+		registers[0x03] = 0b00001000;		//AS3935_INT_L
+		registers[0x04] = 0x40;
+		registers[0x05] = 0xE2;
+		registers[0x06] = 0x01;
+		registers[0x07] = 14;
+	}
+
+	//register file as a bus bound at compile time
+	class MemoryBus
+	{
+	public:
+		MemoryBus(uint8_t *registers) :
+			registers_(registers)
+		{
+		}
+
+	private:
+		template <class Bus> friend class ::AS3935Driver;
+
+		bool beginInterface() {
+			return true;
+		}
+
+		uint8_t readRegister(uint8_t reg) {
+			return registers_[reg & (REGISTERS - 1)];
+		}
+
+		void writeRegister(uint8_t reg, uint8_t value) {
+			registers_[reg & (REGISTERS - 1)] = value;
+		}
+
+		uint8_t *registers_;
+	};
+
+	//the same register file behind the virtual functions of AS3935MI
+	class MemorySensor :
+		public AS3935MI
+	{
+	public:
+		MemorySensor(uint8_t *registers) :
+			AS3935MI(PIN_IRQ),
+			registers_(registers)
+		{
+		}
+
+	private:
+		bool beginInterface() {
+			return true;
+		}
+
+		uint8_t readRegister(uint8_t reg) {
+			return registers_[reg & (REGISTERS - 1)];
+		}
+
+		void writeRegister(uint8_t reg, uint8_t value) {
+			registers_[reg & (REGISTERS - 1)] = value;
+		}
+
+		uint8_t *registers_;
+	};
+
+	typedef AS3935Driver<MemoryBus> StaticSensor;
+
+	bool failed_ = false;
+
+	double cpuNanos()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+		return ts.tv_sec * 1e9 + ts.tv_nsec;
+	}
+
+	//reads a lightning event, the hot path of an application
+	template <class Sensor>
+	uint32_t opEvent(Sensor &sensor, uint32_t)
+	{
+		AS3935Event event;
+		sensor.readEvent(event);
+		return event.source + event.energy + event.distance;
+	}
+
+	//read-modify-write accesses of settings without delays
+	template <class Sensor>
+	uint32_t opSettings(Sensor &sensor, uint32_t i)
+	{
+		sensor.writeMaskDisturbers(i & 1);
+		sensor.writeMinLightnings(i & 3);
+		sensor.writeAFE((i & 1) ? AS3935MI::AS3935_OUTDOORS : AS3935MI::AS3935_INDOORS);
+		return sensor.readMaskDisturbers() + sensor.readMinLightnings() + sensor.readAFE();
+	}
+
+	template <class Sensor>
+	uint32_t run(const char *operation, const char *driver, uint32_t (*op)(Sensor&, uint32_t), Sensor &sensor, 
+		uint32_t iterations)
+	{
+		uint32_t checksum = 0;
+
+		const double start = cpuNanos();
+		for (uint32_t i = 0; i < iterations; i++)
+			checksum += op(sensor, i);
+		const double ns = (cpuNanos() - start) / iterations;
+
+		printf("{\"operation\":\"%s\",\"driver\":\"%s\",\"iterations\":%lu,\"ns_per_op\":%.1f,\"sizeof\":%lu}\n",
+			operation, driver, static_cast<unsigned long>(iterations), ns, static_cast<unsigned long>(sizeof(Sensor)));
+
+		return checksum;
+	}
+
+	template <class Operation, class StaticOperation>
+	void compare(const char *operation, Operation op, StaticOperation static_op, uint32_t iterations)
+	{
+		uint8_t registers[REGISTERS];
+		uint8_t static_registers[REGISTERS];
+		initRegisters(registers);
+		initRegisters(static_registers);
+
+		MemorySensor sensor(registers);
+		StaticSensor static_sensor(PIN_IRQ, MemoryBus(static_registers));
+
+		const uint32_t checksum = run(operation, "AS3935MI", op, static_cast<AS3935MI&>(sensor), iterations);
+		const uint32_t static_checksum = run(operation, "AS3935Driver", static_op, static_sensor, iterations);
+
+		if ((checksum != static_checksum) || memcmp(registers, static_registers, REGISTERS))
+		{
+			fprintf(stderr, "%s: drivers differ\n", operation);
+			failed_ = true;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t iterations = 1000000;
+	if (argc == 2)
+		iterations = strtoul(argv[1], nullptr, 0);
+	else if (argc != 1)
+	{
+		fprintf(stderr, "usage: %s [ITERATIONS]\n", argv[0]);
+		return 2;
+	}
+
+	//the drivers' delays advance the virtual time only
+	hostSetVirtualTime(true);
+
+	compare("event", opEvent<AS3935MI>, opEvent<StaticSensor>, iterations);
+	compare("settings", opSettings<AS3935MI>, opSettings<StaticSensor>, iterations);
+
+	return failed_ ? 1 : 0;
+}
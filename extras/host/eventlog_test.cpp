@@ -0,0 +1,107 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// eventlog_test.cpp
+//
+// test of AS3935EventLog: round trip of events and records of the maximum size in a buffer that holds only one.
+
+#include <stdio.h>
+
+#include "AS3935EventLog.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//events are read back in order, the oldest are dropped when the buffer is full
+static void testRoundTrip()
+{
+	uint8_t buffer[32];
+	AS3935EventLog log(buffer, sizeof(buffer));
+
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		AS3935Event event;
+		event.timestamp = 1000 + i * 300;
+		event.source = 0b1000;
+		event.energy = 0x12345 + i;
+		event.distance = static_cast<uint8_t>(i + 1);
+		CHECK(log.append(event));
+	}
+
+	CHECK(log.count() < 10);
+	CHECK(log.dropped() == 10 - log.count());
+	CHECK(log.bytesUsed() <= log.capacity());
+
+	AS3935EventLog::Iterator it = log.iterator();
+	AS3935Event event;
+	uint32_t i = 10 - log.count();
+	while (it.next(event))
+	{
+		CHECK(event.timestamp == 1000 + i * 300);
+		CHECK(event.energy == 0x12345 + i);
+		CHECK(event.distance == i + 1);
+		i++;
+	}
+	CHECK(i == 10);
+}
+
+//energies wider than the 20 bits reported by the sensor are truncated, so a record never exceeds the maximum size
+static void testMaxRecord()
+{
+	uint8_t buffer[AS3935EventLog::AS3935_EVENTLOG_MAX_RECORD_SIZE];
+	AS3935EventLog log(buffer, sizeof(buffer));
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		AS3935Event event;
+		event.timestamp = 0xFFFFFFFFul * (i & 1);
+		event.source = 0b1000;
+		event.energy = 0xFFFFFFFFul;
+		event.distance = 63;
+		CHECK(log.append(event));
+
+		CHECK(log.count() == 1);
+		CHECK(log.bytesUsed() <= log.capacity());
+	}
+
+	CHECK(log.dropped() == 2);
+
+	AS3935EventLog::Iterator it = log.iterator();
+	AS3935Event event;
+	CHECK(it.next(event));
+	CHECK(event.timestamp == 0);
+	CHECK(event.energy == AS3935EventLog::AS3935_EVENTLOG_MASK_ENERGY);
+	CHECK(event.distance == 63);
+	CHECK(!it.next(event));
+}
+
+int main()
+{
+	testRoundTrip();
+	testMaxRecord();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+	return (failures_ == 0) ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// footprint.cpp
+//
+// sketch sized program built once per compile time configuration of the library (AS3935MI_DISABLE_..., see 
+// AS3935Driver.h). runs setup and event handling of the examples against the simulated sensor, checks the results 
+// available in the configuration and prints the RAM used by a sensor object as JSON. run size(1) on the build for 
+// the code size.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+#ifndef AS3935MI_FOOTPRINT_CONFIG
+#define AS3935MI_FOOTPRINT_CONFIG "default"
+#endif
+
+#define PIN_IRQ 2
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+int main()
+{
+	AS3935Sim sim(PIN_IRQ);
+
+	CHECK(sim.begin());
+	CHECK(sim.checkConnection());
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	CHECK(sim.checkIRQ());
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	int32_t frequency = 0;
+	CHECK(sim.calibrateResonanceFrequency(frequency));
+
+	const int8_t ant_cap = sim.getCalibratedAntCap();
+	CHECK(ant_cap >= 0);
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_TABLE
+#ifdef AS3935MI_COMPACT_FREQUENCY_TABLE
+	//rounded to 8 Hz
+	CHECK(labs(sim.getAntCapFrequency(ant_cap) - frequency) <= 4);
+#else
+	CHECK(sim.getAntCapFrequency(ant_cap) == frequency);
+#endif
+#else
+	CHECK(sim.getAntCapFrequency(ant_cap) == -1);
+#endif
+#else
+	CHECK(sim.getCalibratedAntCap() == -1);
+#endif
+
+	CHECK(sim.calibrateRCO());
+
+	sim.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_2);
+	sim.writeWatchdogThreshold(AS3935MI::AS3935_WDTH_2);
+	sim.writeSpikeRejection(AS3935MI::AS3935_SREJ_2);
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	sim.injectLightning(0x12345, 14);
+
+	AS3935Event event;
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.energy == 0x12345);
+	CHECK(event.distance == 14);
+
+	printf("{\"config\":\"%s\",\"sizeof\":%lu,\"ok\":%s}\n", AS3935MI_FOOTPRINT_CONFIG, 
+		static_cast<unsigned long>(sizeof(AS3935MI)), failures_ ? "false" : "true");
+
+	return failures_ ? 1 : 0;
+}
@@ -0,0 +1,198 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// frequency_bench.cpp
+//
+// checks the 32 bit fixed point computation of measured frequencies (AS3935DriverBase::scaleByRatio()) against the 
+// 64 bit formula it replaced, for the scale of every frequency divider and edge mode: exhaustively for small sample 
+// counts and durations, at the limits of the input range and for pseudo random inputs covering all magnitudes. then 
+// compares the CPU time and cycles per computation for measurements of a typical duration. 
+//
+// prints one JSON object per formulation and fails if any result differs:
+//
+//   frequency_bench [RANDOM_INPUTS]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "AS3935MI.h"
+
+namespace
+{
+	//exposes the computation
+	class FrequencyMath : public AS3935DriverBase
+	{
+	public:
+		using AS3935DriverBase::scaleByRatio;
+	};
+
+	//the formula of AS3935MI 1.3.5
+	uint32_t reference(uint32_t value, uint32_t scale, uint32_t divisor)
+	{
+		return static_cast<uint32_t>(static_cast<uint64_t>(value) * scale / divisor);
+	}
+
+	double cpuNanos()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+		return ts.tv_sec * 1e9 + ts.tv_nsec;
+	}
+
+	uint64_t cycles()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	uint32_t random_ = 0x2545F491;
+
+	uint32_t xorshift()
+	{
+		random_ ^= random_ << 13;
+		random_ ^= random_ >> 17;
+		random_ ^= random_ << 5;
+		return random_;
+	}
+
+	//random value with a random number of significant bits
+	uint32_t randomMagnitude(uint8_t max_bits)
+	{
+		const uint8_t bits = 1 + xorshift() % max_bits;
+		return xorshift() & (0xFFFFFFFFul >> (32 - bits));
+	}
+
+	uint32_t scales_[10];
+	uint8_t nr_scales_ = 0;
+
+	unsigned long checked_ = 0;
+	unsigned long failed_ = 0;
+
+	void check(uint32_t value, uint32_t scale, uint32_t divisor)
+	{
+		const uint32_t expected = reference(value, scale, divisor);
+		const uint32_t actual = FrequencyMath::scaleByRatio(value, scale, divisor);
+		checked_++;
+
+		if (expected != actual)
+		{
+			if (failed_++ < 10)
+				fprintf(stderr, "%lu * %lu / %lu: expected %lu, got %lu\n", static_cast<unsigned long>(value), 
+					static_cast<unsigned long>(scale), static_cast<unsigned long>(divisor), 
+					static_cast<unsigned long>(expected), static_cast<unsigned long>(actual));
+		}
+	}
+
+	void verify(uint32_t random_inputs)
+	{
+		static const uint32_t limits[] = { 
+			0, 1, 2, 3, 15, 16, 17, 255, 256, 1000, 1001, 65535, 65536, 274876, 274877, 
+			0x7FFFFFFEul, 0x7FFFFFFFul, 0x80000000ul, 0xFFFFFFFEul, 0xFFFFFFFFul 
+		};
+		const uint8_t nr_limits = sizeof(limits) / sizeof(limits[0]);
+
+		for (uint8_t s = 0; s < nr_scales_; s++)
+		{
+			const uint32_t scale = scales_[s];
+
+			for (uint32_t value = 0; value <= 1024; value++)
+				for (uint32_t divisor = 1; divisor <= 1024; divisor++)
+					check(value, scale, divisor);
+
+			for (uint8_t v = 0; v < nr_limits; v++)
+				for (uint8_t d = 0; d < nr_limits; d++)
+					if ((limits[d] != 0) && (limits[d] <= 0x7FFFFFFFul))
+						check(limits[v], scale, limits[d]);
+
+			for (uint32_t i = 0; i < random_inputs; i++)
+			{
+				uint32_t divisor = randomMagnitude(31);
+				if (divisor == 0)
+					divisor = 1;
+				check(randomMagnitude(32), scale, divisor);
+			}
+		}
+	}
+
+	template <class Function>
+	void bench(const char *formulation, Function function, const uint32_t *values, const uint32_t *divisors, 
+		uint32_t count)
+	{
+		const uint32_t rounds = 100;
+		uint32_t checksum = 0;
+
+		const double start = cpuNanos();
+		const uint64_t start_cycles = cycles();
+		for (uint32_t r = 0; r < rounds; r++)
+			for (uint32_t i = 0; i < count; i++)
+				checksum += function(values[i], scales_[i % nr_scales_], divisors[i]);
+		const uint64_t end_cycles = cycles();
+		const double ns = (cpuNanos() - start) / (static_cast<double>(rounds) * count);
+
+		printf("{\"formulation\":\"%s\",\"computations\":%lu,\"ns_per_op\":%.1f,\"cycles_per_op\":%.1f,\"checksum\":%lu}\n",
+			formulation, static_cast<unsigned long>(rounds * count), ns, 
+			static_cast<double>(end_cycles - start_cycles) / (static_cast<double>(rounds) * count), 
+			static_cast<unsigned long>(checksum));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t random_inputs = 1000000;
+	if (argc == 2)
+		random_inputs = strtoul(argv[1], nullptr, 0);
+	else if (argc != 1)
+	{
+		fprintf(stderr, "usage: %s [RANDOM_INPUTS]\n", argv[0]);
+		return 2;
+	}
+
+	//divider * 1000000, halved when counting both edges, as in computeCalibratedFrequency()
+	static const uint32_t dividers[] = { 1, 16, 32, 64, 128 };
+	for (uint8_t d = 0; d < 5; d++)
+	{
+		scales_[nr_scales_++] = dividers[d] * 1000000ul;
+		scales_[nr_scales_++] = (dividers[d] * 1000000ul) >> 1;
+	}
+
+	verify(random_inputs);
+	printf("{\"checked\":%lu,\"failed\":%lu}\n", checked_, failed_);
+
+	//measurements of 100 ... 5000 samples at 10 ... 100 ms
+	const uint32_t count = 4096;
+	static uint32_t values[count];
+	static uint32_t divisors[count];
+	for (uint32_t i = 0; i < count; i++)
+	{
+		values[i] = 101 + xorshift() % 4900;
+		divisors[i] = 10000 + xorshift() % 90000;
+	}
+
+	bench("uint64_t division", reference, values, divisors, count);
+	bench("scaleByRatio", FrequencyMath::scaleByRatio, values, divisors, count);
+
+	return failed_ ? 1 : 0;
+}
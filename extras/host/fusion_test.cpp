@@ -0,0 +1,326 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// fusion_test.cpp
+//
+// test of AS3935Fusion grouping the lightning events of several sensors into strikes, standalone and with three 
+// simulated sensors managed by an AS3935Array. runs in virtual time.
+
+#include <stdio.h>
+
+#include "AS3935Array.h"
+#include "AS3935Fusion.h"
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+static AS3935Event lightning(uint32_t energy, uint8_t distance)
+{
+	AS3935Event event;
+	event.timestamp = 0;
+	event.energy = energy;
+	event.source = AS3935MI::AS3935_INT_L;
+	event.distance = distance;
+	return event;
+}
+
+static void testMerge()
+{
+	AS3935FusionSlot slots[4];
+	AS3935Fusion fusion(slots, 4, 1000, 5000);
+
+	CHECK(fusion.add(0, lightning(3000, 10), 100000));
+	CHECK(fusion.add(2, lightning(1000, 14), 100800));
+	CHECK(fusion.add(1, lightning(2000, AS3935MI::AS3935_DST_OOR), 100300));
+	CHECK(fusion.count() == 1);
+
+	//non lightning events and invalid sensors are ignored
+	AS3935Event disturber = lightning(0, 0);
+	disturber.source = AS3935MI::AS3935_INT_D;
+	CHECK(!fusion.add(3, disturber, 100400));
+	CHECK(!fusion.add(AS3935Fusion::AS3935_FUSION_MAX_SENSORS, lightning(1, 1), 100400));
+
+	AS3935Strike strike;
+	CHECK(!fusion.next(strike, 100000 + 1000 + 5000));
+	CHECK(fusion.next(strike, 100000 + 1000 + 5001));
+	CHECK(strike.timestamp == 100000);
+	CHECK(strike.duration == 800);
+	CHECK(strike.count == 3);
+	CHECK(strike.sensors == 0b111);
+	CHECK(strike.energy_min == 1000);
+	CHECK(strike.energy_max == 3000);
+	CHECK(strike.distance == 12);
+	CHECK(strike.distance_min == 10);
+	CHECK(strike.distance_max == 14);
+	CHECK(fusion.count() == 0);
+	CHECK(!fusion.next(strike, 200000));
+}
+
+static void testSplit()
+{
+	AS3935FusionSlot slots[4];
+	AS3935Fusion fusion(slots, 4, 1000, 0);
+
+	//late report of an earlier time extends the strike backwards
+	CHECK(fusion.add(0, lightning(100, 5), 10500));
+	CHECK(fusion.add(1, lightning(100, 5), 10000));
+	//a second report of the same sensor is another lightning
+	CHECK(fusion.add(0, lightning(200, 6), 10600));
+	//beyond the window of the first strike, joins the second
+	CHECK(fusion.add(1, lightning(200, 6), 11200));
+	//beyond the window of both
+	CHECK(fusion.add(2, lightning(300, AS3935MI::AS3935_DST_OOR), 20000));
+	CHECK(fusion.count() == 3);
+
+	AS3935Strike strike;
+	CHECK(fusion.next(strike, 30000));
+	CHECK(strike.timestamp == 10000);
+	CHECK(strike.duration == 500);
+	CHECK(strike.sensors == 0b011);
+
+	CHECK(fusion.next(strike, 30000));
+	CHECK(strike.timestamp == 10600);
+	CHECK(strike.duration == 600);
+	CHECK(strike.sensors == 0b011);
+	CHECK(strike.energy_min == 200);
+
+	CHECK(fusion.next(strike, 30000));
+	CHECK(strike.sensors == 0b100);
+	CHECK(strike.count == 1);
+	CHECK(strike.distance == AS3935MI::AS3935_DST_OOR);
+	CHECK(strike.distance_min == AS3935MI::AS3935_DST_OOR);
+
+	//timestamps wrap around
+	CHECK(fusion.add(0, lightning(100, 5), 0xFFFFFF00ul));
+	CHECK(fusion.add(1, lightning(100, 5), 0x00000100ul));
+	CHECK(fusion.count() == 1);
+	CHECK(!fusion.next(strike, 0x00000200ul));
+	CHECK(fusion.next(strike, 0x00001000ul));
+	CHECK(strike.duration == 0x200);
+}
+
+static void testBuffer()
+{
+	AS3935FusionSlot slots[2];
+	AS3935Fusion fusion(slots, 2, 1000, 0);
+
+	CHECK(fusion.add(0, lightning(1, 1), 10000));
+	CHECK(fusion.add(0, lightning(2, 1), 20000));
+	CHECK(fusion.add(0, lightning(3, 1), 30000));
+	CHECK(fusion.getDropped() == 1);
+	CHECK(fusion.count() == 2);
+
+	AS3935Strike strike;
+	CHECK(fusion.next(strike, 30100));
+	CHECK(strike.energy_min == 2);
+
+	//flushed strikes are closed, new reports open new strikes
+	fusion.flush();
+	CHECK(fusion.add(1, lightning(4, 1), 30100));
+
+	CHECK(fusion.next(strike, 30100));
+	CHECK(strike.energy_min == 3);
+	CHECK(strike.count == 1);
+	CHECK(!fusion.next(strike, 30100));
+	CHECK(fusion.next(strike, 31101));
+	CHECK(strike.energy_min == 4);
+
+	fusion.add(0, lightning(1, 1), 40000);
+	fusion.clear();
+	CHECK(fusion.count() == 0);
+}
+
+//reports read out of IRQ order keep the strikes ordered by their earliest report
+static void testOrder()
+{
+	AS3935FusionSlot slots[4];
+	AS3935Fusion fusion(slots, 4, 1000, 0);
+
+	//a report older than the open strike by more than the window opens an earlier strike
+	CHECK(fusion.add(0, lightning(1, 5), 10000));
+	CHECK(fusion.add(1, lightning(2, 5), 5000));
+	CHECK(fusion.count() == 2);
+
+	//joins the later strike, which is compared first
+	CHECK(fusion.add(2, lightning(3, 5), 10300));
+	CHECK(fusion.count() == 2);
+
+	//the earlier strike is closed first
+	AS3935Strike strike;
+	CHECK(fusion.next(strike, 10301));
+	CHECK(strike.timestamp == 5000);
+	CHECK(strike.energy_min == 2);
+	CHECK(!fusion.next(strike, 10301));
+	CHECK(fusion.next(strike, 11001));
+	CHECK(strike.timestamp == 10000);
+	CHECK(strike.sensors == 0b101);
+
+	//a late report moves the later of two strikes before the earlier one
+	CHECK(fusion.add(0, lightning(4, 5), 20000));
+	CHECK(fusion.add(0, lightning(5, 5), 20800));
+	CHECK(fusion.add(1, lightning(6, 5), 19900));
+	CHECK(fusion.count() == 2);
+
+	CHECK(fusion.next(strike, 20901));
+	CHECK(strike.timestamp == 19900);
+	CHECK(strike.duration == 900);
+	CHECK(strike.energy_max == 6);
+	CHECK(!fusion.next(strike, 20901));
+	CHECK(fusion.next(strike, 21001));
+	CHECK(strike.timestamp == 20000);
+	CHECK(strike.count == 1);
+}
+
+//a long storm seen by four sensors with jitter, one strike per lightning
+static void testStorm()
+{
+	AS3935FusionSlot slots[8];
+	AS3935Fusion fusion(slots, 8, 2000, 10000);
+
+	uint32_t random = 12345;
+	uint32_t strikes = 0;
+	uint32_t reports = 0;
+	AS3935Strike strike;
+
+	for (uint32_t i = 0; i < 100000; i++)
+	{
+		const uint32_t time = i * 7000;
+		for (uint8_t sensor = 0; sensor < 4; sensor++)
+		{
+			random = random * 1103515245 + 12345;
+			fusion.add(sensor, lightning(1000 + sensor, 10 + sensor), time + (random >> 16) % 1000);
+		}
+
+		while (fusion.next(strike, time))
+		{
+			strikes++;
+			reports += strike.count;
+		}
+	}
+
+	fusion.flush();
+	while (fusion.next(strike, 0))
+	{
+		strikes++;
+		reports += strike.count;
+	}
+
+	CHECK(strikes == 100000);
+	CHECK(reports == 400000);
+	CHECK(fusion.getDropped() == 0);
+}
+
+#ifndef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+//without attachInterruptArg() the interrupt time of the library is shared by all sensors, each IRQ pin is timed 
+//by an interrupt service routine of its own
+static volatile uint32_t irq_micros_[3];
+
+static void irq0() { irq_micros_[0] = micros(); }
+static void irq1() { irq_micros_[1] = micros(); }
+static void irq2() { irq_micros_[2] = micros(); }
+#endif
+
+//events of three simulated sensors read by an AS3935Array, timed by the interrupts
+static void testSensors()
+{
+	hostResetTime();
+
+	AS3935Sim sim_0(2), sim_1(3), sim_2(4);
+	AS3935Sim *sims[] = { &sim_0, &sim_1, &sim_2 };
+
+	AS3935ArrayEntry entries[3];
+	AS3935Array array(entries, 3);
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		CHECK(sims[i]->begin());
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+		sims[i]->setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+#endif
+		array.add(*sims[i]);
+	}
+
+#ifndef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+	attachInterrupt(digitalPinToInterrupt(2), irq0, RISING);
+	attachInterrupt(digitalPinToInterrupt(3), irq1, RISING);
+	attachInterrupt(digitalPinToInterrupt(4), irq2, RISING);
+#endif
+
+	AS3935FusionSlot slots[4];
+	AS3935Fusion fusion(slots, 4, 1000, 20000);
+
+	//the lightning reaches the sensors 200us apart
+	const uint64_t start = hostNanos() + 1000000;
+	hostSchedule(start, [&sim_0]() { sim_0.injectLightning(5000, 8); });
+	hostSchedule(start + 200000, [&sim_1]() { sim_1.injectLightning(7000, 10); });
+	hostSchedule(start + 400000, [&sim_2]() { sim_2.injectLightning(6000, AS3935MI::AS3935_DST_OOR); });
+
+	AS3935Strike strike;
+	uint32_t strikes = 0;
+	for (uint32_t t = 0; t < 100; t++)
+	{
+		uint8_t index = 0;
+		AS3935Event event;
+		if (array.update(index, event) == AS3935Array::AS3935_ARRAY_EVENT)
+		{
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+			CHECK(fusion.add(index, event, array.getSensor(index).getInterruptMicros()));
+#else
+			CHECK(fusion.add(index, event, irq_micros_[index]));
+#endif
+		}
+
+		while (fusion.next(strike, micros()))
+		{
+			strikes++;
+			CHECK(strike.timestamp == static_cast<uint32_t>(start / 1000));
+			CHECK(strike.duration == 400);
+			CHECK(strike.sensors == 0b111);
+			CHECK(strike.energy_min == 5000);
+			CHECK(strike.energy_max == 7000);
+			CHECK(strike.distance == 9);
+		}
+
+		delayMicroseconds(500);
+	}
+
+	CHECK(strikes == 1);
+}
+
+int main()
+{
+	testMerge();
+	testSplit();
+	testBuffer();
+	testOrder();
+	testStorm();
+	testSensors();
+
+	printf("result: %s\n", (failures_ == 0) ? "pass" : "fail");
+
+	return (failures_ == 0) ? 0 : 1;
+}
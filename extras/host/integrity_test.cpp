@@ -0,0 +1,237 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// integrity_test.cpp
+//
+// test of the detection and restoring of a lost configuration on a simulated sensor. runs in virtual time.
+
+#include <stdio.h>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//duration of a register access on a 100 kHz I2C bus
+static const uint32_t ACCESS_NS = 300000;
+
+static const uint32_t INTERVAL_MS = 1000;
+
+static void configure(AS3935Sim &sim)
+{
+	sim.writeAFE(AS3935MI::AS3935_OUTDOORS);
+	sim.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_5);
+	sim.writeWatchdogThreshold(AS3935MI::AS3935_WDTH_4);
+	sim.writeSpikeRejection(AS3935MI::AS3935_SREJ_6);
+	sim.writeMaskDisturbers(true);
+	sim.writeAntennaTuning(13);
+}
+
+//checks are done once per interval, cost two bus transactions and follow the changes made through the driver
+static void testChecks()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	sim.setBusTiming(ACCESS_NS, ACCESS_NS);
+	CHECK(sim.begin());
+
+	CHECK(sim.updateIntegrityCheck() == AS3935MI::AS3935_INTEGRITY_IDLE);
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_IDLE);
+
+	CHECK(sim.setIntegrityCheckInterval(INTERVAL_MS));
+	configure(sim);
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	CHECK(sim.updateIntegrityCheck() == AS3935MI::AS3935_INTEGRITY_IDLE);
+	delay(INTERVAL_MS);
+
+	const uint32_t reads = sim.getRegisterReads();
+	const uint32_t bursts = sim.getBurstReads();
+	const uint32_t writes = sim.getRegisterWrites();
+	CHECK(sim.updateIntegrityCheck() == AS3935MI::AS3935_INTEGRITY_OK);
+	CHECK(sim.getBurstReads() - bursts == 2);
+	CHECK(sim.getRegisterReads() - reads == 6);
+	CHECK(sim.getRegisterWrites() == writes);
+	CHECK(sim.updateIntegrityCheck() == AS3935MI::AS3935_INTEGRITY_IDLE);
+
+	AS3935MI::integrity_statistics_t statistics = sim.getIntegrityStatistics();
+	CHECK(statistics.checks == 1);
+	CHECK(statistics.restored == 0);
+	CHECK(statistics.check_usec == (ACCESS_NS + 2 * ACCESS_NS / 4 + ACCESS_NS + ACCESS_NS + ACCESS_NS / 4) / 1000);
+	printf("check: %u us\n", statistics.check_usec);
+
+	//a pending interrupt is read first, the check does not clear it
+	sim.injectLightning(1000, 10);
+	delay(INTERVAL_MS);
+	CHECK(sim.updateIntegrityCheck() == AS3935MI::AS3935_INTEGRITY_IDLE);
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_OK);
+	CHECK((sim.peekRegister(0x03) & 0x0F) == AS3935MI::AS3935_INT_L);
+	AS3935Event event;
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	delay(INTERVAL_MS);
+	CHECK(sim.updateIntegrityCheck() == AS3935MI::AS3935_INTEGRITY_OK);
+
+	//powering down and statistics clearing are no lost configuration
+	sim.writePowerDown(true);
+	sim.clearStatistics();
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_OK);
+	sim.writePowerDown(false);
+
+	//a suspended sensor is not checked
+	CHECK(sim.suspend());
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_IDLE);
+	CHECK(sim.resume());
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_OK);
+
+	//after resetToDefaults() the defaults are expected
+	sim.resetToDefaults();
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_OK);
+
+	CHECK(sim.getIntegrityStatistics().restored == 0);
+	CHECK(sim.getIntegrityStatistics().failures == 0);
+
+	sim.resetIntegrityStatistics();
+	CHECK(sim.getIntegrityStatistics().checks == 0);
+
+	CHECK(sim.setIntegrityCheckInterval(0));
+	delay(INTERVAL_MS);
+	CHECK(sim.updateIntegrityCheck() == AS3935MI::AS3935_INTEGRITY_IDLE);
+}
+
+//a brownout reset is detected within one interval and the configuration and tuning are restored without recalibrating
+static void testBrownout()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	sim.setBusTiming(ACCESS_NS, ACCESS_NS);
+	CHECK(sim.begin());
+	configure(sim);
+	CHECK(sim.calibrateRCO());
+	CHECK(sim.setIntegrityCheckInterval(INTERVAL_MS));
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	const uint8_t registers[5] = { sim.peekRegister(0x00), sim.peekRegister(0x01), sim.peekRegister(0x02), 
+		sim.peekRegister(0x03), sim.peekRegister(0x08) };
+
+	uint32_t detected = 0;
+	hostSchedule(hostNanos() + 2500000000ull, [&sim]() { sim.powerOnReset(); });
+
+	for (uint32_t i = 0; i < 5000; i++)
+	{
+		delay(1);
+
+		const uint8_t result = sim.updateIntegrityCheck();
+		CHECK(result != AS3935MI::AS3935_INTEGRITY_FAILED);
+		if (result == AS3935MI::AS3935_INTEGRITY_RESTORED)
+			detected = millis();
+	}
+
+	const uint32_t reset = 2500 + 4;
+	CHECK(detected > reset);
+	CHECK(detected - reset <= INTERVAL_MS + 10);
+
+	const AS3935MI::integrity_statistics_t statistics = sim.getIntegrityStatistics();
+	CHECK(statistics.restored == 1);
+	CHECK(statistics.detection_ms >= detected - reset);
+	CHECK(statistics.detection_ms <= INTERVAL_MS + 10);
+	printf("detected after %u ms, restored in %u us\n", detected - reset, statistics.total_usec - 
+		(statistics.checks - 1) * statistics.check_usec);
+
+	CHECK(sim.peekRegister(0x00) == registers[0]);
+	CHECK(sim.peekRegister(0x01) == registers[1]);
+	CHECK((sim.peekRegister(0x02) & 0x3F) == (registers[2] & 0x3F));
+	CHECK(sim.peekRegister(0x03) == registers[3]);
+	CHECK(sim.peekRegister(0x08) == registers[4]);
+	CHECK(sim.peekRegister(0x3A) == 0x80);
+	CHECK(sim.peekRegister(0x3B) == 0x80);
+
+	//no interrupt from the RCO calibration, events are reported again
+	CHECK(sim.getInterruptTimestamp() == 0);
+	CHECK(digitalRead(2) == LOW);
+	sim.injectLightning(1000, 10);
+	AS3935Event event;
+	CHECK(sim.getInterruptTimestamp() != 0);
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+
+	//reset while powered down: restored without RCO calibration, still powered down
+	sim.writePowerDown(true);
+	sim.powerOnReset();
+	sim.writePowerDown(true);
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_RESTORED);
+	CHECK(sim.readPowerDown());
+	CHECK(sim.readAntennaTuning() == 13);
+	CHECK(sim.readAFE() == AS3935MI::AS3935_OUTDOORS);
+
+	//failed RCO calibration
+	sim.writePowerDown(false);
+	sim.powerOnReset();
+	sim.setRCOCalibrationFailure(true);
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_FAILED);
+	CHECK(sim.getIntegrityStatistics().failures == 1);
+}
+
+//a reset of a sensor configured with the defaults is detected by the lost RCO calibration
+static void testDefaults()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+	CHECK(sim.setIntegrityCheckInterval(INTERVAL_MS));
+
+	//not calibrated yet, which is not a lost configuration
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_OK);
+
+	CHECK(sim.calibrateRCO());
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_OK);
+
+	sim.powerOnReset();
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_RESTORED);
+	CHECK(sim.peekRegister(0x3A) == 0x80);
+	CHECK(sim.peekRegister(0x3B) == 0x80);
+	CHECK(sim.getInterruptTimestamp() == 0);
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_OK);
+
+	//a powered down sensor needs no calibration
+	sim.writePowerDown(true);
+	sim.powerOnReset();
+	sim.writePowerDown(true);
+	CHECK(sim.checkIntegrity() == AS3935MI::AS3935_INTEGRITY_OK);
+}
+
+int main()
+{
+	testChecks();
+	testBrownout();
+	testDefaults();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+
+	return (failures_ == 0) ? 0 : 1;
+}
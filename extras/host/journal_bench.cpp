@@ -0,0 +1,227 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// journal_bench.cpp
+//
+// exercises AS3935Journal on Linux using a file backed block device and reports throughput and 
+// write amplification. also simulates a power loss during a page write and checks that the journal 
+// recovers. AS3935Journal does not depend on the Arduino core, so this can be built on the host directly:
+//
+//   g++ -std=c++11 -O2 -I../../src journal_bench.cpp ../../src/AS3935Journal.cpp ../../src/AS3935CRC.cpp -o journal_bench
+//   ./journal_bench [file]
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "AS3935Journal.h"
+
+//block device backed by a file. counts the bytes written to it. 
+class FileBlockDevice : public AS3935BlockDevice
+{
+public:
+	FileBlockDevice(const char *path, uint16_t page_size, uint16_t page_count) :
+		fd_(open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)),
+		page_size_(page_size),
+		page_count_(page_count),
+		bytes_written_(0)
+	{
+		//an erased flash page reads as 0xFF
+		std::vector<uint8_t> erased(page_size_, 0xFF);
+		for (uint16_t page = 0; page < page_count_; page++)
+			pwrite(fd_, erased.data(), page_size_, static_cast<off_t>(page) * page_size_);
+	}
+
+	~FileBlockDevice()
+	{
+		if (fd_ >= 0)
+			close(fd_);
+	}
+
+	bool isOpen() const { return fd_ >= 0; }
+
+	uint16_t pageSize() const { return page_size_; }
+
+	uint16_t pageCount() const { return page_count_; }
+
+	bool read(uint16_t page, uint16_t offset, uint8_t *data, uint16_t length)
+	{
+		const off_t position = static_cast<off_t>(page) * page_size_ + offset;
+		return pread(fd_, data, length, position) == length;
+	}
+
+	bool writePage(uint16_t page, const uint8_t *data)
+	{
+		bytes_written_ += page_size_;
+		return pwrite(fd_, data, page_size_, static_cast<off_t>(page) * page_size_) == page_size_;
+	}
+
+	//simulates a power loss while writing a page: only the first half of the page is written.
+	void tornWrite(uint16_t page)
+	{
+		std::vector<uint8_t> garbage(page_size_ / 2, 0x5A);
+		pwrite(fd_, garbage.data(), garbage.size(), static_cast<off_t>(page) * page_size_);
+	}
+
+	uint64_t bytesWritten() const { return bytes_written_; }
+
+private:
+	int fd_;
+	uint16_t page_size_;
+	uint16_t page_count_;
+	uint64_t bytes_written_;
+};
+
+static AS3935Event makeEvent(uint32_t i)
+{
+	AS3935Event event;
+	event.timestamp = i * 1000;
+	event.energy = (i * 7919) & 0xFFFFF;
+	event.source = (i % 3 == 0) ? 0b1000 : 0b0100;
+	event.distance = i % 64;
+	return event;
+}
+
+static bool sameEvent(const AS3935Event &a, const AS3935Event &b)
+{
+	return (a.timestamp == b.timestamp) && (a.energy == b.energy) && 
+		(a.source == b.source) && (a.distance == b.distance);
+}
+
+//appends nr_events events, flushing after every flush_every events (0: only when a page is full).
+static bool benchmark(const char *path, uint32_t nr_events, uint32_t flush_every)
+{
+	const uint16_t page_size = 256;
+	const uint16_t page_count = 64;
+
+	FileBlockDevice device(path, page_size, page_count);
+	std::vector<uint8_t> buffer(page_size);
+	AS3935Journal journal(&device, buffer.data());
+
+	if (!device.isOpen() || !journal.begin())
+		return false;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < nr_events; i++)
+	{
+		if (!journal.append(makeEvent(i)))
+			return false;
+
+		if ((flush_every != 0) && ((i + 1) % flush_every == 0) && !journal.flush())
+			return false;
+	}
+
+	if (!journal.flush())
+		return false;
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const double payload = static_cast<double>(nr_events) * AS3935Journal::AS3935_JOURNAL_RECORD_SIZE;
+
+	printf("flush_every: %u\n", flush_every);
+	printf("  events: %u\n", nr_events);
+	printf("  events_per_second: %.0f\n", nr_events / seconds);
+	printf("  pages_written: %u\n", journal.pagesWritten());
+	printf("  bytes_written: %llu\n", static_cast<unsigned long long>(device.bytesWritten()));
+	printf("  write_amplification: %.3f\n", device.bytesWritten() / payload);
+	printf("  writes_per_page: %.1f\n", static_cast<double>(journal.pagesWritten()) / page_count);
+
+	//the journal must contain the newest events that fit into the block device
+	AS3935Journal::Iterator it = journal.iterator();
+	AS3935Event event;
+	uint32_t count = 0;
+	uint32_t last = 0;
+	while (it.next(event))
+	{
+		count++;
+		last = event.timestamp / 1000;
+		if (!sameEvent(event, makeEvent(last)))
+			return false;
+	}
+
+	return (count > 0) && (last == nr_events - 1);
+}
+
+//writes events, tears the next page write and checks that a new journal continues after the last intact page.
+static bool recovery(const char *path)
+{
+	const uint16_t page_size = 128;
+	const uint16_t page_count = 8;
+
+	FileBlockDevice device(path, page_size, page_count);
+	std::vector<uint8_t> buffer(page_size);
+
+	uint32_t sequence = 0;
+	uint32_t nr_events = 0;
+	{
+		AS3935Journal journal(&device, buffer.data());
+		if (!journal.begin())
+			return false;
+
+		//wrap around the block device at least once
+		nr_events = journal.recordsPerPage() * (page_count + 3) + 5;
+		for (uint32_t i = 0; i < nr_events; i++)
+			journal.append(makeEvent(i));
+
+		//the buffered events are lost in the power loss, as is the page being written
+		sequence = journal.sequence();
+		nr_events -= journal.pending();
+		device.tornWrite((sequence - 1) % page_count);
+	}
+
+	AS3935Journal journal(&device, buffer.data());
+	if (!journal.begin())
+		return false;
+
+	//the torn page held the oldest events, so the newest events must be intact
+	AS3935Journal::Iterator it = journal.iterator();
+	AS3935Event event;
+	uint32_t count = 0;
+	uint32_t expected = nr_events - (page_count - 1) * journal.recordsPerPage();
+	while (it.next(event))
+	{
+		if (!sameEvent(event, makeEvent(expected++)))
+			return false;
+		count++;
+	}
+
+	printf("recovery:\n");
+	printf("  sequence_before: %u\n", sequence);
+	printf("  sequence_after: %u\n", journal.sequence());
+	printf("  events_recovered: %u\n", count);
+
+	return (journal.sequence() == sequence) && (expected == nr_events);
+}
+
+int main(int argc, char **argv)
+{
+	const char *path = (argc > 1) ? argv[1] : "journal_bench.bin";
+
+	bool success = benchmark(path, 200000, 0);
+	success = benchmark(path, 20000, 1) && success;
+	success = recovery(path) && success;
+
+	unlink(path);
+
+	printf("result: %s\n", success ? "pass" : "fail");
+
+	return success ? 0 : 1;
+}
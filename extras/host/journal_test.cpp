@@ -0,0 +1,163 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// journal_test.cpp
+//
+// test of AS3935Journal on a RAM block device whose writes can be made to fail: a full page that cannot be written 
+// stays buffered, further events are dropped without writing past the page buffer, and the page is written once the 
+// block device works again.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "AS3935Journal.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+#define PAGE_SIZE 64
+#define PAGE_COUNT 4
+
+//block device in RAM. writePage() fails while fail_writes_ is set. 
+class RamBlockDevice : public AS3935BlockDevice
+{
+public:
+	RamBlockDevice() :
+		fail_writes_(false),
+		writes_(0)
+	{
+		//an erased flash page reads as 0xFF
+		memset(memory_, 0xFF, sizeof(memory_));
+	}
+
+	uint16_t pageSize() const { return PAGE_SIZE; }
+
+	uint16_t pageCount() const { return PAGE_COUNT; }
+
+	bool read(uint16_t page, uint16_t offset, uint8_t *data, uint16_t length)
+	{
+		if ((page >= PAGE_COUNT) || (offset + length > PAGE_SIZE))
+			return false;
+
+		memcpy(data, memory_[page] + offset, length);
+		return true;
+	}
+
+	bool writePage(uint16_t page, const uint8_t *data)
+	{
+		writes_++;
+
+		if (fail_writes_ || (page >= PAGE_COUNT))
+			return false;
+
+		memcpy(memory_[page], data, PAGE_SIZE);
+		return true;
+	}
+
+	bool fail_writes_;
+	uint32_t writes_;
+
+private:
+	uint8_t memory_[PAGE_COUNT][PAGE_SIZE];
+};
+
+static AS3935Event makeEvent(uint32_t i)
+{
+	AS3935Event event;
+	event.timestamp = i * 1000;
+	event.energy = (i * 7919) & 0xFFFFF;
+	event.source = 0b1000;
+	event.distance = i % 64;
+	return event;
+}
+
+//a page that cannot be written is kept, events appended in the meantime are dropped
+static void testWriteFailure()
+{
+	//guard bytes behind the page buffer detect writes past its end
+	uint8_t buffer[PAGE_SIZE + 16];
+	memset(buffer, 0xA5, sizeof(buffer));
+
+	RamBlockDevice device;
+	AS3935Journal journal(&device, buffer);
+	CHECK(journal.begin());
+
+	const uint8_t records_per_page = journal.recordsPerPage();
+	CHECK(records_per_page > 0);
+
+	device.fail_writes_ = true;
+
+	uint32_t i = 0;
+	for (; i + 1 < records_per_page; i++)
+		CHECK(journal.append(makeEvent(i)));
+
+	//the event filling the page is buffered, writing the page fails
+	CHECK(!journal.append(makeEvent(i++)));
+	CHECK(journal.pending() == records_per_page);
+	CHECK(device.writes_ == 1);
+
+	//each further event retries the write and is dropped
+	for (uint32_t j = 0; j < 3 * records_per_page; j++)
+		CHECK(!journal.append(makeEvent(1000 + j)));
+
+	CHECK(journal.pending() == records_per_page);
+	CHECK(device.writes_ == 1u + 3u * records_per_page);
+	CHECK(!journal.flush());
+	CHECK(journal.pagesWritten() == 0);
+
+	for (size_t k = PAGE_SIZE; k < sizeof(buffer); k++)
+		CHECK(buffer[k] == 0xA5);
+
+	//the block device works again: the buffered page is written before the next event is buffered
+	device.fail_writes_ = false;
+	CHECK(journal.append(makeEvent(i++)));
+	CHECK(journal.pagesWritten() == 1);
+	CHECK(journal.pending() == 1);
+	CHECK(journal.flush());
+	CHECK(journal.pagesWritten() == 2);
+
+	//all events but the dropped ones are stored in order
+	AS3935Journal::Iterator it = journal.iterator();
+	AS3935Event event;
+	uint32_t count = 0;
+	while (it.next(event))
+	{
+		const AS3935Event expected = makeEvent(count);
+		CHECK(event.timestamp == expected.timestamp);
+		CHECK(event.energy == expected.energy);
+		CHECK(event.distance == expected.distance);
+		count++;
+	}
+
+	CHECK(count == i);
+}
+
+int main()
+{
+	testWriteFailure();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+	return (failures_ == 0) ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// locking_test.cpp
+//
+// stress test of AS3935MI_ENABLE_LOCKING: several threads change fields sharing a register, read events and read the 
+// cached view of a simulated sensor at the same time. runs in real time.
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static std::atomic<int> failures_(0);
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//duration of a register access
+static const uint32_t ACCESS_NS = 20000;
+
+//writing a threshold takes 2 ms
+static const uint32_t WRITES = 500;
+static const uint32_t EVENTS = 2000;
+
+//energy of the lightnings injected at the given distance, so readers can check that a cached event is consistent
+static uint32_t energyAt(uint8_t distance)
+{
+	return distance * 4097ul;
+}
+
+//a reader that keeps failing waits for the writers' mutex instead of spinning, and gets the value once the writer is done
+static void testSeqLockFallback()
+{
+	AS3935Mutex mutex;
+	AS3935SeqLock<uint32_t> value;
+	std::atomic<bool> done(false);
+	uint32_t result = 0;
+
+	//a writer preempted in the middle of an update
+	mutex.lock();
+	value.beginWrite() = 1234;
+
+	std::thread reader([&]() {
+		value.read(result, mutex);
+		done = true;
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	CHECK(!done);
+
+	value.endWrite();
+	mutex.unlock();
+	reader.join();
+
+	CHECK(done);
+	CHECK(result == 1234);
+}
+
+int main()
+{
+	testSeqLockFallback();
+
+	//the bus accesses sleep, so the other threads run in the middle of a read-modify-write even on a single core
+	AS3935Sim sim(2);
+	hostSetVirtualTime(false);
+	sim.setBusTiming(ACCESS_NS, ACCESS_NS);
+
+	CHECK(sim.begin());
+
+	AS3935MI::cached_view_t view;
+	sim.readCachedView(view);
+	CHECK(view.afe == AS3935MI::AS3935_INDOORS);
+	CHECK(view.noise_floor == AS3935MI::AS3935_NFL_2);
+	CHECK(view.events == 0);
+
+	std::atomic<bool> done(false);
+
+	//noise floor and watchdog threshold share register 0x01: a read-modify-write not serialized with the other one 
+	//loses its change
+	std::atomic<uint32_t> lost_noise_floor(0);
+	std::thread noise_floor([&]() {
+		for (uint32_t i = 0; i < WRITES; i++) {
+			sim.writeNoiseFloorThreshold(i % 8);
+			if (sim.readNoiseFloorThreshold() != i % 8)
+				lost_noise_floor++;
+		}
+	});
+
+	std::atomic<uint32_t> lost_watchdog(0);
+	std::thread watchdog([&]() {
+		for (uint32_t i = 0; i < WRITES; i++) {
+			sim.writeWatchdogThreshold(i % 11);
+			if (sim.readWatchdogThreshold() != i % 11)
+				lost_watchdog++;
+		}
+	});
+
+	std::atomic<uint32_t> wrong_events(0);
+	std::thread events([&]() {
+		for (uint32_t i = 0; i < EVENTS; i++) {
+			const uint8_t distance = 1 + i % 63;
+			sim.injectLightning(energyAt(distance), distance);
+
+			AS3935Event event;
+			if ((sim.readEvent(event) != AS3935MI::AS3935_INT_L) || (event.distance != distance) || 
+				(event.energy != energyAt(distance)))
+				wrong_events++;
+		}
+	});
+
+	//lock free reader
+	std::atomic<uint32_t> torn_views(0);
+	std::atomic<uint32_t> views(0);
+	std::thread telemetry([&]() {
+		uint32_t last_events = 0;
+		while (!done) {
+			AS3935MI::cached_view_t view;
+			sim.readCachedView(view);
+			if ((view.events < last_events) || 
+				((view.events != 0) && (view.event.energy != energyAt(view.event.distance))) || 
+				(view.noise_floor > 7) || (view.watchdog_threshold > 10))
+				torn_views++;
+			last_events = view.events;
+			views++;
+			std::this_thread::yield();
+		}
+	});
+
+	noise_floor.join();
+	watchdog.join();
+	events.join();
+	done = true;
+	telemetry.join();
+
+	CHECK(lost_noise_floor == 0);
+	CHECK(lost_watchdog == 0);
+	CHECK(wrong_events == 0);
+	CHECK(torn_views == 0);
+	CHECK(views > 0);
+
+	//the cached view matches the sensor
+	sim.readCachedView(view);
+	CHECK(view.noise_floor == (WRITES - 1) % 8);
+	CHECK(view.watchdog_threshold == (WRITES - 1) % 11);
+	CHECK(view.events == EVENTS);
+	CHECK(view.event.distance == 1 + (EVENTS - 1) % 63);
+	CHECK(view.noise_floor == ((sim.peekRegister(0x01) >> 4) & 0x07));
+	CHECK(view.watchdog_threshold == (sim.peekRegister(0x01) & 0x0F));
+
+	//resetToDefaults() resets the cached configuration
+	sim.resetToDefaults();
+	sim.readCachedView(view);
+	CHECK(view.noise_floor == AS3935MI::AS3935_NFL_2);
+	CHECK(view.watchdog_threshold == AS3935MI::AS3935_WDTH_2);
+	CHECK(view.spike_rejection == AS3935MI::AS3935_SREJ_2);
+
+	printf("%u cached views read, lost updates: %u noise floor, %u watchdog threshold\n", 
+		static_cast<unsigned>(views), static_cast<unsigned>(lost_noise_floor), static_cast<unsigned>(lost_watchdog));
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+	return (failures_ == 0) ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// poller_test.cpp
+//
+// test of a simulated sensor without IRQ pin read by AS3935Poller. runs in virtual time.
+
+#include <stdio.h>
+
+#include "AS3935Poller.h"
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//functions needing the IRQ pin fail without using the bus
+static void testNoIRQ()
+{
+	hostResetTime();
+
+	AS3935Sim sim(AS3935MI::AS3935_NO_IRQ);
+	CHECK(!sim.hasIRQ());
+	CHECK(sim.begin());
+	CHECK(sim.checkConnection());
+
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+	CHECK(sim.getInterruptMode() == AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	const uint32_t reads = sim.getRegisterReads();
+	const uint32_t start = millis();
+
+	CHECK(!sim.checkIRQ());
+	CHECK(!sim.calibrateResonanceFrequency());
+	CHECK(sim.getCalibratedAntCap() == -1);
+	CHECK(sim.getRegisterReads() == reads);
+	CHECK(millis() == start);
+
+	//RCO calibration does not need the IRQ pin
+	CHECK(sim.calibrateRCO());
+
+	AS3935Sim with_irq(2);
+	CHECK(with_irq.hasIRQ());
+}
+
+//events are detected within the latency bound, the interval backs off when idle and the bus load is limited
+static void testPolling(uint32_t read_ns, uint16_t max_bus_load)
+{
+	hostResetTime();
+
+	AS3935Sim sim(AS3935MI::AS3935_NO_IRQ);
+	sim.setBusTiming(read_ns, read_ns);
+	CHECK(sim.begin());
+	sim.writeMaskDisturbers(false);
+
+	AS3935Poller poller(sim, 2000, 256000, max_bus_load);
+
+	//one event every 1.5s, alternating lightnings and disturbers
+	const uint32_t nr_events = 20;
+	uint64_t injected_ns[nr_events];
+	for (uint32_t i = 0; i < nr_events; i++)
+	{
+		injected_ns[i] = 1000000000ull + i * 1500000000ull;
+		hostSchedule(injected_ns[i], [&sim, i]() {
+			if (i & 1)
+				sim.injectDisturber();
+			else
+				sim.injectLightning(1000 + i, 10);
+		});
+	}
+
+	uint32_t detected = 0;
+	uint32_t min_interval = 0xFFFFFFFFul;
+	uint32_t max_interval = 0;
+	uint32_t latency_max_usec = 0;
+
+	while (hostNanos() < injected_ns[nr_events - 1] + 2000000000ull)
+	{
+		AS3935Event event;
+		const uint8_t source = poller.update(event);
+		if (source)
+		{
+			CHECK(detected < nr_events);
+			CHECK(source == ((detected & 1) ? AS3935MI::AS3935_INT_D : AS3935MI::AS3935_INT_L));
+
+			const uint32_t latency_usec = static_cast<uint32_t>((hostNanos() - injected_ns[detected]) / 1000);
+			if (latency_usec > latency_max_usec)
+				latency_max_usec = latency_usec;
+
+			detected++;
+		}
+
+		if (poller.getInterval() < min_interval)
+			min_interval = poller.getInterval();
+		if (poller.getInterval() > max_interval)
+			max_interval = poller.getInterval();
+
+		hostAdvanceTime(100000);
+	}
+
+	const AS3935Poller::statistics_t statistics = poller.getStatistics();
+
+	printf("read %lu ns, max bus load %u: %lu polls, bus load %u, interval %lu ... %lu us, latency max %lu us "
+		"(bound %lu us), mean bound %lu us\n", 
+		static_cast<unsigned long>(read_ns), max_bus_load, static_cast<unsigned long>(statistics.polls), 
+		poller.getBusLoad(), static_cast<unsigned long>(min_interval), static_cast<unsigned long>(max_interval), 
+		static_cast<unsigned long>(latency_max_usec), static_cast<unsigned long>(statistics.latency_max_usec), 
+		static_cast<unsigned long>(statistics.events ? statistics.latency_sum_usec / statistics.events : 0));
+
+	CHECK(detected == nr_events);
+	CHECK(statistics.events == nr_events);
+	CHECK(latency_max_usec <= statistics.latency_max_usec);
+	//polls start up to 100us late, reading a lightning takes 5 register reads
+	CHECK(statistics.latency_max_usec <= 256000 + 100 + 5 * read_ns / 1000);
+	CHECK(max_interval == 256000);
+	CHECK(poller.getBusLoad() <= max_bus_load);
+	CHECK(min_interval >= (read_ns / 1000) * 1000 / max_bus_load);
+}
+
+int main()
+{
+	testNoIRQ();
+	//I2C at 100kHz and SPI at 2MHz
+	testPolling(390000, 10);
+	testPolling(9000, 10);
+	testPolling(9000, 100);
+
+	printf("result: %s\n", (failures_ == 0) ? "pass" : "fail");
+
+	return (failures_ == 0) ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// power_test.cpp
+//
+// test of suspend() / resume() on a simulated sensor. runs in virtual time.
+
+#include <stdio.h>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//duration of a register access on a 100 kHz I2C bus
+static const uint32_t ACCESS_NS = 300000;
+
+static void configure(AS3935Sim &sim)
+{
+	sim.writeAFE(AS3935MI::AS3935_OUTDOORS);
+	sim.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_4);
+	sim.writeWatchdogThreshold(AS3935MI::AS3935_WDTH_3);
+	sim.writeSpikeRejection(AS3935MI::AS3935_SREJ_5);
+	sim.writeMinLightnings(AS3935MI::AS3935_MNL_5);
+	sim.writeMaskDisturbers(true);
+	sim.writeAntennaTuning(7);
+}
+
+static bool sameSettings(const AS3935Sim &sim, const uint8_t *registers)
+{
+	return (sim.peekRegister(0x00) == registers[0]) && (sim.peekRegister(0x01) == registers[1]) && 
+		(sim.peekRegister(0x02) == registers[2]) && (sim.peekRegister(0x03) == registers[3]) && 
+		(sim.peekRegister(0x08) == registers[4]);
+}
+
+//the settings survive a power cycle and the resume is faster than writePowerDown(false) and calibrateRCO()
+static void testResume()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	sim.setBusTiming(ACCESS_NS, ACCESS_NS);
+	CHECK(sim.begin());
+	configure(sim);
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	const uint8_t registers[5] = { sim.peekRegister(0x00), sim.peekRegister(0x01), sim.peekRegister(0x02), 
+		sim.peekRegister(0x03), sim.peekRegister(0x08) };
+
+	CHECK(!sim.resume());
+	CHECK(!sim.isSuspended());
+
+	CHECK(sim.suspend());
+	CHECK(sim.isSuspended());
+	CHECK(sim.readPowerDown());
+	CHECK(!sim.suspend());
+
+	//no events while powered down
+	sim.injectLightning(1000, 10);
+	CHECK(sim.getInterruptTimestamp() == 0);
+
+	delay(60000);
+
+	const uint32_t reads = sim.getRegisterReads();
+	const uint32_t writes = sim.getRegisterWrites();
+
+	CHECK(sim.resume());
+	CHECK(sim.getInterruptTimestamp() == 0);
+	CHECK(!sim.isSuspended());
+	CHECK(!sim.readPowerDown());
+	CHECK(sameSettings(sim, registers));
+	CHECK(sim.peekRegister(0x3A) == 0x80);
+	CHECK(sim.peekRegister(0x3B) == 0x80);
+	CHECK(sim.getInterruptMode() == AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	//4 settings, calibration command, SRCO on and off, 2 calibration results
+	const uint32_t resume_reads = sim.getRegisterReads() - reads - 1;
+	const uint32_t resume_writes = sim.getRegisterWrites() - writes;
+	CHECK(resume_reads == 2);
+	CHECK(resume_writes == 7);
+
+	const AS3935MI::resume_statistics_t resume = sim.getResumeStatistics();
+	CHECK((resume.suspended_ms >= 60000) && (resume.suspended_ms <= 60001));
+	CHECK(resume.frequency == 0);
+	CHECK(resume.resume_usec == 2000 + (resume_reads + resume_writes) * ACCESS_NS / 1000);
+	CHECK(resume.resume_nj == static_cast<uint64_t>(resume.resume_usec) * 60 * 3300 / 1000000);
+	CHECK(resume.saved_uj == resume.suspended_ms * 59ull * 3300 / 1000000);
+
+	//events are reported again
+	sim.injectLightning(1000, 10);
+	CHECK(sim.getInterruptTimestamp() != 0);
+	CHECK(sim.readInterruptSource() == AS3935MI::AS3935_INT_L);
+
+	//the same power cycle with the functions available so far
+	CHECK(sim.suspend());
+	const uint32_t start = micros();
+	const uint32_t accesses = sim.getRegisterReads() + sim.getRegisterWrites();
+	sim.writePowerDown(false);
+	CHECK(sim.calibrateRCO());
+	const uint32_t manual_usec = micros() - start;
+	const uint32_t manual_accesses = sim.getRegisterReads() + sim.getRegisterWrites() - accesses;
+
+	printf("resume: %u us, %u accesses, %u nJ; writePowerDown(false) + calibrateRCO(): %u us, %u accesses\n", 
+		resume.resume_usec, resume_reads + resume_writes, resume.resume_nj, manual_usec, manual_accesses);
+
+	//the settings are written without reading them, but one of the two 2ms delays is saved
+	CHECK(resume.resume_usec + 1000 < manual_usec);
+}
+
+//the settings are restored even if they were lost while powered down
+static void testSupplyLoss()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+	configure(sim);
+
+	const uint8_t registers[5] = { sim.peekRegister(0x00), sim.peekRegister(0x01), sim.peekRegister(0x02), 
+		sim.peekRegister(0x03), sim.peekRegister(0x08) };
+
+	CHECK(sim.suspend());
+
+	//power on reset
+	sim.resetToDefaults();
+	CHECK(!sameSettings(sim, registers));
+
+	CHECK(sim.resume());
+	CHECK(sameSettings(sim, registers));
+	CHECK(sim.readAntennaTuning() == 7);
+}
+
+//the antenna check measures the stored tuning capacitor setting and restores the division ratio and interrupt mode
+static void testAntennaCheck()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+	CHECK(sim.calibrateResonanceFrequency());
+	const int8_t cap = sim.getCalibratedAntCap();
+	CHECK(cap >= 0);
+
+	sim.writeDivisionRatio(AS3935MI::AS3935_DR_128);
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	CHECK(sim.suspend());
+	CHECK(sim.resume(true));
+
+	const AS3935MI::resume_statistics_t resume = sim.getResumeStatistics();
+	CHECK(resume.frequency > 500000 * (1.0 - AS3935MI_ALLOWED_DEVIATION));
+	CHECK(resume.frequency < 500000 * (1.0 + AS3935MI_ALLOWED_DEVIATION));
+	CHECK(resume.resume_usec > 10000);
+	CHECK(sim.readAntennaTuning() == cap);
+	CHECK(sim.readDivisionRatio() == AS3935MI::AS3935_DR_128);
+	CHECK(sim.getInterruptMode() == AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	printf("resume with antenna check: %u us, %u nJ\n", resume.resume_usec, resume.resume_nj);
+
+	//the antenna was detuned while powered down
+	CHECK(sim.suspend());
+	sim.setAntenna(100.0, 1200.0);
+	CHECK(!sim.resume(true));
+	CHECK(!sim.isSuspended());
+	CHECK(sim.getResumeStatistics().frequency < 500000 * (1.0 - AS3935MI_ALLOWED_DEVIATION));
+
+	//the antenna can not be checked without IRQ pin
+	AS3935Sim no_irq(AS3935MI::AS3935_NO_IRQ);
+	CHECK(no_irq.begin());
+	CHECK(no_irq.suspend());
+	CHECK(!no_irq.resume(true));
+	CHECK(!no_irq.readPowerDown());
+}
+
+//a failed RCO calibration fails the resume, the sensor is powered up nevertheless
+static void testCalibrationFailure()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+	CHECK(sim.suspend());
+
+	sim.setRCOCalibrationFailure(true);
+	CHECK(!sim.resume());
+	CHECK(!sim.isSuspended());
+	CHECK(!sim.readPowerDown());
+}
+
+int main()
+{
+	testResume();
+	testSupplyLoss();
+	testAntennaCheck();
+	testCalibrationFailure();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+
+	return (failures_ == 0) ? 0 : 1;
+}
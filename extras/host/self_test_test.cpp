@@ -0,0 +1,121 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// self_test_test.cpp
+//
+// test of selfTest() on a simulated sensor: the failures reported and the duration compared to checkConnection() and 
+// checkIRQ(). runs in virtual time.
+
+#include <stdio.h>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//duration of a register access on a 100 kHz I2C bus
+static const uint32_t ACCESS_NS = 300000;
+
+//a healthy sensor passes in a few milliseconds, the interrupt mode is kept
+static void testPass()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	sim.setBusTiming(ACCESS_NS, ACCESS_NS);
+	CHECK(sim.begin());
+	CHECK(sim.calibrateRCO());
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	uint64_t start = hostNanos();
+	CHECK(sim.selfTest() == 0);
+	const uint32_t self_test_usec = static_cast<uint32_t>((hostNanos() - start) / 1000);
+
+	CHECK(self_test_usec < 5000);
+	CHECK(sim.getInterruptMode() == AS3935MI::AS3935_INTERRUPT_NORMAL);
+	CHECK(sim.getInterruptTimestamp() == 0);
+	CHECK((sim.peekRegister(0x08) & 0xE0) == 0);
+
+	sim.injectLightning(1000, 10);
+	CHECK(sim.getInterruptTimestamp() != 0);
+
+	AS3935Event event;
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+
+	start = hostNanos();
+	CHECK(sim.checkConnection());
+	CHECK(sim.checkIRQ());
+	const uint32_t check_usec = static_cast<uint32_t>((hostNanos() - start) / 1000);
+
+	printf("selfTest(): %u us, checkConnection() + checkIRQ(): %u us\n", self_test_usec, check_usec);
+}
+
+//each failure sets its bit
+static void testFailures()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+
+	//RCOs not calibrated yet
+	CHECK(sim.selfTest() == (AS3935MI::AS3935_SELF_TEST_TRCO | AS3935MI::AS3935_SELF_TEST_SRCO));
+
+	sim.setRCOCalibrationFailure(true);
+	CHECK(!sim.calibrateRCO());
+	CHECK(sim.selfTest() == (AS3935MI::AS3935_SELF_TEST_TRCO | AS3935MI::AS3935_SELF_TEST_SRCO));
+
+	sim.setRCOCalibrationFailure(false);
+	CHECK(sim.calibrateRCO());
+	CHECK(sim.selfTest() == 0);
+
+	//the IRQ pin is not checked while powered down
+	sim.writePowerDown(true);
+	CHECK(sim.selfTest() == AS3935MI::AS3935_SELF_TEST_POWERED_DOWN);
+	sim.writePowerDown(false);
+	CHECK(sim.calibrateRCO());
+
+	//too few edges within the timeout
+	sim.setRCOFrequencies(1100000.0, 1000.0);
+	uint64_t start = hostNanos();
+	CHECK(sim.selfTest() == AS3935MI::AS3935_SELF_TEST_IRQ);
+	CHECK(hostNanos() - start >= AS3935MI_SELF_TEST_TIMEOUT_US * 1000ull);
+	sim.setRCOFrequencies(1100000.0, 32768.0);
+	CHECK(sim.selfTest() == 0);
+
+	//no sensor on the bus
+	sim.pokeRegister(0x00, 0xFF);
+	CHECK(sim.selfTest() == AS3935MI::AS3935_SELF_TEST_CONNECTION);
+}
+
+int main()
+{
+	testPass();
+	testFailures();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+	return (failures_ == 0) ? 0 : 1;
+}
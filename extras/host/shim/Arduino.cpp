@@ -0,0 +1,299 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "Arduino.h"
+
+#include <stdio.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "ArduinoHost.h"
+
+#include "EEPROM.h"
+#include "SPI.h"
+#include "Wire.h"
+
+HardwareSerial Serial;
+TwoWire Wire;
+TwoWire Wire1;
+SPIClass SPI;
+EEPROMClass EEPROM;
+
+namespace
+{
+	struct pin_t
+	{
+		uint8_t mode;
+		uint8_t level;
+
+		int interrupt_mode;
+		void (*handler)();
+		void (*handler_arg)(void *);
+		void *arg;
+	};
+
+	pin_t pins_[NUM_DIGITAL_PINS] = {};
+
+	bool interrupts_enabled_ = true;
+
+	const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+	bool virtual_time_ = false;
+	uint64_t virtual_ns_ = 0;
+
+	//callbacks ordered by time. equal keys keep their insertion order.
+	std::multimap<uint64_t, std::function<void()> > scheduled_;
+
+	//pin level changes by hostWritePin(), for hostWaitForPin() in another thread
+	std::mutex pin_mutex_;
+	std::condition_variable pin_changed_;
+}
+
+unsigned long millis()
+{
+	return static_cast<unsigned long>(hostNanos() / 1000000ull);
+}
+
+unsigned long micros()
+{
+	return static_cast<unsigned long>(hostNanos() / 1000ull);
+}
+
+void delay(unsigned long ms)
+{
+	hostAdvanceTime(static_cast<uint64_t>(ms) * 1000000ull);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	hostAdvanceTime(static_cast<uint64_t>(us) * 1000ull);
+}
+
+void yield()
+{
+	std::this_thread::yield();
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	if (pin < NUM_DIGITAL_PINS)
+		pins_[pin].mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	if (pin < NUM_DIGITAL_PINS)
+		pins_[pin].level = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin)
+{
+	return (pin < NUM_DIGITAL_PINS) ? pins_[pin].level : LOW;
+}
+
+void attachInterrupt(int interrupt, void (*handler)(), int mode)
+{
+	if ((interrupt < 0) || (interrupt >= NUM_DIGITAL_PINS))
+		return;
+
+	pins_[interrupt].interrupt_mode = mode;
+	pins_[interrupt].handler = handler;
+	pins_[interrupt].handler_arg = nullptr;
+	pins_[interrupt].arg = nullptr;
+}
+
+#ifdef ARDUINO_HOST_HAS_ATTACHINTERRUPTARG
+void attachInterruptArg(int interrupt, void (*handler)(void *), void *arg, int mode)
+{
+	if ((interrupt < 0) || (interrupt >= NUM_DIGITAL_PINS))
+		return;
+
+	pins_[interrupt].interrupt_mode = mode;
+	pins_[interrupt].handler = nullptr;
+	pins_[interrupt].handler_arg = handler;
+	pins_[interrupt].arg = arg;
+}
+#endif
+
+void detachInterrupt(int interrupt)
+{
+	if ((interrupt < 0) || (interrupt >= NUM_DIGITAL_PINS))
+		return;
+
+	pins_[interrupt].handler = nullptr;
+	pins_[interrupt].handler_arg = nullptr;
+	pins_[interrupt].arg = nullptr;
+}
+
+void noInterrupts()
+{
+	interrupts_enabled_ = false;
+}
+
+void interrupts()
+{
+	interrupts_enabled_ = true;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+void hostWritePin(uint8_t pin, uint8_t value)
+{
+	if (pin >= NUM_DIGITAL_PINS)
+		return;
+
+	pin_t &p = pins_[pin];
+
+	const uint8_t level = value ? HIGH : LOW;
+	if (level == p.level)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(pin_mutex_);
+		p.level = level;
+	}
+	pin_changed_.notify_all();
+
+	if (!interrupts_enabled_)
+		return;
+
+	const bool trigger = (p.interrupt_mode == CHANGE) ||
+		((p.interrupt_mode == RISING) && (level == HIGH)) ||
+		((p.interrupt_mode == FALLING) && (level == LOW));
+
+	if (!trigger)
+		return;
+
+	if (p.handler)
+		p.handler();
+	else if (p.handler_arg)
+		p.handler_arg(p.arg);
+}
+
+void hostSetVirtualTime(bool enabled)
+{
+	if (enabled && !virtual_time_)
+		virtual_ns_ = hostNanos();
+
+	virtual_time_ = enabled;
+}
+
+bool hostIsVirtualTime()
+{
+	return virtual_time_;
+}
+
+uint64_t hostNanos()
+{
+	if (virtual_time_)
+		return virtual_ns_;
+
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+}
+
+void hostAdvanceTime(uint64_t ns)
+{
+	if (!virtual_time_)
+	{
+		std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+		return;
+	}
+
+	const uint64_t end = virtual_ns_ + ns;
+
+	while (!scheduled_.empty() && (scheduled_.begin()->first <= end))
+	{
+		std::multimap<uint64_t, std::function<void()> >::iterator next = scheduled_.begin();
+
+		if (next->first > virtual_ns_)
+			virtual_ns_ = next->first;
+
+		std::function<void()> callback = next->second;
+		scheduled_.erase(next);
+
+		callback();
+	}
+
+	virtual_ns_ = end;
+}
+
+bool hostWaitForPin(uint8_t pin, uint8_t level, uint64_t timeout_ns)
+{
+	if (pin >= NUM_DIGITAL_PINS)
+		return false;
+
+	const pin_t &p = pins_[pin];
+
+	if (!virtual_time_)
+	{
+		std::unique_lock<std::mutex> lock(pin_mutex_);
+		return pin_changed_.wait_for(lock, std::chrono::nanoseconds(timeout_ns), [&p, level]() { 
+			return p.level == level; 
+		});
+	}
+
+	const uint64_t end = virtual_ns_ + timeout_ns;
+
+	//advance to the next callback until one of them has set the pin
+	while (p.level != level)
+	{
+		if (scheduled_.empty() || (scheduled_.begin()->first > end))
+		{
+			virtual_ns_ = end;
+			return false;
+		}
+
+		const uint64_t next = scheduled_.begin()->first;
+		hostAdvanceTime((next > virtual_ns_) ? next - virtual_ns_ : 0);
+	}
+
+	return true;
+}
+
+void hostSchedule(uint64_t time_ns, std::function<void()> callback)
+{
+	scheduled_.insert(std::make_pair(time_ns, callback));
+}
+
+void hostResetTime()
+{
+	scheduled_.clear();
+	virtual_ns_ = 0;
+}
+
+void HardwareSerial::flush()
+{
+	fflush(stdout);
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+	return (fputc(value, stdout) == EOF) ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *data, size_t length)
+{
+	return fwrite(data, 1, length, stdout);
+}
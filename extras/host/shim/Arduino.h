@@ -0,0 +1,110 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// minimal Arduino core stand-in used to build and test the library on a Linux host. 
+// only the functionality used by the library and its examples is provided. 
+
+#ifndef ARDUINO_H_
+#define ARDUINO_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARDUINO_ARCH_HOST
+
+// like ESP8266 and ESP32 the host core provides attachInterruptArg(). define ARDUINO_HOST_NO_ATTACHINTERRUPTARG to 
+// build like a core without it (e.g. AVR), which uses the static interrupt state of the library.
+#ifndef ARDUINO_HOST_NO_ATTACHINTERRUPTARG
+#define ARDUINO_HOST_HAS_ATTACHINTERRUPTARG
+#endif
+
+#ifndef F_CPU
+#define F_CPU 240000000UL
+#endif
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+
+#define NUM_DIGITAL_PINS 64
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+inline int digitalPinToInterrupt(uint8_t pin) { return (pin < NUM_DIGITAL_PINS) ? pin : -1; }
+
+void attachInterrupt(int interrupt, void (*handler)(), int mode);
+#ifdef ARDUINO_HOST_HAS_ATTACHINTERRUPTARG
+void attachInterruptArg(int interrupt, void (*handler)(void *), void *arg, int mode);
+#endif
+void detachInterrupt(int interrupt);
+
+void noInterrupts();
+void interrupts();
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+/*
+host only: drives an input pin from outside of the sketch, e.g. from a simulated sensor. 
+calls the interrupt handler attached to the pin if the level change matches the interrupt mode.
+@param pin pin to drive.
+@param value new level of the pin, HIGH or LOW. */
+void hostWritePin(uint8_t pin, uint8_t value);
+
+#include "Print.h"
+
+class HardwareSerial : public Print
+{
+public:
+	void begin(unsigned long baud) { (void)baud; }
+	void end() {}
+	int available() { return 0; }
+	int read() { return -1; }
+	void flush();
+	size_t write(uint8_t value);
+	size_t write(const uint8_t *data, size_t length);
+	using Print::write;
+	operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif /* ARDUINO_H_ */
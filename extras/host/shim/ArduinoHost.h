@@ -0,0 +1,71 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// host only extensions of the Arduino core stand-in, used by simulated devices and test harnesses. 
+
+#ifndef ARDUINOHOST_H_
+#define ARDUINOHOST_H_
+
+#include <Arduino.h>
+
+#include <functional>
+
+/*
+enables or disables virtual time. with virtual time, millis() and micros() only advance when delay(),
+delayMicroseconds() or hostAdvanceTime() are called, and delays return immediately after running all
+callbacks scheduled until the end of the delay. disabled by default. 
+@param enabled true to enable virtual time, false to use the system's steady clock. */
+void hostSetVirtualTime(bool enabled);
+
+/*
+@return true if virtual time is enabled, false otherwise. */
+bool hostIsVirtualTime();
+
+/*
+@return current time in nanoseconds. */
+uint64_t hostNanos();
+
+/*
+advances the virtual time, running all callbacks scheduled until the new time in order. 
+sleeps if virtual time is disabled.
+@param ns time to advance in nanoseconds. */
+void hostAdvanceTime(uint64_t ns);
+
+/*
+schedules a callback to run when the virtual time reaches the given time. callbacks scheduled for the
+same time run in the order they were scheduled. callbacks may schedule further callbacks. 
+@param time_ns time to run the callback at in nanoseconds. callbacks scheduled in the past run on the next advance.
+@param callback function to call. */
+void hostSchedule(uint64_t time_ns, std::function<void()> callback);
+
+/*
+waits until a pin has the given level, e.g. set by hostWritePin() from a simulated device, standing in for an MCU 
+sleep mode left by a pin interrupt. with virtual time, runs the scheduled callbacks until the pin has the level or the 
+timeout has passed, and advances the time to the end of the wait. otherwise waits on a condition variable notified by 
+hostWritePin(), which may be called from another thread. 
+@param pin pin to watch.
+@param level level to wait for, HIGH or LOW.
+@param timeout_ns maximum time to wait in nanoseconds.
+@return true if the pin has the level, false on timeout. */
+bool hostWaitForPin(uint8_t pin, uint8_t level, uint64_t timeout_ns);
+
+/*
+removes all scheduled callbacks and resets the virtual time to 0. */
+void hostResetTime();
+
+#endif /* ARDUINOHOST_H_ */
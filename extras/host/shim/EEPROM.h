@@ -0,0 +1,41 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include <Arduino.h>
+
+//stand-in for the Arduino EEPROM library, backed by RAM. 
+class EEPROMClass
+{
+public:
+	EEPROMClass() { memset(data_, 0xFF, sizeof(data_)); }
+
+	uint8_t read(int address) const { return ((address >= 0) && (address < static_cast<int>(sizeof(data_)))) ? data_[address] : 0xFF; }
+	void write(int address, uint8_t value) { if ((address >= 0) && (address < static_cast<int>(sizeof(data_)))) data_[address] = value; }
+	void update(int address, uint8_t value) { if (read(address) != value) write(address, value); }
+	uint16_t length() const { return sizeof(data_); }
+
+private:
+	uint8_t data_[4096];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif /* EEPROM_H_ */
@@ -0,0 +1,151 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "Print.h"
+
+#include <math.h>
+#include <string.h>
+
+size_t Print::write(const uint8_t *data, size_t length)
+{
+	size_t written = 0;
+	while (length--)
+		written += write(*data++);
+	return written;
+}
+
+size_t Print::write(const char *str)
+{
+	return str ? write(reinterpret_cast<const uint8_t *>(str), strlen(str)) : 0;
+}
+
+size_t Print::print(const char *str)
+{
+	return write(str);
+}
+
+size_t Print::print(char value)
+{
+	return write(static_cast<uint8_t>(value));
+}
+
+size_t Print::print(unsigned char value, int base)
+{
+	return printNumber(value, base, false);
+}
+
+size_t Print::print(int value, int base)
+{
+	return print(static_cast<long long>(value), base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+	return printNumber(value, base, false);
+}
+
+size_t Print::print(long value, int base)
+{
+	return print(static_cast<long long>(value), base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+	return printNumber(value, base, false);
+}
+
+size_t Print::print(long long value, int base)
+{
+	//like the Arduino core, only decimal numbers are printed with a sign
+	if ((base == DEC) && (value < 0))
+		return printNumber(0ull - static_cast<unsigned long long>(value), base, true);
+
+	return printNumber(static_cast<unsigned long long>(value), base, false);
+}
+
+size_t Print::print(unsigned long long value, int base)
+{
+	return printNumber(value, base, false);
+}
+
+size_t Print::print(double value, int digits)
+{
+	if (isnan(value))
+		return print("nan");
+	if (isinf(value))
+		return print("inf");
+
+	size_t written = 0;
+
+	if (value < 0.0)
+	{
+		written += print('-');
+		value = -value;
+	}
+
+	//round to the requested number of digits
+	double rounding = 0.5;
+	for (int i = 0; i < digits; i++)
+		rounding /= 10.0;
+	value += rounding;
+
+	const unsigned long long integer = static_cast<unsigned long long>(value);
+	double fraction = value - static_cast<double>(integer);
+
+	written += printNumber(integer, DEC, false);
+
+	if (digits > 0)
+		written += print('.');
+
+	while (digits-- > 0)
+	{
+		fraction *= 10.0;
+		const unsigned int digit = static_cast<unsigned int>(fraction);
+		written += print(static_cast<char>('0' + digit));
+		fraction -= digit;
+	}
+
+	return written;
+}
+
+size_t Print::println()
+{
+	return write(reinterpret_cast<const uint8_t *>("\r\n"), 2);
+}
+
+size_t Print::printNumber(unsigned long long value, int base, bool negative)
+{
+	if (base < 2)
+		base = DEC;
+
+	char buffer[8 * sizeof(value) + 2];
+	char *str = &buffer[sizeof(buffer) - 1];
+	*str = '\0';
+
+	do
+	{
+		const unsigned int digit = static_cast<unsigned int>(value % base);
+		value /= base;
+		*--str = static_cast<char>((digit < 10) ? '0' + digit : 'A' + digit - 10);
+	} while (value);
+
+	if (negative)
+		*--str = '-';
+
+	return write(str);
+}
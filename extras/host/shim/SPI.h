@@ -0,0 +1,76 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef SPI_H_
+#define SPI_H_
+
+#include <Arduino.h>
+
+#include <functional>
+
+#define MSBFIRST 1
+#define LSBFIRST 0
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings
+{
+public:
+	SPISettings() : clock_(4000000), bit_order_(MSBFIRST), data_mode_(SPI_MODE0) {}
+	SPISettings(uint32_t clock, uint8_t bit_order, uint8_t data_mode) : clock_(clock), bit_order_(bit_order), data_mode_(data_mode) {}
+
+	uint32_t clock_;
+	uint8_t bit_order_;
+	uint8_t data_mode_;
+};
+
+//stand-in for the Arduino SPIClass. transferred bytes are forwarded to a handler, so a simulated device 
+//can be attached to the bus. without a handler, transfer() returns 0. 
+class SPIClass
+{
+public:
+	typedef std::function<uint8_t(uint8_t value)> transfer_handler_t;
+
+	void begin() {}
+	void end() {}
+
+	void beginTransaction(const SPISettings &settings) { settings_ = settings; }
+	void endTransaction() {}
+
+	void setBitOrder(uint8_t bit_order) { settings_.bit_order_ = bit_order; }
+	void setDataMode(uint8_t data_mode) { settings_.data_mode_ = data_mode; }
+	void setFrequency(uint32_t frequency) { settings_.clock_ = frequency; }
+
+	uint8_t transfer(uint8_t value) { return transfer_handler_ ? transfer_handler_(value) : 0; }
+
+	/*
+	host only: sets the handler simulated devices are accessed through. the handler is called for each 
+	transferred byte, chip select is available through digitalRead(). */
+	void setHandler(transfer_handler_t handler) { transfer_handler_ = handler; }
+
+private:
+	SPISettings settings_;
+	transfer_handler_t transfer_handler_;
+};
+
+extern SPIClass SPI;
+
+#endif /* SPI_H_ */
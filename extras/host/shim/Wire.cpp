@@ -0,0 +1,81 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "Wire.h"
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+	address_ = address;
+	tx_length_ = 0;
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+	if (tx_length_ >= sizeof(tx_buffer_))
+		return 0;
+
+	tx_buffer_[tx_length_++] = value;
+	return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length)
+{
+	size_t written = 0;
+	while ((written < length) && write(data[written]))
+		written++;
+	return written;
+}
+
+uint8_t TwoWire::endTransmission(bool stop)
+{
+	(void)stop;
+
+	const uint8_t result = write_handler_ ? write_handler_(address_, tx_buffer_, tx_length_) : 0;
+	tx_length_ = 0;
+
+	return result;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool stop)
+{
+	(void)stop;
+
+	if (quantity > sizeof(rx_buffer_))
+		quantity = sizeof(rx_buffer_);
+
+	rx_index_ = 0;
+	rx_length_ = read_handler_ ? read_handler_(address, rx_buffer_, quantity) : 0;
+
+	return static_cast<uint8_t>(rx_length_);
+}
+
+int TwoWire::available()
+{
+	return static_cast<int>(rx_length_ - rx_index_);
+}
+
+int TwoWire::read()
+{
+	return (rx_index_ < rx_length_) ? rx_buffer_[rx_index_++] : -1;
+}
+
+void TwoWire::setHandlers(write_handler_t write_handler, read_handler_t read_handler)
+{
+	write_handler_ = write_handler;
+	read_handler_ = read_handler;
+}
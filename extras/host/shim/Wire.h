@@ -0,0 +1,70 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef WIRE_H_
+#define WIRE_H_
+
+#include <Arduino.h>
+
+#include <functional>
+
+//stand-in for the Arduino TwoWire class. transfers are forwarded to handlers, so a simulated device can
+//be attached to the bus. without handlers, writes are acknowledged and reads return 0xFF. 
+class TwoWire
+{
+public:
+	//called when a write transfer completes. @return 0 on success, an Arduino endTransmission() error code otherwise.
+	typedef std::function<uint8_t(uint8_t address, const uint8_t *data, size_t length)> write_handler_t;
+
+	//called when data is requested. @return number of bytes provided in data.
+	typedef std::function<size_t(uint8_t address, uint8_t *data, size_t length)> read_handler_t;
+
+	void begin() {}
+	void begin(int sda, int scl) { (void)sda; (void)scl; }
+	void setClock(uint32_t frequency) { (void)frequency; }
+
+	void beginTransmission(uint8_t address);
+	size_t write(uint8_t value);
+	size_t write(const uint8_t *data, size_t length);
+	uint8_t endTransmission(bool stop = true);
+
+	uint8_t requestFrom(uint8_t address, uint8_t quantity, bool stop = true);
+	uint8_t requestFrom(int address, int quantity, int stop = 1) { return requestFrom(static_cast<uint8_t>(address), static_cast<uint8_t>(quantity), stop != 0); }
+	int available();
+	int read();
+
+	/*
+	host only: sets the handlers simulated devices are accessed through. */
+	void setHandlers(write_handler_t write_handler, read_handler_t read_handler);
+
+private:
+	uint8_t address_ = 0;
+	uint8_t tx_buffer_[32];
+	size_t tx_length_ = 0;
+	uint8_t rx_buffer_[32];
+	size_t rx_length_ = 0;
+	size_t rx_index_ = 0;
+
+	write_handler_t write_handler_;
+	read_handler_t read_handler_;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif /* WIRE_H_ */
@@ -0,0 +1,172 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// sim_test.cpp
+//
+// regression test of the driver against the simulated sensor. runs in virtual time.
+
+#include <stdio.h>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+#define PIN_IRQ 2
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//tuning capacitor setting with the resonance frequency closest to 500kHz
+static uint8_t bestTuning(const AS3935Sim &sim)
+{
+	uint8_t best = 0;
+	for (uint8_t i = 1; i < 16; i++)
+	{
+		if (fabs(sim.getResonanceFrequency(i) - 500000.0) < fabs(sim.getResonanceFrequency(best) - 500000.0))
+			best = i;
+	}
+	return best;
+}
+
+static void testBegin()
+{
+	AS3935Sim sim(PIN_IRQ);
+
+	CHECK(sim.begin());
+	CHECK(sim.checkConnection());
+	CHECK(sim.readAFE() == AS3935MI::AS3935_INDOORS);
+	CHECK(sim.readNoiseFloorThreshold() == AS3935MI::AS3935_NFL_2);
+	CHECK(sim.readStormDistance() == AS3935MI::AS3935_DST_OOR);
+	CHECK(!sim.readPowerDown());
+
+	sim.writeAFE(AS3935MI::AS3935_OUTDOORS);
+	CHECK(sim.readAFE() == AS3935MI::AS3935_OUTDOORS);
+
+	sim.resetToDefaults();
+	CHECK(sim.readAFE() == AS3935MI::AS3935_INDOORS);
+}
+
+static void testCalibration(bool nak, bool calibrate_all)
+{
+	AS3935Sim sim(PIN_IRQ);
+	sim.setNakWhileDisplaying(nak);
+	sim.setCalibrateAllAntCap(calibrate_all);
+
+	CHECK(sim.begin());
+	CHECK(sim.checkIRQ());
+
+	int32_t frequency = 0;
+	CHECK(sim.calibrateResonanceFrequency(frequency));
+
+	const uint8_t expected = bestTuning(sim);
+	CHECK(sim.getCalibratedAntCap() == expected);
+	CHECK(sim.readAntennaTuning() == expected);
+
+	//the measured frequency must be within 0.5% of the simulated frequency
+	CHECK(fabs(frequency - sim.getResonanceFrequency(expected)) < 2500.0);
+
+	CHECK(sim.calibrateRCO());
+
+	sim.setRCOCalibrationFailure(true);
+	CHECK(!sim.calibrateRCO());
+}
+
+static void testDetuned()
+{
+	AS3935Sim sim(PIN_IRQ);
+
+	//resonance frequency can not be tuned to within 3.5% of 500kHz
+	sim.setAntenna(100.0, 1300.0);
+
+	CHECK(sim.begin());
+
+	int32_t frequency = 0;
+	CHECK(!sim.calibrateResonanceFrequency(frequency));
+	CHECK(sim.getCalibratedAntCap() == 0);
+}
+
+static void testEvents()
+{
+	AS3935Sim sim(PIN_IRQ);
+
+	CHECK(sim.begin());
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	delay(100);
+	const uint32_t timestamp = millis();
+	sim.injectLightning(0x12345, 14);
+	CHECK(sim.getInterruptTimestamp() == timestamp);
+
+	delay(2);
+	AS3935Event event;
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.timestamp == timestamp);
+	CHECK(event.energy == 0x12345);
+	CHECK(event.distance == 14);
+	CHECK(digitalRead(PIN_IRQ) == LOW);
+
+	sim.injectDisturber();
+	CHECK(sim.readInterruptSource() == AS3935MI::AS3935_INT_D);
+
+	sim.writeMaskDisturbers(true);
+	sim.injectDisturber();
+	CHECK(sim.readInterruptSource() == 0);
+
+	sim.injectNoise();
+	sim.injectNoise();
+	CHECK(sim.getLostInterrupts() == 1);
+	CHECK(sim.readInterruptSource() == AS3935MI::AS3935_INT_NH);
+
+	//distance updates have interrupt source 0, reading it still clears the interrupt
+	sim.injectDistanceUpdate(20);
+	CHECK(digitalRead(PIN_IRQ) == HIGH);
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_DUPDATE);
+	CHECK(event.distance == 20);
+	CHECK(digitalRead(PIN_IRQ) == LOW);
+
+	sim.injectDistanceUpdate(25);
+	sim.injectDistanceUpdate(30);
+	CHECK(sim.getLostInterrupts() == 2);
+	CHECK(sim.readInterruptSource() == AS3935MI::AS3935_INT_DUPDATE);
+	CHECK(digitalRead(PIN_IRQ) == LOW);
+
+	sim.writePowerDown(true);
+	sim.injectLightning(1, 1);
+	CHECK(sim.readInterruptSource() == 0);
+}
+
+int main()
+{
+	testBegin();
+	testCalibration(false, true);
+	testCalibration(false, false);
+	testCalibration(true, true);
+	testDetuned();
+	testEvents();
+
+	printf("virtual time: %lu ms\n", millis());
+	printf("result: %s\n", (failures_ == 0) ? "pass" : "fail");
+
+	return (failures_ == 0) ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// sketch_main.cpp
+//
+// builds an example sketch on the host. the sketch is included as AS3935MI_SKETCH and run by calling 
+// setup() once and loop() AS3935MI_SKETCH_LOOPS times.
+
+#include <Arduino.h>
+
+#ifndef AS3935MI_SKETCH_LOOPS
+#define AS3935MI_SKETCH_LOOPS 0
+#endif
+
+//the Arduino IDE generates prototypes for all functions of a sketch, do the same for the interrupt service routine
+void AS3935ISR();
+
+#include AS3935MI_SKETCH
+
+int main()
+{
+	setup();
+
+	for (unsigned long i = 0; i != AS3935MI_SKETCH_LOOPS; i++)
+		loop();
+
+	Serial.flush();
+
+	return 0;
+}
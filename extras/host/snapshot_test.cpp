@@ -0,0 +1,252 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// snapshot_test.cpp
+//
+// test of readSnapshot(), diff() and restore() on a simulated sensor and of the burst reads of the I2C and SPI buses.
+
+#include <stdio.h>
+
+#include "AS3935SPIClass.h"
+#include "AS3935Sim.h"
+#include "AS3935TwoWire.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//duration of a register access on a 100 kHz I2C bus
+static const uint32_t ACCESS_NS = 300000;
+
+static bool matches(const AS3935Sim &sim, const AS3935MI::register_snapshot_t &snapshot)
+{
+	for (uint8_t i = 0; i < 9; i++)
+	{
+		if (snapshot.registers[i] != sim.peekRegister(i))
+			return false;
+	}
+
+	return (snapshot.registers[9] == sim.peekRegister(0x3A)) && (snapshot.registers[10] == sim.peekRegister(0x3B));
+}
+
+//a snapshot takes two bus transactions instead of one per getter
+static void testSnapshot()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	sim.setBusTiming(ACCESS_NS, ACCESS_NS);
+	CHECK(sim.begin());
+	CHECK(sim.calibrateRCO());
+	sim.writeAntennaTuning(5);
+
+	const uint32_t reads = sim.getRegisterReads();
+	const uint32_t bursts = sim.getBurstReads();
+	uint32_t start = micros();
+
+	AS3935MI::register_snapshot_t snapshot;
+	CHECK(sim.readSnapshot(snapshot));
+
+	const uint32_t snapshot_usec = micros() - start;
+	CHECK(sim.getBurstReads() - bursts == 2);
+	CHECK(sim.getRegisterReads() - reads == AS3935MI::AS3935_SNAPSHOT_SIZE);
+	CHECK(matches(sim, snapshot));
+	CHECK(snapshot.registers[0x08] == 5);
+	CHECK(snapshot.registers[9] == 0x80);
+
+	//the same information with the getters
+	start = micros();
+	sim.readAFE();
+	sim.readPowerDown();
+	sim.readNoiseFloorThreshold();
+	sim.readWatchdogThreshold();
+	sim.readMinLightnings();
+	sim.readSpikeRejection();
+	sim.readDivisionRatio();
+	sim.readMaskDisturbers();
+	sim.readInterruptSource();
+	sim.readEnergy();
+	sim.readStormDistance();
+	sim.readAntennaTuning();
+	const uint32_t getters_usec = micros() - start;
+
+	printf("snapshot: %u us, getters: %u us\n", snapshot_usec, getters_usec);
+	CHECK(snapshot_usec * 3 < getters_usec);
+
+	//a pending interrupt is cleared and contained in the snapshot
+	sim.injectLightning(0x12345, 17);
+	CHECK(sim.readSnapshot(snapshot));
+	CHECK((snapshot.registers[0x03] & 0x0F) == AS3935MI::AS3935_INT_L);
+	CHECK(snapshot.registers[0x04] == 0x45);
+	CHECK(snapshot.registers[0x07] == 17);
+	CHECK((sim.peekRegister(0x03) & 0x0F) == 0);
+}
+
+//diff() reports the changed fields only
+static void testDiff()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+
+	AS3935MI::register_snapshot_t before;
+	AS3935MI::register_snapshot_t after;
+	CHECK(sim.readSnapshot(before));
+	CHECK(sim.readSnapshot(after));
+	CHECK(AS3935MI::diff(before, after) == 0);
+
+	sim.writeAFE(AS3935MI::AS3935_OUTDOORS);
+	sim.writeWatchdogThreshold(AS3935MI::AS3935_WDTH_7);
+	sim.writeMaskDisturbers(true);
+	sim.writeAntennaTuning(9);
+	CHECK(sim.calibrateRCO());
+	sim.injectLightning(1000, 20);
+
+	CHECK(sim.readSnapshot(after));
+	CHECK(AS3935MI::diff(before, after) == (AS3935MI::AS3935_FIELD_AFE_GB | AS3935MI::AS3935_FIELD_WDTH | 
+		AS3935MI::AS3935_FIELD_MASK_DIST | AS3935MI::AS3935_FIELD_INT | AS3935MI::AS3935_FIELD_ENERGY | 
+		AS3935MI::AS3935_FIELD_DISTANCE | AS3935MI::AS3935_FIELD_TUN_CAP | AS3935MI::AS3935_FIELD_RCO_CALIBRATION));
+	CHECK(AS3935MI::diff(after, before) == AS3935MI::diff(before, after));
+
+	sim.writePowerDown(true);
+	CHECK(sim.readSnapshot(before));
+	CHECK(AS3935MI::diff(before, after) == (AS3935MI::AS3935_FIELD_PWD | AS3935MI::AS3935_FIELD_INT));
+}
+
+//restore() writes the differing configuration registers once and nothing else
+static void testRestore()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+	sim.writeAFE(AS3935MI::AS3935_OUTDOORS);
+	sim.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_5);
+	sim.writeSpikeRejection(AS3935MI::AS3935_SREJ_7);
+	sim.writeAntennaTuning(11);
+
+	AS3935MI::register_snapshot_t snapshot;
+	CHECK(sim.readSnapshot(snapshot));
+
+	//nothing to restore
+	uint32_t writes = sim.getRegisterWrites();
+	uint32_t bursts = sim.getBurstReads();
+	CHECK(sim.restore(snapshot) == 0);
+	CHECK(sim.getRegisterWrites() == writes);
+	CHECK(sim.getBurstReads() - bursts == 1);
+
+	//read only fields are not restored
+	sim.injectLightning(5000, 30);
+	CHECK(sim.restore(snapshot) == 0);
+	CHECK(sim.getRegisterWrites() == writes);
+
+	//reset to defaults: registers 0x00, 0x01, 0x02 and 0x08 differ, 0x03 does not
+	sim.resetToDefaults();
+	writes = sim.getRegisterWrites();
+	CHECK(sim.restore(snapshot) == 4);
+	CHECK(sim.getRegisterWrites() - writes == 4);
+	CHECK(sim.readAFE() == AS3935MI::AS3935_OUTDOORS);
+	CHECK(sim.readNoiseFloorThreshold() == AS3935MI::AS3935_NFL_5);
+	CHECK(sim.readSpikeRejection() == AS3935MI::AS3935_SREJ_7);
+	CHECK(sim.readAntennaTuning() == 11);
+
+	AS3935MI::register_snapshot_t restored;
+	CHECK(sim.readSnapshot(restored));
+	CHECK((AS3935MI::diff(snapshot, restored) & ~(AS3935MI::AS3935_FIELD_INT | AS3935MI::AS3935_FIELD_ENERGY | 
+		AS3935MI::AS3935_FIELD_DISTANCE)) == 0);
+}
+
+//register file of a sensor on the I2C and SPI bus stand-ins, incrementing the register address on reads
+static uint8_t registers_[0x40];
+static uint8_t pointer_ = 0;
+static uint32_t transfers_ = 0;
+
+static void testBuses()
+{
+	for (uint8_t i = 0; i < sizeof(registers_); i++)
+		registers_[i] = i * 7;
+
+	Wire.setHandlers(
+		[](uint8_t, const uint8_t *data, size_t length) -> uint8_t {
+			transfers_++;
+			pointer_ = data[0];
+			if (length == 2)
+				registers_[data[0]] = data[1];
+			return 0;
+		},
+		[](uint8_t, uint8_t *data, size_t length) -> size_t {
+			transfers_++;
+			for (size_t i = 0; i < length; i++)
+				data[i] = registers_[(pointer_ + i) % sizeof(registers_)];
+			return length;
+		});
+
+	AS3935TwoWire i2c(&Wire, AS3935TwoWire::AS3935I2C_A01, AS3935MI::AS3935_NO_IRQ);
+	AS3935MI::register_snapshot_t snapshot;
+	transfers_ = 0;
+	CHECK(i2c.readSnapshot(snapshot));
+	CHECK(transfers_ == 4);
+	CHECK(snapshot.registers[0] == 0);
+	CHECK(snapshot.registers[8] == 56);
+	CHECK(snapshot.registers[9] == static_cast<uint8_t>(0x3A * 7));
+	CHECK(snapshot.registers[10] == static_cast<uint8_t>(0x3B * 7));
+
+	Wire.setHandlers(nullptr, nullptr);
+
+	//SPI: a read command selects the register with bit 6 set, zeros are sent while reading
+	static uint8_t spi_pointer = 0;
+	SPI.setHandler([](uint8_t value) -> uint8_t {
+		if (value & 0x40)
+		{
+			transfers_++;
+			spi_pointer = value & 0x3F;
+			return 0;
+		}
+		return registers_[spi_pointer++ % sizeof(registers_)];
+	});
+
+	AS3935SPIClass spi(&SPI, 10, AS3935MI::AS3935_NO_IRQ);
+	transfers_ = 0;
+	CHECK(spi.readSnapshot(snapshot));
+	CHECK(transfers_ == 2);
+	CHECK(snapshot.registers[1] == 7);
+	CHECK(snapshot.registers[8] == 56);
+	CHECK(snapshot.registers[10] == static_cast<uint8_t>(0x3B * 7));
+
+	SPI.setHandler(nullptr);
+}
+
+int main()
+{
+	testSnapshot();
+	testDiff();
+	testRestore();
+	testBuses();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+
+	return (failures_ == 0) ? 0 : 1;
+}
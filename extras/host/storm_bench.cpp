@@ -0,0 +1,220 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// storm_bench.cpp
+//
+// measures how many events per second the driver and an interrupt handler modelled after the examples can 
+// sustain. synthetic storms (AS3935Workload) are injected into the simulated sensor at increasing rates, the 
+// handler waits 2ms after each interrupt as required by the datasheet and reads the event with readEvent(). 
+// every register access is charged the duration of a transaction on the selected bus in virtual time. 
+//
+// prints one JSON object per pattern and rate: injected and decoded events, drop rate, latency from the 
+// injection to the decoded event and bus utilization. 
+//
+//   storm_bench [--bus i2c_100k|i2c_400k|spi_2m] [--handler-us N] [--check]
+//
+// with --check, fails if the accounting is inconsistent or events are lost in Poisson storms of 1 event per second 
+// or less.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "AS3935Workload.h"
+#include "ArduinoHost.h"
+
+#ifndef AS3935MI_ENABLE_BUS_STATISTICS
+#error "storm_bench must be built with AS3935MI_ENABLE_BUS_STATISTICS"
+#endif
+
+#define PIN_IRQ 2
+
+namespace
+{
+	struct bus_t
+	{
+		const char *name;
+		uint32_t read_ns;
+		uint32_t write_ns;
+	};
+
+	//see bench_as3935.cpp
+	const bus_t buses[] = {
+		{ "i2c_100k", 390000, 290000 },
+		{ "i2c_400k", 97500, 72500 },
+		{ "spi_2m", 9000, 9000 },
+	};
+
+	const double rates[] = { 0.5, 1, 2, 5, 10, 20, 50, 100, 200, 400 };
+
+	//time the main loop sleeps when no interrupt is pending
+	const uint64_t POLL_NS = 20000;
+
+	volatile bool interrupt_ = false;
+
+	void AS3935ISR()
+	{
+		interrupt_ = true;
+	}
+
+	//returns false if the accounting is inconsistent or events are lost in slow Poisson storms
+	bool run(const bus_t &bus, AS3935Workload::pattern_t pattern, double rate, uint32_t handler_us)
+	{
+		hostResetTime();
+		interrupt_ = false;
+
+		AS3935Sim sim(PIN_IRQ);
+		sim.setBusTiming(bus.read_ns, bus.write_ns);
+
+		sim.begin();
+		sim.writeAFE(AS3935MI::AS3935_INDOORS);
+		sim.writeMaskDisturbers(false);
+		attachInterrupt(digitalPinToInterrupt(PIN_IRQ), AS3935ISR, RISING);
+
+		//60% lightnings, 30% disturbers, 10% noise, at least 2000 events or 10 seconds
+		AS3935Workload::config_t config = AS3935Workload::defaultConfig();
+		config.pattern = pattern;
+		config.lightning_rate = rate * 0.6;
+		config.disturber_rate = rate * 0.3;
+		config.noise_rate = rate * 0.1;
+		config.duration = std::min(120.0, std::max(10.0, 2000.0 / rate));
+
+		AS3935Workload workload(sim, config);
+
+		uint64_t injected_ns = 0;
+		workload.setCallback([&injected_ns](uint8_t, uint64_t time_ns) {
+			injected_ns = time_ns;
+		});
+
+		std::vector<double> latencies;
+		uint32_t decoded = 0;
+
+		sim.resetBusStatistics();
+		workload.start();
+
+		//run until all events have been handled
+		const uint64_t end = workload.getEndTime() + 100000000ull;
+		while (hostNanos() < end)
+		{
+			if (!interrupt_)
+			{
+				hostAdvanceTime(POLL_NS);
+				continue;
+			}
+
+			//the datasheet requires waiting 2ms after the IRQ pin has been pulled high
+			delay(2);
+			interrupt_ = false;
+
+			//the interrupt of an event already read with the previous interrupt reads as distance update
+			AS3935Event event;
+			if (sim.readEvent(event) == AS3935MI::AS3935_INT_DUPDATE)
+				continue;
+
+			if (handler_us)
+				delayMicroseconds(handler_us);
+
+			decoded++;
+			latencies.push_back((hostNanos() - injected_ns) / 1000.0);
+		}
+
+		const AS3935MI::bus_statistics_t statistics = sim.getBusStatistics();
+		detachInterrupt(digitalPinToInterrupt(PIN_IRQ));
+
+		std::sort(latencies.begin(), latencies.end());
+		double mean = 0.0;
+		for (double latency : latencies)
+			mean += latency;
+		if (!latencies.empty())
+			mean /= latencies.size();
+
+		const double p99 = latencies.empty() ? 0.0 : latencies[(latencies.size() * 99) / 100];
+		const double max = latencies.empty() ? 0.0 : latencies.back();
+
+		const uint32_t injected = workload.getInjected();
+		const double drop_rate = injected ? static_cast<double>(injected - decoded) / injected : 0.0;
+
+		printf("{\"bus\":\"%s\",\"pattern\":\"%s\",\"rate\":%.1f,\"duration_s\":%.1f,\"injected\":%lu,\"decoded\":%lu,"
+			"\"lost\":%lu,\"drop_rate\":%.4f,\"latency_mean_us\":%.0f,\"latency_p99_us\":%.0f,\"latency_max_us\":%.0f,"
+			"\"bus_utilization\":%.4f}\n",
+			bus.name, (pattern == AS3935Workload::AS3935WORKLOAD_POISSON) ? "poisson" : "bursty", rate, config.duration,
+			static_cast<unsigned long>(injected), static_cast<unsigned long>(decoded),
+			static_cast<unsigned long>(sim.getLostInterrupts()), drop_rate, mean, p99, max,
+			statistics.duration_usec ? static_cast<double>(statistics.bus_usec) / statistics.duration_usec : 0.0);
+
+		//every injected event is either decoded or overwritten by a later event
+		bool ok = (decoded + sim.getLostInterrupts() == injected);
+		if ((pattern == AS3935Workload::AS3935WORKLOAD_POISSON) && (rate <= 1.0) && (decoded != injected))
+			ok = false;
+
+		return ok;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const bus_t *bus = &buses[1];
+	uint32_t handler_us = 0;
+	bool check = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--check"))
+			check = true;
+		else if (!strcmp(argv[i], "--handler-us") && (i + 1 < argc))
+			handler_us = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--bus") && (i + 1 < argc))
+		{
+			const char *name = argv[++i];
+			bus = nullptr;
+			for (const bus_t &candidate : buses)
+			{
+				if (!strcmp(candidate.name, name))
+					bus = &candidate;
+			}
+			if (!bus)
+			{
+				fprintf(stderr, "unknown bus %s\n", name);
+				return 2;
+			}
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--bus i2c_100k|i2c_400k|spi_2m] [--handler-us N] [--check]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool ok = true;
+	for (AS3935Workload::pattern_t pattern : { AS3935Workload::AS3935WORKLOAD_POISSON, AS3935Workload::AS3935WORKLOAD_BURSTY })
+	{
+		for (double rate : rates)
+			ok &= run(*bus, pattern, rate, handler_us);
+	}
+
+	if (check && !ok)
+	{
+		fprintf(stderr, "check failed\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// stream_decode.cpp
+//
+// host side decoder for frames created by AS3935Stream. reads the raw byte stream (e.g. a serial port 
+// or a capture file) from stdin and prints one JSON object per decoded frame to stdout. 
+//
+//   g++ -std=c++11 -O2 -I../../src stream_decode.cpp ../../src/AS3935Stream.cpp ../../src/AS3935CRC.cpp -o stream_decode
+//   stty -F /dev/ttyUSB0 9600 raw && ./stream_decode < /dev/ttyUSB0
+
+#include <stdio.h>
+
+#include "AS3935Stream.h"
+
+int main()
+{
+	uint8_t buffer[512];
+	AS3935StreamDecoder decoder(buffer, sizeof(buffer));
+
+	int c = 0;
+	while ((c = getchar()) != EOF)
+	{
+		if (!decoder.push(static_cast<uint8_t>(c)))
+			continue;
+
+		switch (decoder.type())
+		{
+		case AS3935Stream::AS3935_FRAME_EVENT:
+		{
+			AS3935Event event;
+			if (decoder.decodeEvent(event))
+				printf("{\"type\":\"event\",\"timestamp\":%u,\"source\":%u,\"energy\":%u,\"distance\":%u}\n",
+					event.timestamp, event.source, event.energy, event.distance);
+			break;
+		}
+		case AS3935Stream::AS3935_FRAME_CALIBRATION:
+		{
+			int8_t ant_cap = -1;
+			int32_t frequencies[16];
+			uint8_t count = 16;
+			if (decoder.decodeCalibration(ant_cap, frequencies, count))
+			{
+				printf("{\"type\":\"calibration\",\"ant_cap\":%d,\"frequencies\":[", ant_cap);
+				for (uint8_t i = 0; i < count; i++)
+					printf("%s%d", (i == 0) ? "" : ",", frequencies[i]);
+				printf("]}\n");
+			}
+			break;
+		}
+		case AS3935Stream::AS3935_FRAME_REGISTERS:
+		{
+			uint8_t first = 0;
+			uint8_t values[255];
+			uint8_t count = sizeof(values);
+			if (decoder.decodeRegisters(first, values, count))
+			{
+				printf("{\"type\":\"registers\",\"first\":%u,\"values\":[", first);
+				for (uint8_t i = 0; i < count; i++)
+					printf("%s%u", (i == 0) ? "" : ",", values[i]);
+				printf("]}\n");
+			}
+			break;
+		}
+		default:
+			break;
+		}
+
+		fflush(stdout);
+	}
+
+	fprintf(stderr, "frames discarded: %u\n", decoder.errors());
+
+	return 0;
+}
@@ -0,0 +1,254 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// stream_test.cpp
+//
+// test of AS3935Stream and AS3935StreamDecoder: round trips of event, calibration and register frames, payloads 
+// containing 0x00 and filling a COBS block of 254 bytes, CRC mismatches and buffers too small for a frame.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "AS3935Stream.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//feeds an encoded frame into the decoder. 
+//@return true if the frame is complete and valid with the delimiter and not before. 
+static bool feed(AS3935StreamDecoder &decoder, const uint8_t *data, size_t size)
+{
+	for (size_t i = 0; i + 1 < size; i++)
+	{
+		//the delimiter is the only 0x00 byte of a frame
+		if ((data[i] == 0x00) || decoder.push(data[i]))
+			return false;
+	}
+
+	return (size > 0) && (data[size - 1] == 0x00) && decoder.push(data[size - 1]);
+}
+
+static void testEvent()
+{
+	uint8_t buffer[64];
+	AS3935Stream stream(buffer, sizeof(buffer));
+
+	uint8_t decoded[64];
+	AS3935StreamDecoder decoder(decoded, sizeof(decoded));
+
+	//without and with 0x00 bytes in the payload
+	const uint32_t timestamps[] = { 0x12345678ul, 0, 0x00FF0001ul };
+	const uint32_t energies[] = { 0x0ABCDEul, 0, 0x010000ul };
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		AS3935Event event;
+		event.timestamp = timestamps[i];
+		event.source = (i == 1) ? 0 : 0b1000;
+		event.energy = energies[i];
+		event.distance = (i == 1) ? 0 : 14;
+
+		CHECK(stream.encodeEvent(event) == AS3935Stream::AS3935_STREAM_EVENT_FRAME_SIZE);
+		CHECK(stream.size() == AS3935Stream::AS3935_STREAM_EVENT_FRAME_SIZE);
+		CHECK(feed(decoder, stream.data(), stream.size()));
+		CHECK(decoder.type() == AS3935Stream::AS3935_FRAME_EVENT);
+
+		AS3935Event result;
+		CHECK(decoder.decodeEvent(result));
+		CHECK(result.timestamp == event.timestamp);
+		CHECK(result.source == event.source);
+		CHECK(result.energy == event.energy);
+		CHECK(result.distance == event.distance);
+	}
+
+	CHECK(decoder.errors() == 0);
+}
+
+static void testCalibration()
+{
+	uint8_t buffer[128];
+	AS3935Stream stream(buffer, sizeof(buffer));
+
+	uint8_t decoded[128];
+	AS3935StreamDecoder decoder(decoded, sizeof(decoded));
+
+	//-1 for tuning capacitors not measured, 0 and values with 0x00 bytes in their varint encoding
+	int32_t frequencies[16];
+	for (uint8_t i = 0; i < 16; i++)
+		frequencies[i] = 480000 + 2500 * i;
+	frequencies[3] = -1;
+	frequencies[4] = 0;
+	frequencies[5] = 0x4000;
+
+	CHECK(stream.encodeCalibration(7, frequencies, 16) > 0);
+	CHECK(feed(decoder, stream.data(), stream.size()));
+	CHECK(decoder.type() == AS3935Stream::AS3935_FRAME_CALIBRATION);
+
+	int8_t ant_cap = 0;
+	int32_t result[16];
+	uint8_t count = 16;
+	CHECK(decoder.decodeCalibration(ant_cap, result, count));
+	CHECK(ant_cap == 7);
+	CHECK(count == 16);
+	CHECK(memcmp(result, frequencies, sizeof(frequencies)) == 0);
+
+	//no calibration performed
+	CHECK(stream.encodeCalibration(-1, frequencies, 0) > 0);
+	CHECK(feed(decoder, stream.data(), stream.size()));
+
+	count = 16;
+	CHECK(decoder.decodeCalibration(ant_cap, result, count));
+	CHECK(ant_cap == -1);
+	CHECK(count == 0);
+
+	CHECK(decoder.errors() == 0);
+}
+
+//frames of 250 to 259 bytes before encoding, so the data ends within, at and after the first COBS block of 254 bytes
+static void testRegisters()
+{
+	uint8_t buffer[300];
+	AS3935Stream stream(buffer, sizeof(buffer));
+
+	uint8_t decoded[300];
+	AS3935StreamDecoder decoder(decoded, sizeof(decoded));
+
+	uint8_t values[255];
+
+	for (uint8_t fill = 0; fill < 2; fill++)
+	{
+		for (uint16_t count = 246; count <= 255; count++)
+		{
+			//all bytes non zero, or a 0x00 byte in every other byte
+			for (uint16_t i = 0; i < count; i++)
+				values[i] = (fill == 0) ? static_cast<uint8_t>(1 + i % 255) : static_cast<uint8_t>((i & 1) ? i : 0);
+
+			CHECK(stream.encodeRegisters(0x01, values, static_cast<uint8_t>(count)) > 0);
+			CHECK(feed(decoder, stream.data(), stream.size()));
+			CHECK(decoder.type() == AS3935Stream::AS3935_FRAME_REGISTERS);
+
+			uint8_t first = 0;
+			uint8_t result[255];
+			uint8_t nr_registers = 255;
+			CHECK(decoder.decodeRegisters(first, result, nr_registers));
+			CHECK(first == 0x01);
+			CHECK(nr_registers == count);
+			CHECK(memcmp(result, values, count) == 0);
+		}
+	}
+
+	CHECK(decoder.errors() == 0);
+}
+
+//a corrupted frame is counted in errors(), the decoder resynchronizes at the delimiter
+static void testCRCMismatch()
+{
+	uint8_t buffer[64];
+	AS3935Stream stream(buffer, sizeof(buffer));
+
+	uint8_t decoded[64];
+	AS3935StreamDecoder decoder(decoded, sizeof(decoded));
+
+	AS3935Event event;
+	event.timestamp = 0x11223344ul;
+	event.source = 0b1000;
+	event.energy = 0x055555ul;
+	event.distance = 27;
+
+	const size_t size = stream.encodeEvent(event);
+	CHECK(size == AS3935Stream::AS3935_STREAM_EVENT_FRAME_SIZE);
+
+	//the first byte of the timestamp, a data byte as the frame type and timestamp contain no 0x00 byte
+	uint8_t frame[AS3935Stream::AS3935_STREAM_EVENT_FRAME_SIZE];
+	memcpy(frame, stream.data(), sizeof(frame));
+	frame[2] ^= 0x80;
+
+	CHECK(!feed(decoder, frame, sizeof(frame)));
+	CHECK(decoder.errors() == 1);
+	CHECK(decoder.type() == 0);
+
+	AS3935Event result;
+	CHECK(!decoder.decodeEvent(result));
+
+	CHECK(feed(decoder, stream.data(), stream.size()));
+	CHECK(decoder.decodeEvent(result));
+	CHECK(result.timestamp == event.timestamp);
+	CHECK(decoder.errors() == 1);
+}
+
+//encoding into a buffer too small for the frame fails without writing past the buffer
+static void testSmallBuffer()
+{
+	AS3935Event event;
+	event.timestamp = 1000;
+	event.source = 0b1000;
+	event.energy = 0x1234;
+	event.distance = 5;
+
+	uint8_t buffer[AS3935Stream::AS3935_STREAM_EVENT_FRAME_SIZE + 4];
+
+	for (size_t size = 0; size < AS3935Stream::AS3935_STREAM_EVENT_FRAME_SIZE; size++)
+	{
+		memset(buffer, 0xA5, sizeof(buffer));
+
+		AS3935Stream stream(buffer, size);
+		CHECK(stream.encodeEvent(event) == 0);
+		CHECK(stream.size() == 0);
+
+		for (size_t i = size; i < sizeof(buffer); i++)
+			CHECK(buffer[i] == 0xA5);
+	}
+
+	AS3935Stream stream(buffer, AS3935Stream::AS3935_STREAM_EVENT_FRAME_SIZE);
+	CHECK(stream.encodeEvent(event) == AS3935Stream::AS3935_STREAM_EVENT_FRAME_SIZE);
+
+	//a register frame longer than the buffer
+	uint8_t values[32];
+	memset(values, 0x42, sizeof(values));
+	CHECK(stream.encodeRegisters(0x00, values, sizeof(values)) == 0);
+	CHECK(stream.size() == 0);
+
+	//a decoder buffer too small for the frame discards it
+	uint8_t large[64];
+	AS3935Stream encoder(large, sizeof(large));
+	CHECK(encoder.encodeRegisters(0x00, values, sizeof(values)) > 0);
+
+	uint8_t decoded[16];
+	AS3935StreamDecoder decoder(decoded, sizeof(decoded));
+	CHECK(!feed(decoder, encoder.data(), encoder.size()));
+	CHECK(decoder.errors() == 1);
+}
+
+int main()
+{
+	testEvent();
+	testCalibration();
+	testRegisters();
+	testCRCMismatch();
+	testSmallBuffer();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+	return (failures_ == 0) ? 0 : 1;
+}
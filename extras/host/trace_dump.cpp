@@ -0,0 +1,84 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// trace_dump.cpp
+//
+// prints a trace recorded by AS3935Recorder as text, one record per line. 
+//
+//   trace_dump trace.bin
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "AS3935Trace.h"
+
+int main(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s TRACE\n", argv[0]);
+		return 2;
+	}
+
+	FILE *file = fopen(argv[1], "rb");
+	if (!file)
+	{
+		fprintf(stderr, "cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<uint8_t> data;
+	uint8_t buffer[4096];
+	size_t length = 0;
+	while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		data.insert(data.end(), buffer, buffer + length);
+	fclose(file);
+
+	AS3935TraceReader reader(data.data(), data.size());
+	if (!reader.valid())
+	{
+		fprintf(stderr, "%s is not a trace\n", argv[1]);
+		return 1;
+	}
+
+	AS3935TraceRecord record;
+	while (reader.next(record))
+	{
+		printf("%10lu us  ", static_cast<unsigned long>(record.timestamp));
+
+		switch (record.type)
+		{
+		case AS3935TraceRecord::AS3935_TRACE_READ:
+			printf("read   0x%02X -> 0x%02X\n", record.reg, record.value);
+			break;
+		case AS3935TraceRecord::AS3935_TRACE_WRITE:
+			printf("write  0x%02X <- 0x%02X\n", record.reg, record.value);
+			break;
+		case AS3935TraceRecord::AS3935_TRACE_IRQ:
+			printf("irq    %s\n", record.value ? "high" : "low");
+			break;
+		case AS3935TraceRecord::AS3935_TRACE_OSCILLATOR:
+			printf("osc    %lu us, period %lu ns\n", static_cast<unsigned long>(record.duration), 
+				static_cast<unsigned long>(record.period));
+			break;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,256 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// trace_test.cpp
+//
+// records a session with the simulated sensor through AS3935Recorder and replays the trace with AS3935Replay. 
+// the replayed session must issue the same register accesses and produce the same results.
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "AS3935Recorder.h"
+#include "AS3935Replay.h"
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+#define PIN_IRQ 2
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+class TraceBuffer :
+	public Print
+{
+public:
+	virtual size_t write(uint8_t value)
+	{
+		data.push_back(value);
+		return 1;
+	}
+
+	std::vector<uint8_t> data;
+};
+
+struct session_t
+{
+	bool begin;
+	bool calibrated;
+	bool rco_calibrated;
+	int8_t ant_cap;
+	int32_t frequencies[16];
+	uint8_t source;
+	uint32_t energy;
+	uint8_t distance;
+	uint8_t noise_source;
+};
+
+//the session run during recording and replay. events are injected into the simulated sensor during recording only.
+static session_t runSession(AS3935MI &sensor, AS3935Sim *sim)
+{
+	session_t session = session_t();
+
+	session.begin = sensor.begin();
+
+	int32_t frequency = 0;
+	session.calibrated = sensor.calibrateResonanceFrequency(frequency, AS3935MI::AS3935_DR_16);
+	session.rco_calibrated = sensor.calibrateRCO();
+	session.ant_cap = sensor.getCalibratedAntCap();
+	for (uint8_t i = 0; i < 16; i++)
+		session.frequencies[i] = sensor.getAntCapFrequency(i);
+
+	sensor.writeNoiseFloorThreshold(AS3935MI::AS3935_NFL_2);
+	delay(100);
+
+	if (sim)
+		sim->injectLightning(54321, 20);
+	delay(5);
+
+	session.source = sensor.readInterruptSource();
+	session.energy = sensor.readEnergy();
+	session.distance = sensor.readStormDistance();
+	delay(50);
+
+	if (sim)
+		sim->injectNoise();
+	delay(5);
+
+	session.noise_source = sensor.readInterruptSource();
+	if (session.noise_source == AS3935MI::AS3935_INT_NH)
+		sensor.increaseNoiseFloorThreshold();
+
+	return session;
+}
+
+static bool sameSession(const session_t &a, const session_t &b)
+{
+	bool same = (a.begin == b.begin) && (a.calibrated == b.calibrated) && (a.rco_calibrated == b.rco_calibrated) && 
+		(a.ant_cap == b.ant_cap) && (a.source == b.source) && (a.energy == b.energy) && (a.distance == b.distance) && 
+		(a.noise_source == b.noise_source);
+
+	for (uint8_t i = 0; i < 16; i++)
+		same = same && (a.frequencies[i] == b.frequencies[i]);
+
+	return same;
+}
+
+//the oscillator signal is replayed at the frequency measured during recording, the replayed measurement matches 
+//within the resolution of the driver's measurement (one edge per measurement window, about 0.2%)
+static bool closeFrequencies(const session_t &a, const session_t &b)
+{
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		const int32_t difference = a.frequencies[i] - b.frequencies[i];
+		if ((difference < 0 ? -difference : difference) * 400 > a.frequencies[i])
+		{
+			printf("tuning %u: recorded %ld Hz, replayed %ld Hz\n", i, 
+				static_cast<long>(a.frequencies[i]), static_cast<long>(b.frequencies[i]));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static session_t replay(const std::vector<uint8_t> &trace)
+{
+	hostResetTime();
+
+	AS3935Replay replay(PIN_IRQ, trace.data(), trace.size());
+	CHECK(replay.valid());
+
+	const session_t session = runSession(replay, nullptr);
+
+	CHECK(replay.finished());
+	CHECK(replay.getDivergences() == 0);
+	if (replay.getDivergences())
+		printf("first divergence at access %ld\n", replay.getFirstDivergence());
+
+	return session;
+}
+
+static void testRecordReplay()
+{
+	TraceBuffer trace;
+	session_t recorded;
+
+	{
+		hostResetTime();
+
+		AS3935Sim sim(PIN_IRQ);
+		sim.setNakWhileDisplaying(true);
+		sim.setBusTiming(97500, 72500);		//I2C at 400 kHz
+
+		AS3935Recorder recorder(sim, trace);
+		recorded = runSession(recorder, &sim);
+		recorder.flush();
+
+		CHECK(recorder.getBytesWritten() == trace.data.size());
+		printf("recorded %lu records, %lu bytes, %lu register accesses\n", 
+			static_cast<unsigned long>(recorder.getRecordCount()), static_cast<unsigned long>(trace.data.size()),
+			static_cast<unsigned long>(sim.getRegisterReads() + sim.getRegisterWrites()));
+	}
+
+	CHECK(recorded.begin);
+	CHECK(recorded.calibrated);
+	CHECK(recorded.rco_calibrated);
+	CHECK(recorded.source == AS3935MI::AS3935_INT_L);
+	CHECK(recorded.energy == 54321);
+	CHECK(recorded.distance == 20);
+	CHECK(recorded.noise_source == AS3935MI::AS3935_INT_NH);
+
+	//the replay reproduces the register accesses and the frequencies measured on the IRQ pin
+	const session_t replayed = replay(trace.data);
+	CHECK(replayed.ant_cap == recorded.ant_cap);
+	CHECK(replayed.source == recorded.source);
+	CHECK(replayed.energy == recorded.energy);
+	CHECK(replayed.distance == recorded.distance);
+	CHECK(replayed.noise_source == recorded.noise_source);
+	CHECK(closeFrequencies(recorded, replayed));
+
+	//replays are deterministic
+	const session_t again = replay(trace.data);
+	CHECK(sameSession(replayed, again));
+}
+
+static void testReader()
+{
+	uint8_t trace[64];
+	AS3935TraceReader::header(trace);
+	size_t length = AS3935TraceReader::AS3935_TRACE_HEADER_SIZE;
+
+	AS3935TraceRecord record = AS3935TraceRecord();
+	record.type = AS3935TraceRecord::AS3935_TRACE_WRITE;
+	record.timestamp = 0xFFFFFF00;
+	record.reg = 0x08;
+	record.value = 0x85;
+	length += AS3935TraceReader::encode(record, 0, trace + length);
+
+	//timestamps wrap around
+	record.type = AS3935TraceRecord::AS3935_TRACE_OSCILLATOR;
+	record.timestamp = 0x00000100;
+	record.duration = 32000;
+	record.period = 32000;
+	length += AS3935TraceReader::encode(record, 0xFFFFFF00, trace + length);
+
+	//records out of order
+	record.type = AS3935TraceRecord::AS3935_TRACE_IRQ;
+	record.timestamp = 0x00000080;
+	record.value = HIGH;
+	length += AS3935TraceReader::encode(record, 0x00000100, trace + length);
+
+	AS3935TraceReader reader(trace, length);
+	CHECK(reader.valid());
+	CHECK(reader.next(record) && (record.type == AS3935TraceRecord::AS3935_TRACE_WRITE) && 
+		(record.timestamp == 0xFFFFFF00) && (record.reg == 0x08) && (record.value == 0x85));
+	CHECK(reader.next(record) && (record.type == AS3935TraceRecord::AS3935_TRACE_OSCILLATOR) && 
+		(record.timestamp == 0x00000100) && (record.duration == 32000) && (record.period == 32000));
+	CHECK(reader.next(record) && (record.type == AS3935TraceRecord::AS3935_TRACE_IRQ) && 
+		(record.timestamp == 0x00000080) && (record.value == HIGH));
+	CHECK(!reader.next(record));
+
+	//truncated record
+	AS3935TraceReader truncated(trace, length - 1);
+	CHECK(truncated.next(record));
+	CHECK(truncated.next(record));
+	CHECK(!truncated.next(record));
+
+	//invalid header
+	trace[0] = 'X';
+	AS3935TraceReader invalid(trace, length);
+	CHECK(!invalid.valid());
+	CHECK(!invalid.next(record));
+}
+
+int main()
+{
+	testReader();
+	testRecordReplay();
+
+	printf("result: %s\n", (failures_ == 0) ? "pass" : "fail");
+
+	return (failures_ == 0) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+// wait_test.cpp
+//
+// test of waitForEvent() on a simulated sensor, in virtual time and with an event raised by another thread.
+
+#include <stdio.h>
+
+#include <thread>
+
+#include "AS3935Sim.h"
+#include "ArduinoHost.h"
+
+static int failures_ = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures_++; \
+		} \
+	} while (0)
+
+//the wait ends at the event or the timeout, a pending event ends it immediately
+static void testVirtualTime()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+
+	//interrupts not enabled
+	CHECK(sim.waitForEvent(1000) == 0);
+	CHECK(millis() == 4);
+
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	//timeout
+	CHECK(sim.waitForEvent(100) == 0);
+	CHECK(millis() == 104);
+
+	//event during the wait
+	hostSchedule(354000000ull, [&sim]() { sim.injectLightning(1000, 10); });
+	CHECK(sim.waitForEvent(1000) == 354);
+	CHECK(millis() == 354);
+
+	AS3935Event event;
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.distance == 10);
+
+	//pending event
+	sim.injectLightning(2000, 5);
+	delay(10);
+	CHECK(sim.waitForEvent(1000) == 354);
+	CHECK(millis() == 364);
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.distance == 5);
+
+	//the interrupt handler was not called, e.g. because the MCU slept through the edge
+	noInterrupts();
+	sim.injectLightning(3000, 8);
+	interrupts();
+	CHECK(sim.getInterruptTimestamp() == 0);
+	CHECK(sim.waitForEvent(1000) == 364);
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.distance == 8);
+
+	//no timeout
+	hostSchedule(hostNanos() + 3600000000000ull, [&sim]() { sim.injectLightning(4000, 6); });
+	CHECK(sim.waitForEvent(UINT32_MAX) == 364 + 3600000);
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.distance == 6);
+
+	//without IRQ pin
+	AS3935Sim no_irq(AS3935MI::AS3935_NO_IRQ);
+	CHECK(no_irq.begin());
+	no_irq.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+	const uint32_t start = millis();
+	CHECK(no_irq.waitForEvent(1000) == 0);
+	CHECK(millis() == start);
+}
+
+//the waiting thread sleeps on a condition variable until another thread raises the interrupt
+static void testThread()
+{
+	hostResetTime();
+
+	AS3935Sim sim(2);
+	CHECK(sim.begin());
+	sim.setInterruptMode(AS3935MI::AS3935_INTERRUPT_NORMAL);
+
+	hostSetVirtualTime(false);
+
+	//timeout
+	uint32_t start = millis();
+	CHECK(sim.waitForEvent(20) == 0);
+	uint32_t elapsed = millis() - start;
+	CHECK((elapsed >= 20) && (elapsed < 500));
+
+	start = millis();
+	std::thread storm([&sim]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		sim.injectLightning(1000, 12);
+	});
+
+	const uint32_t timestamp = sim.waitForEvent(5000);
+	elapsed = millis() - start;
+	storm.join();
+
+	printf("woken after %u ms\n", elapsed);
+
+	CHECK(timestamp != 0);
+	CHECK((elapsed >= 50) && (elapsed < 2000));
+	CHECK(timestamp - start >= 50);
+
+	AS3935Event event;
+	CHECK(sim.readEvent(event) == AS3935MI::AS3935_INT_L);
+	CHECK(event.distance == 12);
+
+	hostSetVirtualTime(true);
+}
+
+int main()
+{
+	testVirtualTime();
+	testThread();
+
+	printf("result: %s\n", failures_ ? "FAILED" : "OK");
+
+	return (failures_ == 0) ? 0 : 1;
+}
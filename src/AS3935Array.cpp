@@ -0,0 +1,342 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Array.h"
+
+AS3935Array::AS3935Array(AS3935ArrayEntry *entries, uint8_t size) :
+	entries_(entries),
+	size_(size),
+	count_(0)
+{
+}
+
+int8_t AS3935Array::add(AS3935MI &sensor, uint32_t eventDeadline)
+{
+	if (count_ >= size_)
+		return -1;
+
+	AS3935ArrayEntry &entry = entries_[count_];
+
+	entry.sensor_ = &sensor;
+	entry.event_deadline_ = eventDeadline;
+	entry.irq_pending_ = false;
+	entry.irq_millis_ = 0;
+
+	entry.task_context_ = nullptr;
+	entry.task_ = nullptr;
+	entry.task_deadline_ = 0;
+
+	entry.drift_interval_ = 0;
+	entry.drift_due_ = 0;
+	entry.drift_valid_ = false;
+	entry.drift_frequency_ = 0;
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	entry.calibration_.phase = AS3935DriverBase::AS3935_CALIBRATION_DONE;
+	entry.calibration_.frequency = 0;
+	entry.calibration_.success = false;
+#endif
+
+	entry.statistics_start_ = static_cast<uint32_t>(sensor.nowMicros());
+	entry.events_ = 0;
+	entry.tasks_ = 0;
+	entry.busy_usec_ = 0;
+	entry.missed_deadlines_ = 0;
+
+	return count_++;
+}
+
+bool AS3935Array::scheduleTask(uint8_t index, task_t task, void *context, uint32_t deadline)
+{
+	if ((index >= count_) || (task == nullptr))
+		return false;
+
+	AS3935ArrayEntry &entry = entries_[index];
+	if (entry.task_)
+		return false;
+
+	entry.task_ = task;
+	entry.task_context_ = context;
+	entry.task_deadline_ = entry.sensor_->nowMillis() + deadline;
+
+	return true;
+}
+
+bool AS3935Array::isTaskPending(uint8_t index) const
+{
+	return (index < count_) && entries_[index].task_;
+}
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+void AS3935Array::setDriftCheckInterval(uint8_t index, uint32_t interval)
+{
+	if (index >= count_)
+		return;
+
+	AS3935ArrayEntry &entry = entries_[index];
+	entry.drift_interval_ = interval;
+	entry.drift_due_ = entry.sensor_->nowMillis() + interval;
+}
+
+bool AS3935Array::getDriftCheckResult(uint8_t index, int32_t &frequency) const
+{
+	if (index >= count_)
+		return false;
+
+	frequency = entries_[index].drift_frequency_;
+	return entries_[index].drift_valid_;
+}
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+bool AS3935Array::calibrateResonanceFrequency()
+{
+	bool success = true;
+
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+	//the calibration state and interrupt service routine of each sensor are separate, so the sensors can count the 
+	//edges on their IRQ pins at the same time
+	bool running = false;
+	for (uint8_t i = 0; i < count_; i++)
+	{
+		AS3935ArrayEntry &entry = entries_[i];
+		AS3935MI &sensor = *entry.sensor_;
+
+		entry.calibration_.phase = AS3935DriverBase::AS3935_CALIBRATION_DONE;
+		entry.calibration_.frequency = 0;
+		entry.calibration_.success = false;
+
+		if (sensor.beginCalibration(entry.calibration_, sensor.getCalibrationDivisionRatio()))
+			running = true;
+	}
+
+	while (running)
+	{
+		entries_[0].sensor_->delayMillis(1);
+
+		running = false;
+		for (uint8_t i = 0; i < count_; i++)
+		{
+			if (!entries_[i].sensor_->updateCalibration(entries_[i].calibration_))
+				running = true;
+		}
+	}
+
+	for (uint8_t i = 0; i < count_; i++)
+		success = success && entries_[i].calibration_.success;
+#else
+	//the interrupt service routine of the driver is shared by all sensors
+	for (uint8_t i = 0; i < count_; i++)
+	{
+		AS3935ArrayEntry &entry = entries_[i];
+
+		entry.calibration_.frequency = 0;
+		entry.calibration_.success = entry.sensor_->calibrateResonanceFrequency(entry.calibration_.frequency);
+		success = success && entry.calibration_.success;
+	}
+#endif
+
+	return success;
+}
+
+bool AS3935Array::getCalibrationResult(uint8_t index, int32_t &frequency) const
+{
+	if (index >= count_)
+		return false;
+
+	frequency = entries_[index].calibration_.frequency;
+	return entries_[index].calibration_.success;
+}
+#endif
+
+uint8_t AS3935Array::update(uint8_t &index, AS3935Event &event)
+{
+	//read the event with the earliest deadline. while an IRQ is pending no other jobs run, as they might block the 
+	//bus for longer than the event deadline.
+	bool irq_pending = false;
+	int16_t next = -1;
+	uint32_t next_deadline = 0;
+
+	for (uint8_t i = 0; i < count_; i++)
+	{
+		AS3935ArrayEntry &entry = entries_[i];
+		const uint32_t now = entry.sensor_->nowMillis();
+
+		sampleIRQ(entry, now);
+		if (!entry.irq_pending_)
+			continue;
+
+		irq_pending = true;
+		if (before(now, entry.irq_millis_ + AS3935_ARRAY_IRQ_DELAY))
+			continue;
+
+		const uint32_t deadline = entry.irq_millis_ + entry.event_deadline_;
+		if ((next < 0) || before(deadline, next_deadline))
+		{
+			next = i;
+			next_deadline = deadline;
+		}
+	}
+
+	if (next >= 0)
+	{
+		AS3935ArrayEntry &entry = entries_[next];
+		const uint32_t start = static_cast<uint32_t>(entry.sensor_->nowMicros());
+
+		entry.sensor_->readEvent(event);
+		entry.irq_pending_ = false;
+		entry.events_++;
+		finish(entry, start, next_deadline);
+
+		index = next;
+		return AS3935_ARRAY_EVENT;
+	}
+
+	if (irq_pending)
+		return AS3935_ARRAY_IDLE;
+
+	//run the task or drift check with the earliest deadline
+	uint8_t job = AS3935_ARRAY_IDLE;
+	for (uint8_t i = 0; i < count_; i++)
+	{
+		AS3935ArrayEntry &entry = entries_[i];
+
+		if (entry.task_ && ((job == AS3935_ARRAY_IDLE) || before(entry.task_deadline_, next_deadline)))
+		{
+			next = i;
+			next_deadline = entry.task_deadline_;
+			job = AS3935_ARRAY_TASK;
+		}
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+		//the check is due at drift_due_, and should have run before the next one is due
+		const uint32_t now = entry.sensor_->nowMillis();
+		const uint32_t drift_deadline = entry.drift_due_ + entry.drift_interval_;
+		if (entry.drift_interval_ && !before(now, entry.drift_due_) && 
+			((job == AS3935_ARRAY_IDLE) || before(drift_deadline, next_deadline)))
+		{
+			next = i;
+			next_deadline = drift_deadline;
+			job = AS3935_ARRAY_DRIFT_CHECK;
+		}
+#endif
+	}
+
+	if (job == AS3935_ARRAY_IDLE)
+		return AS3935_ARRAY_IDLE;
+
+	AS3935ArrayEntry &entry = entries_[next];
+	const uint32_t start = static_cast<uint32_t>(entry.sensor_->nowMicros());
+
+	if (job == AS3935_ARRAY_TASK)
+	{
+		//the task may schedule the next task
+		task_t task = entry.task_;
+		entry.task_ = nullptr;
+		task(*entry.sensor_, entry.task_context_);
+	}
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	else
+	{
+		entry.drift_valid_ = entry.sensor_->validateCurrentResonanceFrequency(entry.drift_frequency_);
+		entry.drift_due_ += entry.drift_interval_;
+
+		//skip checks missed entirely
+		if (before(entry.drift_due_, entry.sensor_->nowMillis()))
+			entry.drift_due_ = entry.sensor_->nowMillis() + entry.drift_interval_;
+	}
+#endif
+
+	entry.tasks_++;
+	finish(entry, start, next_deadline);
+
+	index = next;
+	return job;
+}
+
+AS3935Array::statistics_t AS3935Array::getStatistics(uint8_t index) const
+{
+	statistics_t statistics = { 0, 0, 0, 0, 0 };
+	if (index >= count_)
+		return statistics;
+
+	const AS3935ArrayEntry &entry = entries_[index];
+	statistics.events = entry.events_;
+	statistics.tasks = entry.tasks_;
+	statistics.busy_usec = entry.busy_usec_;
+	statistics.elapsed_usec = static_cast<uint32_t>(entry.sensor_->nowMicros()) - entry.statistics_start_;
+	statistics.missed_deadlines = entry.missed_deadlines_;
+
+	return statistics;
+}
+
+uint16_t AS3935Array::getBusUtilization(uint8_t index) const
+{
+	const statistics_t statistics = getStatistics(index);
+	if (statistics.elapsed_usec == 0)
+		return 0;
+
+	//busy_usec <= elapsed_usec, scaled down to avoid overflows
+	uint32_t busy = statistics.busy_usec;
+	uint32_t elapsed = statistics.elapsed_usec;
+	while (busy > 0xFFFFFFFFul / 1000ul)
+	{
+		busy >>= 1;
+		elapsed >>= 1;
+	}
+
+	return static_cast<uint16_t>((busy * 1000ul) / elapsed);
+}
+
+void AS3935Array::resetStatistics()
+{
+	for (uint8_t i = 0; i < count_; i++)
+	{
+		AS3935ArrayEntry &entry = entries_[i];
+
+		entry.statistics_start_ = static_cast<uint32_t>(entry.sensor_->nowMicros());
+		entry.events_ = 0;
+		entry.tasks_ = 0;
+		entry.busy_usec_ = 0;
+		entry.missed_deadlines_ = 0;
+	}
+}
+
+void AS3935Array::sampleIRQ(AS3935ArrayEntry &entry, uint32_t now)
+{
+	//the IRQ pin stays high until the interrupt register is read
+	if (entry.irq_pending_ || (digitalRead(entry.sensor_->getIrqPin()) != HIGH))
+		return;
+
+	entry.irq_pending_ = true;
+	entry.irq_millis_ = now;
+
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+	const uint32_t timestamp = entry.sensor_->getInterruptTimestamp();
+	if ((timestamp != 0) && before(timestamp, now))
+		entry.irq_millis_ = timestamp;
+#endif
+}
+
+void AS3935Array::finish(AS3935ArrayEntry &entry, uint32_t start, uint32_t deadline)
+{
+	entry.busy_usec_ += static_cast<uint32_t>(entry.sensor_->nowMicros()) - start;
+
+	if (before(deadline, entry.sensor_->nowMillis()))
+		entry.missed_deadlines_++;
+}
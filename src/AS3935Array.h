@@ -0,0 +1,212 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935ARRAY_H_
+#define AS3935ARRAY_H_
+
+#include "AS3935MI.h"
+#include "AS3935Event.h"
+
+#include <Arduino.h>
+
+class AS3935Array;
+
+//state of a sensor managed by an AS3935Array. allocated by the user, e.g. AS3935ArrayEntry entries[4];
+class AS3935ArrayEntry
+{
+private:
+	friend class AS3935Array;
+
+	AS3935MI *sensor_;
+
+	uint32_t event_deadline_;		//maximum time from the IRQ to the end of the event read in milliseconds
+	bool irq_pending_;
+	uint32_t irq_millis_;			//time the IRQ was raised
+
+	void *task_context_;
+	void (*task_)(AS3935MI &sensor, void *context);
+	uint32_t task_deadline_;
+
+	uint32_t drift_interval_;		//0 if drift checks are disabled
+	uint32_t drift_due_;
+	bool drift_valid_;
+	int32_t drift_frequency_;
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	AS3935DriverBase::calibration_state_t calibration_;
+#endif
+
+	uint32_t statistics_start_;		//time of the last reset of the statistics in microseconds
+	uint32_t events_;
+	uint32_t tasks_;
+	uint32_t busy_usec_;
+	uint32_t missed_deadlines_;
+};
+
+//manages several sensors sharing a bus (e.g. up to three sensors on I2C, or sensors with separate chip select pins 
+//on SPI) and schedules their bus transactions, so only one sensor uses the bus at a time. 
+//
+//update() runs one job per call. reading the event of a sensor whose IRQ pin is high has priority over tasks 
+//scheduled with scheduleTask() (e.g. configuration changes) and antenna drift checks, which only run when no IRQ is 
+//pending. among jobs of the same kind the one with the earliest deadline runs first. the event of a sensor is read 
+//2ms after its IRQ was raised, as required by the datasheet. 
+//
+//the IRQ pins are sampled by update(), the sensors do not need to have an interrupt attached. on cores with 
+//attachInterruptArg() the interrupt timestamp of sensors in AS3935_INTERRUPT_NORMAL mode is used as IRQ time. 
+class AS3935Array
+{
+public:
+	enum job_t : uint8_t
+	{
+		AS3935_ARRAY_IDLE = 0,			//nothing to do
+		AS3935_ARRAY_EVENT = 1,			//an event was read
+		AS3935_ARRAY_TASK = 2,			//a task was run
+		AS3935_ARRAY_DRIFT_CHECK = 3,	//the resonance frequency was checked
+	};
+
+	struct statistics_t
+	{
+		uint32_t events;			//events read
+		uint32_t tasks;				//tasks and drift checks run
+		uint32_t busy_usec;			//time the jobs of the sensor occupied the bus, including delays
+		uint32_t elapsed_usec;		//time since the statistics were reset
+		uint32_t missed_deadlines;	//jobs finished after their deadline
+	};
+
+	typedef void (*task_t)(AS3935MI &sensor, void *context);
+
+	//time to wait after an IRQ before reading the interrupt register, in milliseconds
+	static const uint8_t AS3935_ARRAY_IRQ_DELAY = 2;
+
+	/*
+	@param entries memory for the state of the sensors. must stay valid during the lifetime of this object.
+	@param size number of entries. */
+	AS3935Array(AS3935ArrayEntry *entries, uint8_t size);
+
+	/*
+	adds a sensor to the array. the sensor's begin() function must have been called. 
+	@param sensor sensor to add. must stay valid during the lifetime of this object.
+	@param eventDeadline maximum time from the IRQ to the end of reading the event in milliseconds. 
+	@return index of the sensor, or -1 if all entries are in use. */
+	int8_t add(AS3935MI &sensor, uint32_t eventDeadline = 100);
+
+	/*
+	@return number of sensors in the array. */
+	uint8_t count() const {
+		return count_;
+	}
+
+	/*
+	@param index index of the sensor. 
+	@return the sensor. */
+	AS3935MI &getSensor(uint8_t index) {
+		return *entries_[index].sensor_;
+	}
+
+	/*
+	schedules a task using the bus of a sensor, e.g. to change its configuration. one task can be pending per sensor. 
+	@param index index of the sensor. 
+	@param task function to call with the sensor. 
+	@param context passed to task. 
+	@param deadline maximum time from now to the end of the task in milliseconds. 
+	@return true if the task was scheduled, false if a task is already pending or index is invalid. */
+	bool scheduleTask(uint8_t index, task_t task, void *context, uint32_t deadline);
+
+	/*
+	@param index index of the sensor. 
+	@return true if a task is pending. */
+	bool isTaskPending(uint8_t index) const;
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	/*
+	checks the resonance frequency of a sensor periodically with validateCurrentResonanceFrequency(). the check of a 
+	sensor misses its deadline if it did not run before the next check was due. 
+	@param index index of the sensor. 
+	@param interval time between checks in milliseconds, 0 to disable checks. */
+	void setDriftCheckInterval(uint8_t index, uint32_t interval);
+
+	/*
+	@param index index of the sensor. 
+	@param frequency (by reference, write only) frequency measured by the last drift check.
+	@return true if the frequency was within the allowed deviation, false otherwise or if no check was run. */
+	bool getDriftCheckResult(uint8_t index, int32_t &frequency) const;
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	/*
+	calibrates the resonance frequency of all sensors, like calibrateResonanceFrequency() of each sensor. on cores 
+	with attachInterruptArg() all sensors display their LCO on their IRQ pins at once and the edges are counted on 
+	all pins simultaneously, each sensor advancing its search on its own. this takes about as long as the calibration 
+	of a single sensor. on other cores the sensors are calibrated one after another. 
+	@return true if all sensors were calibrated successfully, false otherwise. */
+	bool calibrateResonanceFrequency();
+
+	/*
+	@param index index of the sensor. 
+	@param frequency (by reference, write only) frequency the sensor was calibrated to by calibrateResonanceFrequency().
+	@return true if the sensor was calibrated successfully, false otherwise. */
+	bool getCalibrationResult(uint8_t index, int32_t &frequency) const;
+#endif
+
+	/*
+	runs the most urgent job. call frequently, e.g. in loop(). 
+	@param index (by reference, write only) index of the sensor the job was run for. 
+	@param event (by reference, write only) the event read if AS3935_ARRAY_EVENT is returned.
+	@return job run as job_t. */
+	uint8_t update(uint8_t &index, AS3935Event &event);
+
+	/*
+	@param index index of the sensor. 
+	@return statistics of the sensor since the last call of resetStatistics(). */
+	statistics_t getStatistics(uint8_t index) const;
+
+	/*
+	@param index index of the sensor. 
+	@return share of time the jobs of the sensor occupied the bus since the last call of resetStatistics(), per mille. */
+	uint16_t getBusUtilization(uint8_t index) const;
+
+	/*
+	resets the statistics of all sensors. */
+	void resetStatistics();
+
+private:
+	/*
+	updates the IRQ state of a sensor. 
+	@param entry the sensor's entry. 
+	@param now current time in milliseconds. */
+	void sampleIRQ(AS3935ArrayEntry &entry, uint32_t now);
+
+	/*
+	@return true if time a is before time b, considering overflows. */
+	static bool before(uint32_t a, uint32_t b) {
+		return static_cast<int32_t>(a - b) < 0;
+	}
+
+	/*
+	books a finished job. 
+	@param entry the sensor's entry. 
+	@param start start of the job in microseconds. 
+	@param deadline deadline of the job in milliseconds. */
+	void finish(AS3935ArrayEntry &entry, uint32_t start, uint32_t deadline);
+
+	AS3935ArrayEntry *entries_;
+	uint8_t size_;
+	uint8_t count_;
+};
+
+#endif /* AS3935ARRAY_H_ */
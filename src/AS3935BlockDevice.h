@@ -0,0 +1,56 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935BLOCKDEVICE_H_
+#define AS3935BLOCKDEVICE_H_
+
+#include <stdint.h>
+
+//interface to a page organized non volatile memory (EEPROM, flash, file, ...) used by AS3935Journal. 
+//implement this class to store events on the memory of your choice. 
+class AS3935BlockDevice
+{
+public:
+	virtual ~AS3935BlockDevice() {}
+
+	/*
+	@return size of a single page in bytes. */
+	virtual uint16_t pageSize() const = 0;
+
+	/*
+	@return number of pages available. */
+	virtual uint16_t pageCount() const = 0;
+
+	/*
+	reads data from a page. 
+	@param page page to read from.
+	@param offset offset of the first byte to read within the page. 
+	@param data buffer to store the read data in.
+	@param length number of bytes to read.
+	@return true on success, false otherwise. */
+	virtual bool read(uint16_t page, uint16_t offset, uint8_t *data, uint16_t length) = 0;
+
+	/*
+	writes a complete page. the page must be erased by the implementation if required by the memory. 
+	@param page page to write to.
+	@param data pageSize() bytes to write.
+	@return true on success, false otherwise. */
+	virtual bool writePage(uint16_t page, const uint8_t *data) = 0;
+};
+
+#endif /* AS3935BLOCKDEVICE_H_ */
@@ -0,0 +1,33 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935CRC_H_
+#define AS3935CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+computes a CRC-16/CCITT (polynomial 0x1021) checksum. can be called repeatedly to checksum data in chunks. 
+@param data data to checksum.
+@param length number of bytes in data. 
+@param crc checksum of the preceding chunk, 0xFFFF for the first chunk.
+@return checksum. */
+uint16_t AS3935CRC16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+
+#endif /* AS3935CRC_H_ */
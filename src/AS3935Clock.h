@@ -0,0 +1,87 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935CLOCK_H_
+#define AS3935CLOCK_H_
+
+#include <stdint.h>
+
+//time source and delays of the library. by default, the library uses the Arduino core functions directly. 
+//with AS3935MI_ENABLE_CLOCK defined, AS3935MI::setClock() routes all timestamps and delays through a clock 
+//object, e.g. to run long scenarios in virtual time. 
+class AS3935Clock
+{
+public:
+	virtual ~AS3935Clock() {}
+
+	/*
+	@return time in microseconds. must not wrap around and must be callable from interrupt service routines. */
+	virtual uint64_t micros64() = 0;
+
+	/*
+	blocks for the given time. 
+	@param usec delay in microseconds. */
+	virtual void delayMicros(uint32_t usec) = 0;
+
+	/*
+	@return time in milliseconds. */
+	uint64_t millis64() {
+		return micros64() / 1000;
+	}
+};
+
+//clock that only advances when told to. delays return immediately after advancing the clock, so scenarios 
+//spanning hours run in milliseconds. 
+class AS3935VirtualClock :
+	public AS3935Clock
+{
+public:
+	/*
+	@param start_usec initial time in microseconds. */
+	AS3935VirtualClock(uint64_t start_usec = 0) :
+		now_(start_usec)
+	{
+	}
+
+	virtual uint64_t micros64() {
+		return now_;
+	}
+
+	virtual void delayMicros(uint32_t usec) {
+		now_ += usec;
+	}
+
+	/*
+	advances the clock. 
+	@param usec time to advance in microseconds. */
+	void advance(uint64_t usec) {
+		now_ += usec;
+	}
+
+	/*
+	sets the clock. 
+	@param usec new time in microseconds. */
+	void set(uint64_t usec) {
+		now_ = usec;
+	}
+
+private:
+	uint64_t now_;
+};
+
+#endif /* AS3935CLOCK_H_ */
@@ -0,0 +1,749 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA	02110-1301	USA
+
+#include "AS3935Driver.h"
+
+
+#if defined(ESP32)
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#elif defined(__AVR__)
+#include <avr/sleep.h>
+#elif defined(ARDUINO_ARCH_HOST)
+#include "ArduinoHost.h"
+#endif
+
+#ifdef ESP8266
+#define getMicros64 micros64
+#elif defined(ESP32)
+#define getMicros64 esp_timer_get_time
+#else
+#define getMicros64 micros
+#endif
+
+
+// When we can't use attachInterruptArg to directly access volatile members,
+// we must use static members
+#ifndef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+	AS3935MI_VOLATILE_TYPE AS3935DriverBase::interrupt_timestamp_ = 0;
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+	AS3935MI_VOLATILE_TYPE AS3935DriverBase::interrupt_micros_ = 0;
+#endif
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	AS3935MI_VOLATILE_TYPE AS3935DriverBase::interrupt_count_     = 0;
+
+	// Store the time micros as 32-bit int so it can be stored and comprared as an atomic operation.
+	// Expected duration will be much less than 2^32 usec, thus overflow isn't an issue here
+	AS3935MI_VOLATILE_TYPE AS3935DriverBase::calibration_start_micros_ = 0;
+	AS3935MI_VOLATILE_TYPE AS3935DriverBase::calibration_end_micros_   = 0;
+
+	uint32_t AS3935DriverBase::nr_calibration_samples_  = AS3935MI_NR_CALIBRATION_SAMPLES;
+#endif
+#endif
+
+namespace
+{
+#if !defined(AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION) && defined(AS3935MI_ENABLE_CLOCK)
+	// clock of the object the interrupt service routines are attached for
+	AS3935Clock *isr_clock_ = nullptr;
+#endif
+
+#if !defined(ESP8266) && !defined(ESP32)
+	// micros() of the Arduino core is extended to 64 bits by counting its overflows. there is only one core counter, 
+	// so all drivers without a clock set by setClock() share this state. not safe for concurrent calls from interrupts 
+	// or several tasks, ESP8266 and ESP32 use their 64 bit counter instead.
+	uint32_t micros_high_ = 0;
+	uint32_t micros_last_ = 0;
+
+	uint64_t coreMicros64()
+	{
+		const uint32_t now = micros();
+		if (now < micros_last_)
+			micros_high_++;
+		micros_last_ = now;
+
+		return (static_cast<uint64_t>(micros_high_) << 32) | now;
+	}
+#endif
+}
+
+AS3935DriverBase::AS3935DriverBase(uint8_t irq) :
+	irq_(irq),
+	tuning_cap_cache_(0),
+	mode_(AS3935DriverBase::AS3935_INTERRUPT_UNINITIALIZED)
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	, calibration_mode_edgetrigger_trigger_(AS3935MI_CALIBRATION_MODE_EDGE_TRIGGER)
+	, calibration_mode_division_ratio_(AS3935MI_LCO_DIVISION_RATIO)
+#endif
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	, calibrated_ant_cap_(-1)
+	, calibrate_all_ant_cap_(true)
+#endif
+{
+	// Setup these in the constructor body as these might not be a member 
+	// if AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION is not defined.
+	interrupt_timestamp_ = 0;
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+	interrupt_micros_ = 0;
+#endif
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	interrupt_count_     = 0;
+
+	calibration_start_micros_ = 0;
+	calibration_end_micros_   = 0;
+
+	nr_calibration_samples_  = AS3935MI_NR_CALIBRATION_SAMPLES;
+#endif
+
+	if (hasIRQ()) {
+		pinMode(irq_, INPUT);
+	}
+}
+
+AS3935DriverBase::~AS3935DriverBase()
+{
+	if (hasIRQ() && (mode_ == AS3935DriverBase::AS3935_INTERRUPT_NORMAL ||
+	    mode_ == AS3935DriverBase::AS3935_INTERRUPT_CALIBRATION)) {
+		detachInterrupt(irq_);
+	}
+}
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+void AS3935DriverBase::setFrequencyMeasureNrSamples(uint32_t nrSamples)
+{
+  nr_calibration_samples_ = nrSamples;
+}
+
+void AS3935DriverBase::setFrequencyMeasureEdgeChange(bool triggerRisingAndFalling)
+{
+	calibration_mode_edgetrigger_trigger_ = triggerRisingAndFalling ? CHANGE : RISING;
+}
+
+void AS3935DriverBase::setCalibrationDivisionRatio(uint8_t division_ratio)
+{
+    if (division_ratio <= AS3935DriverBase::division_ratio_t::AS3935_DR_128) {
+		calibration_mode_division_ratio_ = static_cast<AS3935DriverBase::division_ratio_t>(division_ratio);
+	} else {
+		calibration_mode_division_ratio_ = AS3935MI_LCO_DIVISION_RATIO;
+	}
+}
+#endif
+
+#ifdef AS3935MI_ENABLE_AFE_PROBE
+bool AS3935DriverBase::isAFEProbeRunning() const
+{
+	return afe_probe_phase_ != AS3935_AFE_PROBE_IDLE;
+}
+
+AS3935DriverBase::afe_probe_stats_t AS3935DriverBase::getAFEProbeStats(uint8_t afe_setting) const
+{
+	switch (afe_setting)
+	{
+	case AS3935_INDOORS:
+		return afe_probe_stats_[0];
+	case AS3935_OUTDOORS:
+		return afe_probe_stats_[1];
+	default:
+		return afe_probe_stats_t();
+	}
+}
+
+uint8_t AS3935DriverBase::selectAFEProbeResult() const
+{
+	const afe_probe_stats_t &indoors = afe_probe_stats_[0];
+	const afe_probe_stats_t &outdoors = afe_probe_stats_[1];
+
+	const bool indoors_ok = indoors.nf_lev <= afe_probe_max_nf_lev_;
+	const bool outdoors_ok = outdoors.nf_lev <= afe_probe_max_nf_lev_;
+
+	//prefer the setting with an acceptable sensitivity
+	if (indoors_ok != outdoors_ok)
+		return indoors_ok ? AS3935_INDOORS : AS3935_OUTDOORS;
+
+	const uint32_t load_indoors = static_cast<uint32_t>(indoors.noise_high) + indoors.disturbers;
+	const uint32_t load_outdoors = static_cast<uint32_t>(outdoors.noise_high) + outdoors.disturbers;
+
+	//on equal load prefer the higher gain if acceptable, the lower gain otherwise
+	if (load_indoors == load_outdoors)
+		return indoors_ok ? AS3935_INDOORS : AS3935_OUTDOORS;
+
+	return (load_indoors < load_outdoors) ? AS3935_INDOORS : AS3935_OUTDOORS;
+}
+#endif
+
+uint64_t AS3935DriverBase::nowMicros() const
+{
+#ifdef AS3935MI_ENABLE_CLOCK
+	if (clock_)
+		return clock_->micros64();
+#endif
+
+#if defined(ESP8266) || defined(ESP32)
+	return static_cast<uint64_t>(getMicros64());
+#else
+	return coreMicros64();
+#endif
+}
+
+
+void AS3935DriverBase::delayMicros(uint32_t usec)
+{
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	const uint32_t start = static_cast<uint32_t>(nowMicros());
+#endif
+
+#ifdef AS3935MI_ENABLE_CLOCK
+	if (clock_)
+		clock_->delayMicros(usec);
+	else
+#endif
+		delayMicroseconds(usec);
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	bus_statistics_.delay_usec += static_cast<uint32_t>(nowMicros()) - start;
+#endif
+}
+
+void AS3935DriverBase::delayMillis(uint32_t msec)
+{
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	const uint32_t start = static_cast<uint32_t>(nowMicros());
+#endif
+
+#ifdef AS3935MI_ENABLE_CLOCK
+	if (clock_)
+		clock_->delayMicros(msec * 1000ul);
+	else
+#endif
+		delay(msec);
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	bus_statistics_.delay_usec += static_cast<uint32_t>(nowMicros()) - start;
+#endif
+}
+
+#ifdef AS3935MI_ENABLE_CLOCK
+void AS3935DriverBase::setClock(AS3935Clock *clock)
+{
+	clock_ = clock;
+
+#ifndef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+	isr_clock_ = clock_;
+#endif
+}
+#endif
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+AS3935DriverBase::bus_statistics_t AS3935DriverBase::getBusStatistics() const
+{
+	bus_statistics_t statistics = bus_statistics_;
+	statistics.duration_usec = static_cast<uint32_t>(nowMicros()) - bus_statistics_start_;
+	return statistics;
+}
+
+void AS3935DriverBase::resetBusStatistics()
+{
+	bus_statistics_ = bus_statistics_t();
+	bus_statistics_start_ = static_cast<uint32_t>(nowMicros());
+}
+
+AS3935DriverBase::OperationScope::OperationScope(AS3935DriverBase *sensor) :
+	sensor_(sensor)
+{
+	if (sensor_->operation_depth_++ == 0)
+	{
+		sensor_->operation_start_ = sensor_->bus_statistics_;
+		sensor_->operation_start_usec_ = static_cast<uint32_t>(sensor_->nowMicros());
+	}
+}
+
+AS3935DriverBase::OperationScope::~OperationScope()
+{
+	if (--sensor_->operation_depth_ != 0)
+		return;
+
+	const bus_statistics_t &start = sensor_->operation_start_;
+	const bus_statistics_t &end = sensor_->bus_statistics_;
+	bus_statistics_t &operation = sensor_->operation_statistics_;
+
+	operation.reads = end.reads - start.reads;
+	operation.writes = end.writes - start.writes;
+	operation.bytes = end.bytes - start.bytes;
+	operation.bus_usec = end.bus_usec - start.bus_usec;
+	operation.delay_usec = end.delay_usec - start.delay_usec;
+	operation.duration_usec = static_cast<uint32_t>(sensor_->nowMicros()) - sensor_->operation_start_usec_;
+}
+#endif
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+uint32_t AS3935DriverBase::computeCalibratedFrequency(int32_t divider)
+{
+	switch (divider)
+	{
+		case AS3935_DIVIDER_1:
+		case AS3935_DIVIDER_16:
+		case AS3935_DIVIDER_32:
+		case AS3935_DIVIDER_64:
+		case AS3935_DIVIDER_128:
+			break;
+		default:
+			return 0ul;
+	}
+
+	// Need to copy the timestamps first as they are volatile
+	const uint32_t start = calibration_start_micros_;
+	const uint32_t end	 = calibration_end_micros_;
+
+	if ((start == 0ul) || (end == 0ul)) {
+		return 0ul;
+	}
+
+	const int32_t duration_usec = (int32_t) (end - start);
+
+	if (duration_usec <= 0l) {
+		return 0ul;
+	}
+
+	// Compute measured frequency
+	// we have duration of nr_calibration_samples_ pulses in usec, thus measured frequency is:
+	// (nr_calibration_samples_ * 1000'000) / duration in usec.
+	// Actual frequency should take the division ratio into account.
+	uint32_t scale = static_cast<uint32_t>(divider) * 1000000ul;
+	if (calibration_mode_edgetrigger_trigger_ == CHANGE) {
+		// Counting on both rising and falling edge, so actual frequency is half
+		scale >>= 1;
+	}
+
+	return scaleByRatio(nr_calibration_samples_ + 1, scale, static_cast<uint32_t>(duration_usec));
+}
+
+uint32_t AS3935DriverBase::scaleByRatio(uint32_t value, uint32_t scale, uint32_t divisor)
+{
+	// value = quotient * divisor + remainder, so value * scale / divisor = quotient * scale + remainder * scale / divisor. 
+	// the sample count is usually lower than the duration in microseconds, so the division can be skipped. 
+	uint32_t quotient = 0;
+	uint32_t remainder = value;
+	if (value >= divisor) {
+		quotient = value / divisor;
+		remainder = value % divisor;
+	}
+
+	uint32_t result = quotient * scale;
+
+	// remainder * scale / divisor by shift and subtract, one bit of scale at a time. remainder and the partial 
+	// remainder stay below divisor < 2^31, so their sum fits 32 bits.
+	uint32_t bit = 0x80000000ul;
+	while ((bit != 0) && !(scale & bit)) {
+		bit >>= 1;
+	}
+
+	uint32_t fraction = 0;
+	uint32_t partial = 0;
+	for (; bit != 0; bit >>= 1)
+	{
+		fraction <<= 1;
+		partial <<= 1;
+		if (partial >= divisor) {
+			partial -= divisor;
+			fraction++;
+		}
+
+		if (scale & bit) {
+			partial += remainder;
+			if (partial >= divisor) {
+				partial -= divisor;
+				fraction++;
+			}
+		}
+	}
+
+	return result + fraction;
+}
+#endif
+
+
+uint32_t AS3935DriverBase::getInterruptTimestamp() const { 
+	return interrupt_timestamp_; 
+}
+
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+uint32_t AS3935DriverBase::getInterruptMicros() const { 
+	return interrupt_micros_; 
+}
+#endif
+
+uint16_t AS3935DriverBase::diff(const register_snapshot_t &a, const register_snapshot_t &b) {
+	const uint8_t *x = a.registers;
+	const uint8_t *y = b.registers;
+
+	uint16_t fields = 0;
+
+	if ((x[0] ^ y[0]) & AS3935_MASK_AFE_GB)			fields |= AS3935_FIELD_AFE_GB;
+	if ((x[0] ^ y[0]) & AS3935_MASK_PWD)			fields |= AS3935_FIELD_PWD;
+	if ((x[1] ^ y[1]) & AS3935_MASK_NF_LEV)			fields |= AS3935_FIELD_NF_LEV;
+	if ((x[1] ^ y[1]) & AS3935_MASK_WDTH)			fields |= AS3935_FIELD_WDTH;
+	if ((x[2] ^ y[2]) & AS3935_MASK_CL_STAT)		fields |= AS3935_FIELD_CL_STAT;
+	if ((x[2] ^ y[2]) & AS3935_MASK_MIN_NUM_LIGH)	fields |= AS3935_FIELD_MIN_NUM_LIGH;
+	if ((x[2] ^ y[2]) & AS3935_MASK_SREJ)			fields |= AS3935_FIELD_SREJ;
+	if ((x[3] ^ y[3]) & AS3935_MASK_LCO_FDIV)		fields |= AS3935_FIELD_LCO_FDIV;
+	if ((x[3] ^ y[3]) & AS3935_MASK_MASK_DIST)		fields |= AS3935_FIELD_MASK_DIST;
+	if ((x[3] ^ y[3]) & AS3935_MASK_INT)			fields |= AS3935_FIELD_INT;
+	if (((x[4] ^ y[4]) & AS3935_MASK_S_LIG_L) || ((x[5] ^ y[5]) & AS3935_MASK_S_LIG_M) || 
+		((x[6] ^ y[6]) & AS3935_MASK_S_LIG_MM))		fields |= AS3935_FIELD_ENERGY;
+	if ((x[7] ^ y[7]) & AS3935_MASK_DISTANCE)		fields |= AS3935_FIELD_DISTANCE;
+	if ((x[8] ^ y[8]) & (AS3935_MASK_DISP_LCO | AS3935_MASK_DISP_SRCO | AS3935_MASK_DISP_TRCO))
+													fields |= AS3935_FIELD_DISPLAY;
+	if ((x[8] ^ y[8]) & AS3935_MASK_TUN_CAP)		fields |= AS3935_FIELD_TUN_CAP;
+	if (((x[9] ^ y[9]) & AS3935_MASK_TRCO_CALIB_ALL) || ((x[10] ^ y[10]) & AS3935_MASK_SRCO_CALIB_ALL))
+													fields |= AS3935_FIELD_RCO_CALIBRATION;
+
+	return fields;
+}
+
+#ifdef AS3935MI_ENABLE_LOCKING
+void AS3935DriverBase::readCachedView(cached_view_t &view) const {
+	cache_t cache;
+	cache_.read(cache, lock_);
+
+	view.afe = getMaskedBits(cache.registers[AS3935_REGISTER_AFE_GB], AS3935_MASK_AFE_GB);
+	view.power_down = getMaskedBits(cache.registers[AS3935_REGISTER_PWD], AS3935_MASK_PWD) != 0;
+	view.noise_floor = getMaskedBits(cache.registers[AS3935_REGISTER_NF_LEV], AS3935_MASK_NF_LEV);
+	view.watchdog_threshold = getMaskedBits(cache.registers[AS3935_REGISTER_WDTH], AS3935_MASK_WDTH);
+	view.spike_rejection = getMaskedBits(cache.registers[AS3935_REGISTER_SREJ], AS3935_MASK_SREJ);
+	view.min_lightnings = getMaskedBits(cache.registers[AS3935_REGISTER_MIN_NUM_LIGH], AS3935_MASK_MIN_NUM_LIGH);
+	view.mask_disturbers = getMaskedBits(cache.registers[AS3935_REGISTER_MASK_DIST], AS3935_MASK_MASK_DIST) != 0;
+	view.division_ratio = getMaskedBits(cache.registers[AS3935_REGISTER_LCO_FDIV], AS3935_MASK_LCO_FDIV);
+	view.tuning = getMaskedBits(cache.registers[4], AS3935_MASK_TUN_CAP);
+	view.event = cache.event;
+	view.events = cache.events;
+}
+
+void AS3935DriverBase::resetCachedRegisters() {
+	//register defaults, see datasheet p. 18
+	cache_t &cache = cache_.beginWrite();
+	cache.registers[0] = 0x24;
+	cache.registers[1] = 0x22;
+	cache.registers[2] = 0xC2;
+	cache.registers[3] = 0x00;
+	cache.registers[4] = 0x00;
+	cache_.endWrite();
+}
+
+void AS3935DriverBase::updateCachedEvent(const AS3935Event &event) {
+	cache_t &cache = cache_.beginWrite();
+	cache.event = event;
+	cache.events++;
+	cache_.endWrite();
+}
+#endif
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+void AS3935DriverBase::resetIntegrityStatistics() {
+	integrity_statistics_ = integrity_statistics_t();
+}
+#endif
+
+uint32_t AS3935DriverBase::waitForEvent(uint32_t timeout_ms) {
+	if (!hasIRQ() || (mode_ != AS3935DriverBase::AS3935_INTERRUPT_NORMAL)) {
+		return 0;
+	}
+
+	const uint32_t start = nowMillis();
+
+	while (interrupt_timestamp_ == 0) {
+		// the IRQ pin stays high until the interrupt register is read. the edge may have been missed while 
+		// the MCU was sleeping, e.g. in light sleep on ESP32.
+		if (latchPendingInterrupt()) {
+			break;
+		}
+
+		if (timeout_ms == UINT32_MAX) {
+			sleepUntilInterrupt(UINT32_MAX);
+			continue;
+		}
+
+		const uint32_t elapsed = nowMillis() - start;
+		if (elapsed >= timeout_ms) {
+			break;
+		}
+
+		sleepUntilInterrupt(timeout_ms - elapsed);
+	}
+
+	return interrupt_timestamp_;
+}
+
+void AS3935DriverBase::sleepUntilInterrupt(uint32_t timeout_ms) {
+#if defined(ESP32)
+	// a high level wakeup would retrigger the interrupt handler until the interrupt register is read, so the 
+	// pin interrupt attached in AS3935_INTERRUPT_NORMAL mode is disabled while sleeping. waitForEvent() checks 
+	// the pin level after waking up.
+	const gpio_num_t pin = static_cast<gpio_num_t>(irq_);
+	const bool attached = (mode_ == AS3935DriverBase::AS3935_INTERRUPT_NORMAL);
+	if (attached) {
+		gpio_intr_disable(pin);
+	}
+
+	// only the wakeup sources enabled here are disabled afterwards, others set up by the application are kept. 
+	// ESP-IDF can not report whether the timer wakeup is already in use, so it is not touched for an infinite 
+	// timeout (UINT32_MAX).
+	const bool timer = (timeout_ms != UINT32_MAX);
+	gpio_wakeup_enable(pin, GPIO_INTR_HIGH_LEVEL);
+	esp_sleep_enable_gpio_wakeup();
+	if (timer) {
+		esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(timeout_ms) * 1000ull);
+	}
+
+	esp_light_sleep_start();
+
+	if (timer) {
+		esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+	}
+	gpio_wakeup_disable(pin);
+
+	// gpio_wakeup_disable() clears the interrupt type of the pin, restore the rising edge used by interruptISR()
+	if (attached) {
+		gpio_set_intr_type(pin, GPIO_INTR_POSEDGE);
+		gpio_intr_enable(pin);
+	}
+#elif defined(__AVR__)
+	// idle mode is left by any interrupt, including the timer 0 overflow keeping millis() running, so the 
+	// timeout is checked by waitForEvent(). deeper modes stop millis() and can only be left by level interrupts.
+	(void)timeout_ms;
+
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	noInterrupts();
+	if (interrupt_timestamp_ == 0) {
+		sleep_enable();
+		// the instruction following sei is executed before any pending interrupt, so the interrupt can not be 
+		// handled between the check above and going to sleep
+		interrupts();
+		sleep_cpu();
+		sleep_disable();
+	}
+	interrupts();
+#elif defined(ARDUINO_ARCH_HOST)
+	hostWaitForPin(irq_, HIGH, static_cast<uint64_t>(timeout_ms) * 1000000ull);
+#else
+	(void)timeout_ms;
+	yield();
+#endif
+}
+
+bool AS3935DriverBase::latchPendingInterrupt() {
+	if (!hasIRQ() || (digitalRead(irq_) != HIGH)) {
+		return false;
+	}
+
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+	interruptISR(this);
+#else
+	interruptISR();
+#endif
+
+	return true;
+}
+
+void AS3935DriverBase::setInterruptMode(interrupt_mode_t mode) {
+	if (mode_ == mode) {
+		return;
+	}
+
+	// without IRQ pin only the mode is tracked
+	if (!hasIRQ()) {
+		interrupt_timestamp_ = 0;
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+		interrupt_micros_	 = 0;
+#endif
+		mode_				 = mode;
+		return;
+	}
+
+	if (mode_ == AS3935DriverBase::AS3935_INTERRUPT_NORMAL ||
+	    mode_ == AS3935DriverBase::AS3935_INTERRUPT_CALIBRATION) {
+		detachInterrupt(irq_);
+	}
+
+	// set the IRQ pin as an input pin. do not use INPUT_PULLUP - the AS3935 will pull the pin
+	// high if an event is registered.
+	pinMode(irq_, INPUT);
+
+	interrupt_timestamp_ = 0;
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+	interrupt_micros_	 = 0;
+#endif
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	interrupt_count_	 = 0;
+#endif
+	mode_				 = mode;
+
+#if defined(AS3935MI_ENABLE_CLOCK) && !defined(AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION)
+	isr_clock_ = clock_;
+#endif
+
+	switch (mode) {
+		case interrupt_mode_t::AS3935_INTERRUPT_UNINITIALIZED:
+		case interrupt_mode_t::AS3935_INTERRUPT_DETACHED:
+			break;
+		case interrupt_mode_t::AS3935_INTERRUPT_NORMAL:
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+			attachInterruptArg(digitalPinToInterrupt(irq_),
+							   reinterpret_cast<void (*)(void *)>(interruptISR),
+							   this,
+							   RISING);
+#else
+			attachInterrupt(digitalPinToInterrupt(irq_),
+							interruptISR,
+					   		RISING);
+#endif
+			break;
+		case interrupt_mode_t::AS3935_INTERRUPT_CALIBRATION:
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+			calibration_start_micros_ = 0;
+			calibration_end_micros_	 = 0;
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+			attachInterruptArg(digitalPinToInterrupt(irq_),
+							   reinterpret_cast<void (*)(void *)>(calibrateISR),
+							   this,
+							   calibration_mode_edgetrigger_trigger_);
+#else
+			attachInterrupt(digitalPinToInterrupt(irq_),
+							calibrateISR,
+					   		calibration_mode_edgetrigger_trigger_);
+#endif
+#endif
+			break;
+	}
+}
+
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+void AS3935MI_IRAM_ATTR AS3935DriverBase::interruptISR(AS3935DriverBase *self) {
+#ifdef AS3935MI_ENABLE_CLOCK
+	if (self->clock_) {
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+		self->interrupt_micros_ = static_cast<uint32_t>(self->clock_->micros64());
+#endif
+		self->interrupt_timestamp_ = static_cast<uint32_t>(self->clock_->millis64());
+		return;
+	}
+#endif
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+	self->interrupt_micros_ = micros();
+#endif
+	self->interrupt_timestamp_ = millis();
+}
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+void AS3935MI_IRAM_ATTR AS3935DriverBase::calibrateISR(AS3935DriverBase *self) {
+	// interrupt_count_ is volatile, so we can miss when testing for exactly nr_calibration_samples_
+	if (self->interrupt_count_ < self->nr_calibration_samples_) {
+		++self->interrupt_count_;
+	}
+	else if (self->calibration_end_micros_ == 0ul) {
+#ifdef AS3935MI_ENABLE_CLOCK
+		if (self->clock_) {
+			self->calibration_end_micros_ = static_cast<uint32_t>(self->clock_->micros64());
+			return;
+		}
+#endif
+		self->calibration_end_micros_ = static_cast<uint32_t>(getMicros64());
+	}
+}
+#endif
+#else
+void AS3935MI_IRAM_ATTR AS3935DriverBase::interruptISR() {
+#ifdef AS3935MI_ENABLE_CLOCK
+	if (isr_clock_) {
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+		interrupt_micros_ = static_cast<uint32_t>(isr_clock_->micros64());
+#endif
+		interrupt_timestamp_ = static_cast<uint32_t>(isr_clock_->millis64());
+		return;
+	}
+#endif
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+	interrupt_micros_ = micros();
+#endif
+	interrupt_timestamp_ = millis();
+}
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+void AS3935MI_IRAM_ATTR AS3935DriverBase::calibrateISR() {
+	// interrupt_count_ is volatile, so we can miss when testing for exactly nr_calibration_samples_
+	if (interrupt_count_ < nr_calibration_samples_) {
+		++interrupt_count_;
+	}
+	else if (calibration_end_micros_ == 0ul) {
+#ifdef AS3935MI_ENABLE_CLOCK
+		if (isr_clock_) {
+			calibration_end_micros_ = static_cast<uint32_t>(isr_clock_->micros64());
+			return;
+		}
+#endif
+		calibration_end_micros_ = static_cast<uint32_t>(getMicros64());
+	}
+}
+#endif
+#endif
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_TABLE
+int32_t  AS3935DriverBase::getAntCapFrequency(uint8_t tuningCapacitance) const
+{
+	constexpr unsigned int nrElements = sizeof(calibration_frequencies_) / sizeof(calibration_frequencies_[0]);
+	if (tuningCapacitance < nrElements) {
+#ifdef AS3935MI_COMPACT_FREQUENCY_TABLE
+		const uint16_t value = calibration_frequencies_[tuningCapacitance];
+		if (value == 0) {
+			return 0;
+		}
+		return 500000l + (static_cast<int32_t>(value) - 0x8000l) * 8l;
+#else
+		return calibration_frequencies_[tuningCapacitance];
+#endif
+	}
+	return -1;
+}
+
+void AS3935DriverBase::setAntCapFrequency(uint8_t tuningCapacitance, uint32_t frequency)
+{
+	constexpr unsigned int nrElements = sizeof(calibration_frequencies_) / sizeof(calibration_frequencies_[0]);
+	if (tuningCapacitance >= nrElements) {
+		return;
+	}
+
+#ifdef AS3935MI_COMPACT_FREQUENCY_TABLE
+	if (frequency == 0) {
+		calibration_frequencies_[tuningCapacitance] = 0;
+		return;
+	}
+
+	// Round to the nearest step of 8 Hz, frequencies out of range are limited to the first / last step
+	int32_t offset = (static_cast<int32_t>(frequency) - 500000l + 4l) >> 3;
+	if (offset < -0x7FFFl) {
+		offset = -0x7FFFl;
+	} else if (offset > 0x7FFFl) {
+		offset = 0x7FFFl;
+	}
+	calibration_frequencies_[tuningCapacitance] = static_cast<uint16_t>(offset + 0x8000l);
+#else
+	calibration_frequencies_[tuningCapacitance] = frequency;
+#endif
+}
+#endif
\ No newline at end of file
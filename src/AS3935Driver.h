@@ -0,0 +1,2790 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935DRIVER_H_
+#define AS3935DRIVER_H_
+
+#include <Arduino.h>
+
+#include "AS3935Clock.h"
+#include "AS3935Event.h"
+#include "AS3935Lock.h"
+
+#if defined(ESP8266) || defined(ESP32) || defined(ARDUINO_HOST_HAS_ATTACHINTERRUPTARG)
+// When we can't use attachInterruptArg to directly access volatile members,
+// we must use static members
+// This means only a single instance of this class can be used.
+//
+// When we can use attachInterruptArg, we can use volatile members 
+// and thus have multiple instances of this class without jumping through hoops
+// to avoid issues sharing volatile variables
+
+#define AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+#endif
+
+#if defined(ESP8266) || defined(ESP32)
+#define AS3935MI_IRAM_ATTR IRAM_ATTR
+#endif
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+# include <atomic>
+#endif
+
+#ifndef AS3935MI_IRAM_ATTR 
+// Define this attribute as empty for platforms that don't need a special
+// IRAM_ATTR for ISR callback functions
+#define AS3935MI_IRAM_ATTR 
+#endif
+
+// Define AS3935MI_ENABLE_BUS_STATISTICS (e.g. as a build flag) to count register accesses, bytes
+// transferred, bus time and blocking delay time. When not defined, the counters are compiled out entirely.
+// Define AS3935MI_ENABLE_CLOCK to enable setClock(), which routes all timestamps and delays through an AS3935Clock
+// object. When not defined, the Arduino core functions are called directly.
+// Define AS3935MI_ENABLE_AFE_PROBE to enable beginAFEProbe(), which selects the AFE gain boost setting from the 
+// interrupt load observed with both settings. 
+// Define AS3935MI_ENABLE_SUSPEND to enable suspend() / resume(), which power the sensor down and restore its settings.
+// Define AS3935MI_ENABLE_INTEGRITY_CHECK to enable setIntegrityCheckInterval(), which detects and restores a 
+// configuration lost to a reset of the sensor. 
+// Define AS3935MI_ENABLE_INTERRUPT_MICROS to enable getInterruptMicros(), the interrupt time in microseconds.
+// Define AS3935MI_ENABLE_LOCKING to use a sensor from several tasks (FreeRTOS on ESP32, threads in the host build): 
+// every bus transaction and read-modify-write holds a mutex, operations that display an oscillator on the IRQ pin or 
+// calibrate hold it for their whole duration, multi-register operations without delays for their register accesses 
+// (see README). readCachedView() then returns the configuration and the last event without taking the mutex or 
+// accessing the bus. 
+//
+// Define AS3935MI_DISABLE_FREQUENCY_MEASUREMENT to remove the measurement of the LCO, SRCO and TRCO frequencies on the 
+// IRQ pin (checkIRQ(), measureResonanceFrequency(), validateCurrentResonanceFrequency()), its interrupt service routine 
+// and settings. Implies AS3935MI_DISABLE_CALIBRATION and AS3935MI_DISABLE_FREQUENCY_TABLE.
+// Define AS3935MI_DISABLE_CALIBRATION to remove the resonance frequency calibration (calibrateResonanceFrequency()), 
+// getCalibratedAntCap() then returns -1.
+// Define AS3935MI_DISABLE_FREQUENCY_TABLE to remove the frequencies measured per tuning capacitor, getAntCapFrequency() 
+// then returns -1. Define AS3935MI_COMPACT_FREQUENCY_TABLE to store them in 16 bit instead of 32 bit, with a 
+// resolution of 8 Hz within 500 kHz +- 262 kHz.
+//
+// All of these defines change the layout of the driver classes. Set them as build flags for every translation unit 
+// (build_flags in platformio.ini, compiler.cpp.extra_flags with arduino-cli), a #define in a sketch does not reach 
+// the library sources and the sketch and the library then disagree on the size and members of a sensor object.
+
+#ifdef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+# ifndef AS3935MI_DISABLE_CALIBRATION
+#  define AS3935MI_DISABLE_CALIBRATION
+# endif
+# ifndef AS3935MI_DISABLE_FREQUENCY_TABLE
+#  define AS3935MI_DISABLE_FREQUENCY_TABLE
+# endif
+#endif
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+#define AS3935MI_OPERATION() AS3935DriverBase::OperationScope as3935mi_operation_scope_(this)
+#else
+#define AS3935MI_OPERATION()
+#endif
+
+#ifdef AS3935MI_ENABLE_LOCKING
+#define AS3935MI_LOCK() AS3935LockGuard as3935mi_lock_(lock_)
+#else
+#define AS3935MI_LOCK()
+#endif
+
+// Allow for 3.5% deviation
+# define AS3935MI_ALLOWED_DEVIATION    0.035f
+
+// Nominal supply voltage and currents of the AS3935 (datasheet: 60uA listening, 1uA power down), used to estimate the
+// energy of resume(). Define them (e.g. as build flags) to match the board.
+#ifndef AS3935MI_SUPPLY_MV
+# define AS3935MI_SUPPLY_MV                3300ul
+#endif
+#ifndef AS3935MI_LISTENING_CURRENT_UA
+# define AS3935MI_LISTENING_CURRENT_UA     60ul
+#endif
+#ifndef AS3935MI_POWER_DOWN_CURRENT_UA
+# define AS3935MI_POWER_DOWN_CURRENT_UA    1ul
+#endif
+
+// Number of TRCO edges selfTest() waits for on the IRQ pin, and the maximum time it waits for them. 16 edges of the 
+// 32.768 kHz TRCO take 0.5 ms when counting rising edges. 
+#ifndef AS3935MI_SELF_TEST_EDGES
+# define AS3935MI_SELF_TEST_EDGES          16ul
+#endif
+#ifndef AS3935MI_SELF_TEST_TIMEOUT_US
+# define AS3935MI_SELF_TEST_TIMEOUT_US     2000ul
+#endif
+
+// Division ratio and nr of samples chosen so we expect a
+// 500 kHz LCO measurement to take about 18 msec on ESP32
+// On others it will take about 32 msec.
+// ESP8266 can't handle > 20 kHz interrupt calls very well, 
+// therefore set to DR_32 and edge trigger to "RISING"
+# ifdef ESP32
+
+// Expected LCO frequency for DR_16 = 31250 Hz
+#  define AS3935MI_LCO_DIVISION_RATIO AS3935DriverBase::AS3935_DR_16
+#  define AS3935MI_NR_CALIBRATION_SAMPLES 1000ul
+#  define AS3935MI_CALIBRATION_MODE_EDGE_TRIGGER  CHANGE
+# else // ifdef ESP32
+
+// Expected LCO frequency for DR_32 = 15625 Hz
+#  define AS3935MI_LCO_DIVISION_RATIO AS3935DriverBase::AS3935_DR_32
+#  define AS3935MI_NR_CALIBRATION_SAMPLES  500ul
+#  define AS3935MI_CALIBRATION_MODE_EDGE_TRIGGER  RISING
+# endif // ifdef ESP32
+
+//sensor state and the parts of the driver that do not access the bus. shared by all AS3935Driver<Bus> instantiations, 
+//so the interrupt handling, time keeping and bookkeeping code exists only once. 
+class AS3935DriverBase
+{
+public:
+	enum afe_setting_t : uint8_t
+	{
+		AS3935_INDOORS = 0b10010,
+		AS3935_OUTDOORS = 0b01110
+	};
+
+	enum interrupt_name_t : uint8_t
+	{
+		AS3935_INT_DUPDATE = 0b0000,//distance estimation has changed due to purging of old events in the statistics, based on the lightning distance estimation algorithm.
+		AS3935_INT_NH = 0b0001,		//noise level too high
+		AS3935_INT_D = 0b0100,		//disturber detected
+		AS3935_INT_L = 0b1000		//lightning interrupt
+	};
+
+	enum wdth_setting_t : uint8_t
+	{
+		AS3935_WDTH_0 = 0b0000,
+		AS3935_WDTH_1 = 0b0001,
+		AS3935_WDTH_2 = 0b0010,
+		AS3935_WDTH_3 = 0b0011,
+		AS3935_WDTH_4 = 0b0100,
+		AS3935_WDTH_5 = 0b0101,
+		AS3935_WDTH_6 = 0b0110,
+		AS3935_WDTH_7 = 0b0111,
+		AS3935_WDTH_8 = 0b1000,
+		AS3935_WDTH_9 = 0b1001,
+		AS3935_WDTH_10 = 0b1010,
+		AS3935_WDTH_11 = 0b1011,
+		AS3935_WDTH_12 = 0b1100,
+		AS3935_WDTH_13 = 0b1101,
+		AS3935_WDTH_14 = 0b1110,
+		AS3935_WDTH_15 = 0b1111
+	};
+
+	enum srej_setting_t : uint8_t
+	{
+		AS3935_SREJ_0 = 0b0000,
+		AS3935_SREJ_1 = 0b0001,
+		AS3935_SREJ_2 = 0b0010,
+		AS3935_SREJ_3 = 0b0011,
+		AS3935_SREJ_4 = 0b0100,
+		AS3935_SREJ_5 = 0b0101,
+		AS3935_SREJ_6 = 0b0110,
+		AS3935_SREJ_7 = 0b0111,
+		AS3935_SREJ_8 = 0b1000,
+		AS3935_SREJ_9 = 0b1001,
+		AS3935_SREJ_10 = 0b1010, 
+		AS3935_SREJ_11 = 0b1011, 
+		AS3935_SREJ_12 = 0b1100, 
+		AS3935_SREJ_13 = 0b1101, 
+		AS3935_SREJ_14 = 0b1110, 
+		AS3935_SREJ_15 = 0b1111
+	};
+
+	enum noise_floor_threshold_t : uint8_t
+	{
+		AS3935_NFL_0 = 0b000,
+		AS3935_NFL_1 = 0b001,
+		AS3935_NFL_2 = 0b010,		//default
+		AS3935_NFL_3 = 0b011,
+		AS3935_NFL_4 = 0b100,
+		AS3935_NFL_5 = 0b101,
+		AS3935_NFL_6 = 0b110,
+		AS3935_NFL_7 = 0b111,
+	};
+
+	enum min_num_lightnings_t : uint8_t
+	{
+		AS3935_MNL_1 = 0b00,		//minimum number of lightnings: 1
+		AS3935_MNL_5 = 0b01,		//minimum number of lightnings: 5
+		AS3935_MNL_9 = 0b10,		//minimum number of lightnings: 9
+		AS3935_MNL_16 = 0b11,		//minimum number of lightnings: 16
+	};
+
+	enum division_ratio_t : uint8_t
+	{
+		AS3935_DR_16 = 0b00,
+		AS3935_DR_32 = 0b01,
+		AS3935_DR_64 = 0b10,
+		AS3935_DR_128 = 0b11
+	};
+
+	
+	enum class display_frequency_source_t {
+		LCO, // 500 kHz resonance freq
+		SRCO, // 1.1 MHz signal
+		TRCO // 32768 Hz signal
+	};
+
+	static const uint8_t AS3935_DST_OOR = 0b111111;		//detected lightning was out of range
+
+	//pass as irq if the IRQ pin is not connected. interrupts are not available, events can be read with 
+	//AS3935Poller. frequency measurements and the resonance frequency calibration are not supported and fail.
+	static const uint8_t AS3935_NO_IRQ = 0xFF;
+
+	struct bus_statistics_t
+	{
+		uint32_t reads;				//number of register reads
+		uint32_t writes;			//number of register writes, including direct commands
+		uint32_t bytes;				//number of register address and data bytes transferred
+		uint32_t bus_usec;			//time spent reading and writing registers in microseconds
+		uint32_t delay_usec;		//time spent in blocking delays in microseconds
+		uint32_t duration_usec;		//total time in microseconds
+	};
+
+	static const uint8_t AS3935_SNAPSHOT_SIZE = 11;
+
+	//register contents read by readSnapshot(): registers 0x00 - 0x08 at index 0 - 8, the calibration status registers 
+	//0x3A and 0x3B at index 9 and 10
+	struct register_snapshot_t
+	{
+		uint8_t registers[AS3935_SNAPSHOT_SIZE];
+	};
+
+	//fields of a register snapshot, combined into the bit mask returned by diff()
+	enum snapshot_field_t : uint16_t
+	{
+		AS3935_FIELD_AFE_GB = 0x0001,
+		AS3935_FIELD_PWD = 0x0002,
+		AS3935_FIELD_NF_LEV = 0x0004,
+		AS3935_FIELD_WDTH = 0x0008,
+		AS3935_FIELD_CL_STAT = 0x0010,
+		AS3935_FIELD_MIN_NUM_LIGH = 0x0020,
+		AS3935_FIELD_SREJ = 0x0040,
+		AS3935_FIELD_LCO_FDIV = 0x0080,
+		AS3935_FIELD_MASK_DIST = 0x0100,
+		AS3935_FIELD_INT = 0x0200,
+		AS3935_FIELD_ENERGY = 0x0400,			//registers 0x04 - 0x06
+		AS3935_FIELD_DISTANCE = 0x0800,
+		AS3935_FIELD_DISPLAY = 0x1000,			//DISP_LCO, DISP_SRCO and DISP_TRCO
+		AS3935_FIELD_TUN_CAP = 0x2000,
+		AS3935_FIELD_RCO_CALIBRATION = 0x4000	//TRCO and SRCO calibration status
+	};
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	enum integrity_result_t : uint8_t
+	{
+		AS3935_INTEGRITY_IDLE,			//no check done: disabled, not due, interrupt pending or sensor suspended
+		AS3935_INTEGRITY_OK,			//the configuration of the sensor is as expected
+		AS3935_INTEGRITY_RESTORED,		//the configuration was lost, e.g. by a brownout reset, and has been restored
+		AS3935_INTEGRITY_FAILED			//the registers could not be read or the RCO calibration failed after restoring
+	};
+#endif
+
+	enum self_test_failure_t : uint8_t
+	{
+		AS3935_SELF_TEST_CONNECTION = 0x01,		//the AFE gain boost setting is invalid: not connected or bus failure
+		AS3935_SELF_TEST_POWERED_DOWN = 0x02,	//the sensor is powered down
+		AS3935_SELF_TEST_TRCO = 0x04,			//the TRCO is not calibrated or its calibration failed
+		AS3935_SELF_TEST_SRCO = 0x08,			//the SRCO is not calibrated or its calibration failed
+		AS3935_SELF_TEST_IRQ = 0x10				//too few edges of the TRCO were seen on the IRQ pin
+	};
+
+	enum begin_result_t : uint8_t
+	{
+		AS3935_BEGIN_FAILED,		//the bus could not be initialized
+		AS3935_BEGIN_COLD,			//the sensor has been reset to its defaults, as by begin()
+		AS3935_BEGIN_WARM			//the sensor was already configured and has been taken over without a reset
+	};
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	struct integrity_statistics_t
+	{
+		uint32_t checks;			//number of integrity checks
+		uint32_t restored;			//number of lost configurations detected and restored
+		uint32_t failures;			//number of checks returning AS3935_INTEGRITY_FAILED
+		uint32_t check_usec;		//duration of the last check without restoring, in microseconds
+		uint32_t total_usec;		//time spent in checks including restoring, in microseconds
+		uint32_t detection_ms;		//time between the last check finding the configuration as expected and the detection 
+									//of the last lost configuration, upper bound of the detection latency
+	};
+#endif
+
+#ifdef AS3935MI_ENABLE_SUSPEND
+	struct resume_statistics_t
+	{
+		uint32_t resume_usec;		//duration of the last resume() in microseconds
+		uint32_t resume_nj;			//estimated energy the sensor consumed during the last resume() in nanojoules
+		uint32_t suspended_ms;		//time powered down before the last resume() in milliseconds
+		uint32_t saved_uj;			//estimated energy saved by powering down instead of listening, in microjoules
+		int32_t frequency;			//resonance frequency measured by the last resume(), 0 if not checked
+	};
+#endif
+
+	//configuration and last event as last seen on the bus, see readCachedView()
+	struct cached_view_t
+	{
+		uint8_t afe;				//AFE gain boost setting as afe_setting_t
+		bool power_down;
+		uint8_t noise_floor;		//noise floor threshold as noise_floor_threshold_t
+		uint8_t watchdog_threshold;	//watchdog threshold as wdth_setting_t
+		uint8_t spike_rejection;	//spike rejection as srej_setting_t
+		uint8_t min_lightnings;		//minimum number of lightnings as min_num_lightnings_t
+		bool mask_disturbers;
+		uint8_t division_ratio;		//antenna tuning division ratio as division_ratio_t
+		uint8_t tuning;				//tuning capacitor setting
+		AS3935Event event;			//last event read by readEvent()
+		uint32_t events;			//number of events read by readEvent()
+	};
+
+#ifdef AS3935MI_ENABLE_AFE_PROBE
+	struct afe_probe_stats_t
+	{
+		uint16_t noise_high;		//number of noise level too high interrupts during the probing window
+		uint16_t disturbers;		//number of disturber interrupts during the probing window
+		uint16_t lightnings;		//number of lightning interrupts during the probing window
+		uint8_t nf_lev;				//noise floor threshold setting at the end of the probing window
+	};
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	enum calibration_phase_t : uint8_t
+	{
+		AS3935_CALIBRATION_COARSE,		//estimating the tuning capacitor setting from settings 0 and 15
+		AS3935_CALIBRATION_FINE,		//measuring the settings around the estimate with the full number of samples
+		AS3935_CALIBRATION_DONE
+	};
+
+	//state of a resonance frequency calibration in progress, used to calibrate several sensors at once (see AS3935Array)
+	struct calibration_state_t
+	{
+		uint8_t phase;				//calibration_phase_t
+		uint8_t attempt;			//remaining attempts to estimate the tuning capacitor setting
+		uint8_t cap;				//tuning capacitor setting being measured
+		uint8_t lowest_cap;			//range of tuning capacitor settings to measure with the full number of samples
+		uint8_t highest_cap;
+		int8_t best_cap;
+		uint32_t best_diff;
+		int32_t frequency;			//frequency of best_cap
+		int32_t freq_0;				//frequency measured with tuning capacitor setting 0
+		uint32_t nr_samples;		//number of samples set by the user
+		int32_t divider;			//divider of the measurement in progress, 0 if it could not be started
+		uint64_t timeout;			//end of the measurement in progress in microseconds
+		bool success;
+	};
+#endif
+
+	enum interrupt_mode_t {
+		AS3935_INTERRUPT_UNINITIALIZED,
+		AS3935_INTERRUPT_DETACHED,
+		AS3935_INTERRUPT_NORMAL,
+		AS3935_INTERRUPT_CALIBRATION
+	};
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+    // Set the number of samples counted during frequency measurements.
+	void setFrequencyMeasureNrSamples(uint32_t nrSamples);
+
+	// Set the edge mode trigger for any frequency measurement to either RISING or CHANGE
+	void setFrequencyMeasureEdgeChange(bool triggerRisingAndFalling);
+
+    // Set the division ratio, only used when measuring LCO (thus only during calibration)
+	void setCalibrationDivisionRatio(uint8_t division_ratio);
+
+	// Return the division ratio used when measuring LCO, as division_ratio_t
+	uint8_t getCalibrationDivisionRatio() const {
+		return calibration_mode_division_ratio_;
+	}
+#endif
+
+#ifdef AS3935MI_ENABLE_AFE_PROBE
+	/*
+	@return true if an AFE gain boost probe is in progress, false otherwise. */
+	bool isAFEProbeRunning() const;
+
+	/*
+	@return AFE setting selected by the last completed probe as afe_setting_t, 0 if no probe has completed. 
+	can be stored in non volatile memory and restored with writeAFE() on startup. */
+	uint8_t getAFEProbeResult() const {
+		return afe_probe_result_;
+	}
+
+	/*
+	@param afe_setting AFE setting as afe_setting_t.
+	@return statistics collected for the given AFE setting during the last probe. */
+	afe_probe_stats_t getAFEProbeStats(uint8_t afe_setting) const;
+#endif
+
+#ifdef AS3935MI_ENABLE_CLOCK
+	/*
+	sets the time source used for timestamps and delays. 
+	@param clock clock to use, nullptr to use the Arduino core functions. must stay valid while in use. */
+	void setClock(AS3935Clock *clock);
+
+	/*
+	@return clock set with setClock(), nullptr if the Arduino core functions are used. */
+	AS3935Clock *getClock() const {
+		return clock_;
+	}
+#endif
+
+#ifdef AS3935MI_ENABLE_LOCKING
+	/*
+	returns the configuration and the last event without taking the mutex or accessing the bus, e.g. for a telemetry 
+	task while another task reads events. the configuration is updated by every register access of the driver and 
+	reset to the defaults by resetToDefaults(), so it is only valid after begin(). retries while another task updates 
+	it, after a few retries waits for the mutex. 
+	@param view (by reference, write only) consistent copy of the cached configuration and last event. */
+	void readCachedView(cached_view_t &view) const;
+#endif
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	/*
+	@return bus statistics accumulated since the last call to resetBusStatistics(). */
+	bus_statistics_t getBusStatistics() const;
+
+	/*
+	@return bus statistics of the last completed public function call, e.g. begin() or calibrateResonanceFrequency(). */
+	bus_statistics_t getOperationStatistics() const {
+		return operation_statistics_;
+	}
+
+	/*
+	resets the accumulated bus statistics. */
+	void resetBusStatistics();
+
+	//collects the bus statistics of a public function call. nested calls are accounted to the outermost call.
+	class OperationScope
+	{
+	public:
+		OperationScope(AS3935DriverBase *sensor);
+		~OperationScope();
+
+	private:
+		AS3935DriverBase *sensor_;
+	};
+#endif
+
+	/*
+	compares two register snapshots, e.g. a snapshot taken after configuring the sensor and a later one. 
+	@param a, b snapshots to compare.
+	@return fields that differ as a combination of snapshot_field_t, 0 if the snapshots are equal. */
+	static uint16_t diff(const register_snapshot_t &a, const register_snapshot_t &b);
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	/*
+	@return statistics of the integrity checks since the last call of resetIntegrityStatistics(). */
+	integrity_statistics_t getIntegrityStatistics() const {
+		return integrity_statistics_;
+	}
+
+	/*
+	resets the statistics of the integrity checks. */
+	void resetIntegrityStatistics();
+#endif
+
+#ifdef AS3935MI_ENABLE_SUSPEND
+	/*
+	@return true if the sensor has been powered down by suspend() and not yet resumed. */
+	bool isSuspended() const {
+		return suspended_;
+	}
+
+	/*
+	@return latency and estimated energy of the last resume(). */
+	resume_statistics_t getResumeStatistics() const {
+		return resume_statistics_;
+	}
+#endif
+
+	interrupt_mode_t      getInterruptMode() const { return mode_; }
+
+	/*
+	@return true if the IRQ pin is connected, false if the object was constructed with AS3935_NO_IRQ. */
+	bool                  hasIRQ() const { return irq_ != AS3935_NO_IRQ; }
+
+	/*
+	@return IRQ pin the object was constructed with, AS3935_NO_IRQ if not connected. */
+	uint8_t               getIrqPin() const { return irq_; }
+
+	uint32_t              getInterruptTimestamp() const;
+
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+	/*
+	@return time of the last interrupt in AS3935_INTERRUPT_NORMAL mode in microseconds (lower 32 bits), e.g. to 
+	correlate the events of several sensors. unlike getInterruptTimestamp() not cleared by readInterruptSource(), so it 
+	can be read after readEvent(). 0 if no interrupt occurred since the interrupt mode was set. */
+	uint32_t              getInterruptMicros() const;
+#endif
+
+	/*
+	waits for an interrupt in AS3935_INTERRUPT_NORMAL mode instead of polling getInterruptTimestamp(). the MCU sleeps in 
+	the lightest sleep mode the IRQ pin can wake it from: light sleep with GPIO wakeup on ESP32, idle mode on AVR. other 
+	cores yield. on the host build the wait is a condition variable wait, or advances the virtual time. returns 
+	immediately if an interrupt is pending. the event must be read afterwards, e.g. with readEvent(), not earlier than 
+	2ms after the interrupt. 
+	@param timeout_ms maximum time to wait in milliseconds, UINT32_MAX to wait without timeout (on ESP32 the timer 
+	wakeup source is then left to the application). 
+	@return interrupt timestamp as returned by getInterruptTimestamp(), 0 on timeout, if the IRQ pin is not connected or 
+	if not in AS3935_INTERRUPT_NORMAL mode. */
+	uint32_t              waitForEvent(uint32_t timeout_ms);
+
+	void                  setInterruptMode(interrupt_mode_t mode);
+
+	/*
+	@return current time in microseconds from the clock set with setClock() or the Arduino core. on cores without a 
+	64 bit microsecond counter micros() is extended by counting its overflows, shared by all drivers using the core 
+	counter: wrap safe as long as one of them calls it at least once per micros() overflow period. */
+	uint64_t nowMicros() const;
+
+	/*
+	@return current time in milliseconds, lower 32 bits. */
+	uint32_t nowMillis() const;
+
+	/*
+	blocking delay using the clock set with setClock() or the Arduino core, counted if bus statistics are enabled. 
+	@param usec delay in microseconds. */
+	void delayMicros(uint32_t usec);
+
+	/*
+	blocking delay using the clock set with setClock() or the Arduino core, counted if bus statistics are enabled. 
+	@param msec delay in milliseconds. */
+	void delayMillis(uint32_t msec);
+
+    // Return the result of the last frequency measurement of the given tuning cap index
+	// @retval -1 when tuningCapacitance is out of range or AS3935MI_DISABLE_FREQUENCY_TABLE is defined
+#ifndef AS3935MI_DISABLE_FREQUENCY_TABLE
+	int32_t getAntCapFrequency(uint8_t tuningCapacitance) const;
+#else
+	int32_t getAntCapFrequency(uint8_t) const {
+		return -1;
+	}
+#endif
+
+	// Return the best ant_cap found during last LCO calibration
+	// @retval -1 when no LCO calibration was performed
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	int8_t  getCalibratedAntCap() const {
+		return calibrated_ant_cap_;
+	}
+
+    // When set to calibrate all ant_cap indices, the LCO calibration is 
+	// effectively set to perform a 'slow' calibration.
+	// All caps will be tried and also using more samples.
+	void setCalibrateAllAntCap(bool calibrate_all) {
+		calibrate_all_ant_cap_ = calibrate_all;
+	}
+
+	bool getCalibrateAllAntCap() const {
+		return calibrate_all_ant_cap_;
+	}
+#else
+	int8_t  getCalibratedAntCap() const {
+		return -1;
+	}
+#endif
+
+protected:
+	AS3935DriverBase(uint8_t irq);
+	~AS3935DriverBase();
+
+	enum AS3935_registers_t : uint8_t
+	{
+		AS3935_REGISTER_AFE_GB = 0x00,			//Analog Frontend Gain Boost
+		AS3935_REGISTER_PWD = 0x00,				//Power Down
+		AS3935_REGISTER_NF_LEV = 0x01,			//Noise Floor Level
+		AS3935_REGISTER_WDTH = 0x01,			//Watchdog threshold
+		AS3935_REGISTER_CL_STAT = 0x02,			//Clear statistics
+		AS3935_REGISTER_MIN_NUM_LIGH = 0x02,	//Minimum number of lightnings
+		AS3935_REGISTER_SREJ = 0x02,			//Spike rejection
+		AS3935_REGISTER_LCO_FDIV = 0x03,		//Frequency division ratio for antenna tuning
+		AS3935_REGISTER_MASK_DIST = 0x03,		//Mask Disturber
+		AS3935_REGISTER_INT = 0x03,				//Interrupt
+		AS3935_REGISTER_S_LIG_L = 0x04,			//Energy of the Single Lightning LSBYTE
+		AS3935_REGISTER_S_LIG_M = 0x05,			//Energy of the Single Lightning MSBYTE
+		AS3935_REGISTER_S_LIG_MM = 0x06,		//Energy of the Single Lightning MMSBYTE
+		AS3935_REGISTER_DISTANCE = 0x07,		//Distance estimation
+		AS3935_REGISTER_DISP_LCO = 0x08,		//Display LCO on IRQ pin
+		AS3935_REGISTER_DISP_SRCO = 0x08,		//Display SRCO on IRQ pin
+		AS3935_REGISTER_DISP_TRCO = 0x08,		//Display TRCO on IRQ pin
+		AS3935_REGISTER_TUN_CAP = 0x08,			//Internal Tuning Capacitors (from 0 to	120pF in steps of 8pF)
+		AS3935_REGISTER_TRCO_CALIB_DONE = 0x3A, //Calibration of TRCO done (1=successful)
+		AS3935_REGISTER_TRCO_CALIB_NOK = 0x3A,	//Calibration of TRCO unsuccessful (1 = not successful)
+		AS3935_REGISTER_SRCO_CALIB_DONE = 0x3B,	//Calibration of SRCO done (1=successful)
+		AS3935_REGISTER_SRCO_CALIB_NOK = 0x3B,	//Calibration of SRCO unsuccessful (1 = not successful)
+		AS3935_REGISTER_PRESET_DEFAULT = 0x3C,	//Sets all registers in default mode
+		AS3935_REGISTER_CALIB_RCO = 0x3D		//Sets all registers in default mode
+	};
+
+	enum AS3935_register_mask_t : uint8_t
+	{
+		AS3935_MASK_AFE_GB =				0b00111110,	//Analog Frontend Gain Boost
+		AS3935_MASK_PWD =					0b00000001, //Power Down
+		AS3935_MASK_NF_LEV =				0b01110000,	//Noise Floor Level
+		AS3935_MASK_WDTH =					0b00001111,	//Watchdog threshold
+		AS3935_MASK_CL_STAT =				0b01000000,	//Clear statistics
+		AS3935_MASK_MIN_NUM_LIGH =			0b00110000,	//Minimum number of lightnings
+		AS3935_MASK_SREJ =					0b00001111,	//Spike rejection
+		AS3935_MASK_LCO_FDIV =				0b11000000,	//Frequency division ratio for antenna tuning
+		AS3935_MASK_MASK_DIST =				0b00100000,	//Mask Disturber
+		AS3935_MASK_INT =					0b00001111,	//Interrupt
+		AS3935_MASK_S_LIG_L =				0b11111111,	//Energy of the Single Lightning LSBYTE
+		AS3935_MASK_S_LIG_M =				0b11111111,	//Energy of the Single Lightning MSBYTE
+		AS3935_MASK_S_LIG_MM =				0b00001111,	//Energy of the Single Lightning MMSBYTE
+		AS3935_MASK_DISTANCE =				0b00111111,	//Distance estimation
+		AS3935_MASK_DISP_LCO =				0b10000000,	//Display LCO on IRQ pin
+		AS3935_MASK_DISP_SRCO =				0b01000000,	//Display SRCO on IRQ pin
+		AS3935_MASK_DISP_TRCO =				0b00100000,	//Display TRCO on IRQ pin
+		AS3935_MASK_TUN_CAP =				0b00001111,	//Internal Tuning Capacitors (from 0 to	120pF in steps of 8pF)
+		AS3935_MASK_TRCO_CALIB_DONE =		0b10000000, //Calibration of TRCO done (1=successful)
+		AS3935_MASK_TRCO_CALIB_NOK =		0b01000000,	//Calibration of TRCO unsuccessful (1 = not successful)
+		AS3935_MASK_TRCO_CALIB_ALL =		0b11000000,	//Calibration of TRCO done (0b10 = successful)
+		AS3935_MASK_SRCO_CALIB_DONE =		0b10000000,	//Calibration of SRCO done (1=successful)
+		AS3935_MASK_SRCO_CALIB_NOK =		0b01000000,	//Calibration of SRCO unsuccessful (1 = not successful)
+		AS3935_MASK_SRCO_CALIB_ALL =		0b11000000,	//Calibration of SRCO done (0b10 = successful)
+		AS3935_MASK_PRESET_DEFAULT =	    0b11111111,	//Sets all registers in default mode
+		AS3935_MASK_CALIB_RCO =			    0b11111111	//Sets all registers in default mode
+	};
+
+	enum co_divider_t 
+	{
+		AS3935_DIVIDER_1 = 1,
+		AS3935_DIVIDER_16 = 16,
+		AS3935_DIVIDER_32 = 32,
+		AS3935_DIVIDER_64 = 64,
+		AS3935_DIVIDER_128 = 128,
+	};
+
+#ifdef AS3935MI_ENABLE_AFE_PROBE
+	enum afe_probe_phase_t : uint8_t
+	{
+		AS3935_AFE_PROBE_IDLE,
+		AS3935_AFE_PROBE_INDOORS,
+		AS3935_AFE_PROBE_OUTDOORS
+	};
+#endif
+
+	static const uint8_t AS3935_DIRECT_CMD = 0x96;
+
+	static const uint32_t AS3935_TIMEOUT = 2000;
+
+	/*
+	@param mask
+	@return number of bits to shift value so it fits into mask. */
+	static uint8_t getMaskShift(uint8_t mask);
+	
+	/*
+	@param register value of register.
+	@param mask mask of value in register
+	@return value of masked bits. */
+	static uint8_t getMaskedBits(uint8_t reg, uint8_t mask);
+	
+	/*
+	@param register value of register
+	@param mask mask of value in register
+	@param value value to write into masked area
+	@param register value with masked bits set to value. */
+	static uint8_t setMaskedBits(uint8_t reg, uint8_t mask, uint8_t value);
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	/*
+	@param reg register address.
+	@return expected content of the register for the integrity check, nullptr if integrity checks are disabled or the 
+	register is not checked. */
+	uint8_t *getIntegrityRegister(uint8_t reg);
+#endif
+
+	/*
+	sleeps until the IRQ pin is high or the timeout has passed, whichever comes first. may return earlier, e.g. when 
+	woken by another interrupt. 
+	@param timeout_ms maximum time to sleep in milliseconds. */
+	void sleepUntilInterrupt(uint32_t timeout_ms);
+
+#ifdef AS3935MI_ENABLE_LOCKING
+	/*
+	updates the cached configuration after a register access. 
+	@param reg register address. 
+	@param value register content. */
+	void updateCachedRegister(uint8_t reg, uint8_t value);
+
+	/*
+	sets the cached configuration to the register defaults. */
+	void resetCachedRegisters();
+
+	/*
+	@param event event read by readEvent(). */
+	void updateCachedEvent(const AS3935Event &event);
+#endif
+
+	/*
+	records an interrupt whose edge was missed, e.g. while the MCU was sleeping or restarting, if the IRQ pin is high. 
+	@return true if an interrupt is pending, false otherwise. */
+	bool latchPendingInterrupt();
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	uint32_t              computeCalibratedFrequency(int32_t divider);
+
+	/*
+	computes value * scale / divisor, rounded down, using 32 bit operations only (no 64 bit division, which is a slow 
+	library call on 8 bit targets). the result is truncated to 32 bits.
+	@param value value to scale.
+	@param scale scale, e.g. the frequency divider * 1000000.
+	@param divisor divisor, 1 ... 2^31 - 1.
+	@return value * scale / divisor, lower 32 bits. */
+	static uint32_t scaleByRatio(uint32_t value, uint32_t scale, uint32_t divisor);
+#endif
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_TABLE
+	/*
+	stores the result of a frequency measurement.
+	@param tuningCapacitance tuning capacitor setting the frequency was measured with.
+	@param frequency measured frequency in Hz, 0 if the measurement failed. */
+	void setAntCapFrequency(uint8_t tuningCapacitance, uint32_t frequency);
+#endif
+
+#ifdef AS3935MI_ENABLE_AFE_PROBE
+	/*
+	selects the AFE setting with the lowest spurious interrupt load from the collected statistics. 
+	@return selected AFE setting as afe_setting_t. */
+	uint8_t selectAFEProbeResult() const;
+#endif
+
+	uint8_t irq_;				//interrupt pin
+
+    // Tuning cap value is located in the same register as the display LCO/SRCO/TRCO flags
+	// When those are active the device may not give an ACK when trying to read 
+	// (via I2C) the register to update those display flags
+	// To overcome this issue, we keep a cache of the tuning cap parameter 
+	// and write directly to the register instead of read/set bits/write.
+	// Read and written with AS3935MI_LOCK() held, like a read-modify-write of the register.
+	uint8_t tuning_cap_cache_ = 0;
+
+	interrupt_mode_t mode_ = AS3935_INTERRUPT_UNINITIALIZED;
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	int calibration_mode_edgetrigger_trigger_ = AS3935MI_CALIBRATION_MODE_EDGE_TRIGGER;
+	division_ratio_t calibration_mode_division_ratio_ = AS3935MI_LCO_DIVISION_RATIO;
+#endif
+
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+#define AS3935MI_VOLATILE_TYPE std::atomic<uint32_t>
+#else
+#define AS3935MI_VOLATILE_TYPE volatile uint32_t
+#endif
+
+
+#ifdef AS3935MI_HAS_ATTACHINTERRUPTARG_FUNCTION
+	static void AS3935MI_IRAM_ATTR interruptISR(AS3935DriverBase *self);
+
+	AS3935MI_VOLATILE_TYPE interrupt_timestamp_ = 0;
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+	AS3935MI_VOLATILE_TYPE interrupt_micros_ = 0;
+#endif
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	static void AS3935MI_IRAM_ATTR calibrateISR(AS3935DriverBase *self);
+
+	AS3935MI_VOLATILE_TYPE interrupt_count_     = 0;
+
+	// Store the time micros as 32-bit int so it can be stored and comprared as an atomic operation.
+	// Expected duration will be much less than 2^32 usec, thus overflow isn't an issue here
+	AS3935MI_VOLATILE_TYPE calibration_start_micros_ = 0;
+	AS3935MI_VOLATILE_TYPE calibration_end_micros_   = 0;
+
+	uint32_t nr_calibration_samples_  = AS3935MI_NR_CALIBRATION_SAMPLES;
+#endif
+
+#else
+	static void AS3935MI_IRAM_ATTR interruptISR();
+
+	static AS3935MI_VOLATILE_TYPE interrupt_timestamp_;
+#ifdef AS3935MI_ENABLE_INTERRUPT_MICROS
+	static AS3935MI_VOLATILE_TYPE interrupt_micros_;
+#endif
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	static void AS3935MI_IRAM_ATTR calibrateISR();
+
+	static AS3935MI_VOLATILE_TYPE interrupt_count_;
+
+	static AS3935MI_VOLATILE_TYPE calibration_start_micros_;
+	static AS3935MI_VOLATILE_TYPE calibration_end_micros_;
+
+	static uint32_t nr_calibration_samples_;
+#endif
+#endif
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_TABLE
+#ifdef AS3935MI_COMPACT_FREQUENCY_TABLE
+	uint16_t calibration_frequencies_[16]{};	//offset from 500 kHz in steps of 8 Hz + 0x8000, 0 if not measured
+#else
+    int32_t calibration_frequencies_[16]{};
+#endif
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	int8_t calibrated_ant_cap_ = -1;
+	bool calibrate_all_ant_cap_ = true;
+#endif
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	bus_statistics_t bus_statistics_{};
+	bus_statistics_t operation_start_{};		//bus statistics at the start of the current operation
+	bus_statistics_t operation_statistics_{};
+	uint32_t bus_statistics_start_ = 0;			//time of the last reset of the bus statistics
+	uint32_t operation_start_usec_ = 0;
+	uint8_t operation_depth_ = 0;
+#endif
+
+#ifdef AS3935MI_ENABLE_CLOCK
+	AS3935Clock *clock_ = nullptr;
+#endif
+
+#ifdef AS3935MI_ENABLE_LOCKING
+	struct cache_t
+	{
+		uint8_t registers[5];		//registers 0x00 - 0x03 (without the interrupt source) and 0x08
+		AS3935Event event;
+		uint32_t events;
+	};
+
+	mutable AS3935Mutex lock_;		//mutable, readCachedView() falls back to it
+	AS3935SeqLock<cache_t> cache_;
+#endif
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	uint8_t integrity_registers_[5]{};		//expected content of registers 0x00 - 0x03 and 0x08
+	uint32_t integrity_interval_ms_ = 0;	//0 if integrity checks are disabled
+	uint32_t integrity_check_ms_ = 0;		//time of the last check
+	uint32_t integrity_ok_ms_ = 0;			//time of the last check finding the configuration as expected
+	bool integrity_rco_calibrated_ = false;	//the RCOs are expected to be calibrated
+	integrity_statistics_t integrity_statistics_{};
+#endif
+
+#ifdef AS3935MI_ENABLE_SUSPEND
+	uint8_t suspend_registers_[4]{};		//registers 0x00 - 0x03 at the time of suspend(), powered up
+	bool suspended_ = false;
+	uint32_t suspend_millis_ = 0;
+	resume_statistics_t resume_statistics_{};
+#endif
+
+#ifdef AS3935MI_ENABLE_AFE_PROBE
+	afe_probe_stats_t afe_probe_stats_[2]{};	//statistics for AS3935_INDOORS and AS3935_OUTDOORS
+	uint32_t afe_probe_window_ms_ = 0;
+	uint64_t afe_probe_start_ = 0;			//start of the current probing window in microseconds
+	uint8_t afe_probe_phase_ = AS3935_AFE_PROBE_IDLE;
+	uint8_t afe_probe_max_nf_lev_ = AS3935_NFL_4;
+	uint8_t afe_probe_nf_lev_ = AS3935_NFL_2;	//noise floor threshold at the start of the probe
+	uint8_t afe_probe_result_ = 0;
+#endif
+};
+
+inline uint8_t AS3935DriverBase::getMaskShift(uint8_t mask)
+{
+	uint8_t return_value = 0;
+
+	//count how many times the mask must be shifted right until the lowest bit is set
+	if (mask != 0)
+	{
+		while (!(mask & 1))
+		{
+			return_value++;
+			mask >>= 1;
+		}
+	}
+
+	return return_value;
+}
+
+inline uint8_t AS3935DriverBase::getMaskedBits(uint8_t reg, uint8_t mask)
+{
+	//extract masked bits
+	return ((reg & mask) >> getMaskShift(mask));
+}
+
+inline uint8_t AS3935DriverBase::setMaskedBits(uint8_t reg, uint8_t mask, uint8_t value)
+{
+	//clear mask bits in register
+	reg &= (~mask);
+	
+	//set masked bits in register according to value
+	return ((value << getMaskShift(mask)) & mask) | reg;
+}
+
+#ifdef AS3935MI_ENABLE_LOCKING
+inline void AS3935DriverBase::updateCachedRegister(uint8_t reg, uint8_t value)
+{
+	uint8_t index = 0;
+	if (reg <= AS3935_REGISTER_INT)
+		index = reg;
+	else if (reg == AS3935_REGISTER_TUN_CAP)
+		index = 4;
+	else
+		return;
+
+	//the interrupt source is not configuration, it is reported by readEvent()
+	if (reg == AS3935_REGISTER_INT)
+		value &= ~AS3935_MASK_INT;
+
+	cache_.beginWrite().registers[index] = value;
+	cache_.endWrite();
+}
+#endif
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+inline uint8_t *AS3935DriverBase::getIntegrityRegister(uint8_t reg)
+{
+	if (integrity_interval_ms_ == 0)
+		return nullptr;
+
+	if (reg <= AS3935_REGISTER_INT)
+		return &integrity_registers_[reg];
+
+	return (reg == AS3935_REGISTER_TUN_CAP) ? &integrity_registers_[4] : nullptr;
+}
+#endif
+
+inline uint32_t AS3935DriverBase::nowMillis() const
+{
+#ifdef AS3935MI_ENABLE_CLOCK
+	if (clock_)
+		return static_cast<uint32_t>(clock_->millis64());
+#endif
+
+	return millis();
+}
+
+//driver with the bus bound at compile time. Bus must provide
+//	bool beginInterface();
+//	uint8_t readRegister(uint8_t reg);
+//	void writeRegister(uint8_t reg, uint8_t value);
+//and may provide a burst read, which is used by readSnapshot() and restore() if present
+//	void readRegisters(uint8_t reg, uint8_t *values, uint8_t count);
+//accessible to AS3935Driver<Bus> (e.g. private with "template <class Bus> friend class ::AS3935Driver;"), see 
+//AS3935TwoWireBus and AS3935SPIClassBus. the bus functions are called directly and can be inlined. 
+//AS3935MI is this driver bound to a bus with virtual functions. 
+template <class Bus>
+class AS3935Driver :
+	public AS3935DriverBase,
+	public Bus
+{
+public:
+	/*
+	@param irq interrupt pin.
+	@param args arguments passed to the constructor of Bus. */
+	template <class... Args>
+	AS3935Driver(uint8_t irq, Args... args) :
+		AS3935DriverBase(irq),
+		Bus(args...)
+	{
+	}
+
+	bool begin();
+
+	/*
+	begins without resetting a sensor that is already configured, e.g. after a watchdog reset of the MCU while the 
+	sensor kept running. reads registers 0x00 - 0x02, 0x08 and 0x3A - 0x3B (three transfers, register 0x03 is not read 
+	so a pending event is kept). the sensor is considered configured if the AFE gain boost setting is valid, the 
+	sensor is powered up, no oscillator is displayed on the IRQ pin and both RCOs have been calibrated successfully. 
+	a configured sensor is kept as is and the interrupt is attached (AS3935_INTERRUPT_NORMAL), an event pending since 
+	before the restart is reported by getInterruptTimestamp(). otherwise begin() is called and the sensor must be 
+	calibrated as after a cold start. 
+	@return result as begin_result_t. */
+	uint8_t beginWarm();
+
+	/*
+	@return storm distance in km. */
+	uint8_t readStormDistance();
+
+	/*
+	@return interrupt source as AS9395::interrupt_name_t. */
+	uint8_t readInterruptSource();
+
+	/*
+	reads the interrupt source and, depending on the source, the lightning energy and storm distance. 
+	@param event (by reference, write only) will hold the event read from the sensor.
+	@return interrupt source as AS9395::interrupt_name_t. */
+	uint8_t readEvent(AS3935Event &event);
+
+	/*
+	@return true: powered down, false: powered up. */
+	bool readPowerDown();
+
+	/*
+	@param enabled: true to power down, false to power up. */
+	void writePowerDown(bool enabled);
+
+	/*
+	@return true if disturbers are masked, false otherwise. */
+	bool readMaskDisturbers();
+
+	/*
+	@param enabled true to mask disturbers, false otherwise. */
+	void writeMaskDisturbers(bool enabled);
+
+	/*
+	@return AFE setting as afe_setting_t. */
+	uint8_t readAFE();
+
+	/*
+	@param afe_setting AFE setting as one if afe_setting_t. */
+	void writeAFE(uint8_t afe_setting);
+
+	/*
+	@return current noise floor. */
+	uint8_t readNoiseFloorThreshold();
+
+	/*
+	writes a noise floor threshold setting to the sensor. 
+	@param threshold as noise_floor_threshold_t*/
+	void writeNoiseFloorThreshold(uint8_t threshold);
+
+	/*
+	@return current noise floor threshold. */
+	uint8_t readWatchdogThreshold();
+
+	/*
+	@param noise floor threshold setting. */
+	void writeWatchdogThreshold(uint8_t noise_floor);
+
+	/*
+	@return current spike rejection setting as srej_setting_t. */
+	uint8_t readSpikeRejection();
+
+	/*
+	@param spike rejection setting as srej_setting_t. */
+	void writeSpikeRejection(uint8_t threshold);
+
+	/*
+	@return lightning energy. no physical meaning. */
+	uint32_t readEnergy();
+
+	/*
+	@return antenna tuning*/
+	uint8_t readAntennaTuning();
+
+	/*
+	writes an antenna tuning setting to the sensor. */
+	bool writeAntennaTuning(uint8_t tuning);
+
+	/*
+	read the currently set antenna tuning division ratio from the sensor. */
+	uint8_t readDivisionRatio();
+
+	/*
+	writes an antenna tuning division ratio setting to the sensor. */
+	void writeDivisionRatio(uint8_t ratio);
+
+	/*
+	get the currently set minimum number of lightnings in the last 15 minues before lightning interrupts are issued, as min_num_lightnings_t. */
+	uint8_t readMinLightnings();
+
+	/*
+	@param minimum number of lightnings in the last 15 minues before lightning interrupts are issued, as min_num_lightnings_t. */
+	void writeMinLightnings(uint8_t number);
+
+	/*
+	resets all registers to default values. */
+	void resetToDefaults();
+
+	/*
+	calibrates the AS3935 TCRO accordingto procedure in AS3935 datasheet p36. must be done *after* calibrating the resonance frequency.
+	@return true on success, false otherwise. */
+	bool calibrateRCO();
+
+	/*
+	reads registers 0x00 - 0x08 and 0x3A - 0x3B in two burst reads if the bus supports them (see readRegisters()), 
+	e.g. for telemetry or to restore the configuration later. reading register 0x03 clears a pending interrupt, its 
+	source is contained in the snapshot. 
+	@param snapshot (by reference, write only) register contents. 
+	@return true on success, false if the registers could not be read. */
+	bool readSnapshot(register_snapshot_t &snapshot);
+
+	/*
+	writes the configuration registers 0x00 - 0x03 and 0x08 of a snapshot that differ from the sensor, each register at 
+	most once. the current registers are read in a single burst read, which clears a pending interrupt. the read only 
+	fields (interrupt, energy, distance, calibration status) are not restored. the RCOs must be calibrated if restoring 
+	powers the sensor up. 
+	@param snapshot snapshot taken with readSnapshot(). 
+	@return number of registers written. */
+	uint8_t restore(const register_snapshot_t &snapshot);
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	/*
+	enables the detection of a lost configuration, e.g. after a brownout reset of the sensor while the MCU kept running. 
+	the configuration registers 0x00 - 0x03 and 0x08 are read once and then tracked on every write by this driver, 
+	checks compare the sensor against them (see checkIntegrity()). reads register 0x03, which clears a pending 
+	interrupt. 
+	@param interval_ms minimum time between two checks done by updateIntegrityCheck() in milliseconds, 0 to disable. 
+	@return true on success, false if the registers could not be read. */
+	bool setIntegrityCheckInterval(uint32_t interval_ms);
+
+	/*
+	checks the configuration of the sensor with burst reads of registers 0x00 - 0x02 and 0x3A - 0x3B and a read of 
+	register 0x08. register 0x03 is not read as that would clear a pending interrupt. the configuration is lost if it 
+	differs, or if the RCOs of a powered up sensor are no longer calibrated after they were calibrated by this driver 
+	(e.g. a reset of a sensor configured with the defaults). then the differing registers and register 0x03 are 
+	written and the RCOs are calibrated, the resonance frequency is not recalibrated. the power down state of the 
+	sensor is kept. 
+	@return result as integrity_result_t. */
+	uint8_t checkIntegrity();
+
+	/*
+	checks the configuration if the interval set with setIntegrityCheckInterval() has passed since the last check and 
+	no interrupt is pending, so the check never delays reading an event. call regularly, e.g. once per loop(). 
+	@return result as integrity_result_t, AS3935_INTEGRITY_IDLE if no check was done. */
+	uint8_t updateIntegrityCheck();
+#endif
+
+#ifdef AS3935MI_ENABLE_SUSPEND
+	/*
+	stores the settings and powers the sensor down, e.g. between the listening periods of a duty cycled station. 
+	reads registers 0x00 - 0x03 and 0x08, which clears an event pending in the interrupt register: read events first. 
+	@return true on success, false if already suspended, a frequency measurement is in progress or the settings could 
+	not be read. */
+	bool suspend();
+
+	/*
+	powers the sensor up after suspend(). writes the stored settings back without reading them, so they are restored 
+	even if the supply of the sensor was switched off, and calibrates the RCOs. unlike writePowerDown(false) followed by 
+	calibrateRCO() only a single 2ms delay is needed. latency and energy are available from getResumeStatistics(). 
+	@param checkAntenna true to also measure the resonance frequency with the stored tuning capacitor setting (takes 
+	about as long as a frequency measurement, needs the IRQ pin). the interrupt mode is restored afterwards. 
+	@return true if the RCO calibration and, if requested, the antenna check succeeded, false otherwise or if the 
+	sensor was not suspended. */
+	bool resume(bool checkAntenna = false);
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	/*
+	calibrates the AS3935 antenna's resonance frequency. 
+	@param (by reference, write only) frequency: after return, will hold the frequency the AS3935 
+	has been calibrated to. 
+	@return true on success, false on failure or if the resonance frequency could not be tuned
+	to within +-3.5% of 500kHz. */
+	bool calibrateResonanceFrequency(
+		int32_t& frequency, 
+	    uint8_t division_ratio);
+	bool calibrateResonanceFrequency(
+		int32_t& frequency);
+	bool calibrateResonanceFrequency();
+#endif
+
+	/*
+	checks if the sensor is connected by attempting to read the AFE gain boost setting. 
+	@return true if the AFE gain boost setting is 0b10010 or 0b01110, false otherwise. */
+	bool checkConnection();
+
+	/*
+	checks the sensor in a few milliseconds, e.g. for a periodic health check: the AFE gain boost setting, the power 
+	down state and the RCO calibration status are read in two transfers, then the TRCO is displayed on the IRQ pin 
+	until AS3935MI_SELF_TEST_EDGES edges have been counted or AS3935MI_SELF_TEST_TIMEOUT_US have passed. the IRQ pin is 
+	not checked if the sensor has no IRQ pin, is powered down, the frequency measurement is disabled or in progress. 
+	the interrupt mode is restored afterwards, an event that arrived during the test is reported by 
+	getInterruptTimestamp(). register 0x03 is not read. 
+	@return failures as bit mask of self_test_failure_t, 0 if the sensor passed. */
+	uint8_t selfTest();
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	/*
+	checks the IRQ pin by instructing the AS3935 to display the antenna's resonance frequency on the IRQ pin 
+	and monitoring the pin for changing levels. IRQ pin interrupt must not be enabled during this test. 
+	The test takes approximately 14ms. the test is considered successful if more than 100 transitions have 
+	been detected (to prevent false positives). 
+	@return true if more than 100 changes in IRQ pin logic level were detected, false otherwise. */
+	bool checkIRQ();
+#endif
+	
+	/*
+	 * clears lightning distance estimation statistics
+	 */
+	void clearStatistics();
+
+	/*
+	increases the noise floor threshold setting, if possible.
+	@param nf_lev noise floor level setting as reference, will contain updated noise floor setting if function returns true.
+	@return true on success, false otherwise. */
+	bool decreaseNoiseFloorThreshold(uint8_t &nf_lev);
+	bool decreaseNoiseFloorThreshold();
+
+	/*
+	increases the noise floor threshold setting, if possible.
+	@param nf_lev noise floor level setting as reference, will contain updated noise floor setting if function returns true.
+	@return new value on success, 0 otherwise. */
+	bool increaseNoiseFloorThreshold(uint8_t &nf_lev);
+	bool increaseNoiseFloorThreshold();
+
+	/*
+	increases the watchdog threshold setting, if possible.
+	@param wdth watchdog level setting as reference, will contain updated watchdog setting if function returns true.
+	@return true on success, false otherwise. */
+	bool decreaseWatchdogThreshold(uint8_t &wdth);
+	bool decreaseWatchdogThreshold();
+
+	/*
+	increases the watchdog threshold setting, if possible.
+	@param wdth watchdog level setting as reference, will contain updated watchdog setting if function returns true.
+	@return true on success, false otherwise. */
+	bool increaseWatchdogThreshold(uint8_t &wdth);
+	bool increaseWatchdogThreshold();
+
+	/*
+	increases the spike rejection setting, if possible.
+	@param srej spike rejection ratio setting as reference, will contain updated spike rejection ratio setting if function returns true.
+	@return true on success, false otherwise. */
+	bool decreaseSpikeRejection(uint8_t &srej);
+	bool decreaseSpikeRejection();
+
+	/*
+	increases the spike rejection setting, if possible.
+	@param srej spike rejection ratio setting as reference, will contain updated spike rejection ratio setting if function returns true.
+	@return true on success, false otherwise. */
+	bool increaseSpikeRejection(uint8_t &srej);
+	bool increaseSpikeRejection();
+
+#ifdef AS3935MI_ENABLE_AFE_PROBE
+	/*
+	starts probing the AFE gain boost setting. the sensor is set to AS3935_INDOORS for window_ms milliseconds and 
+	then to AS3935_OUTDOORS for another window_ms milliseconds. interrupt sources must be passed to updateAFEProbe()
+	while probing. when both windows have passed, the setting causing the lower spurious (noise level too high and 
+	disturber) interrupt load at an acceptable sensitivity is selected and written to the sensor. 
+	@param window_ms duration of a single probing window in milliseconds.
+	@param max_nf_lev highest noise floor threshold still considered an acceptable sensitivity, as noise_floor_threshold_t. */
+	void beginAFEProbe(uint32_t window_ms, uint8_t max_nf_lev = AS3935_NFL_4);
+
+	/*
+	advances the AFE gain boost probe. must be called regularly while probing, e.g. once per loop().
+	@param interrupt_source interrupt source as returned by readInterruptSource(), or AS3935_INT_DUPDATE if 
+	no interrupt was reported since the last call.
+	@return true if probing has finished and the selected setting has been written to the sensor, false otherwise. */
+	bool updateAFEProbe(uint8_t interrupt_source);
+#endif
+
+    // Ideally 500 kHz signal divided by the set division ratio
+	void displayLcoOnIrq(bool enable);
+
+    // Ideally 1.1 MHz signal
+	void displaySrcoOnIrq(bool enable);
+
+    // Ideally 32.768 kHz signal
+	void displayTrcoOnIrq(bool enable);
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	bool validateCurrentResonanceFrequency(int32_t& frequency);
+
+	int32_t measureResonanceFrequency(display_frequency_source_t source);
+
+	// Internal Tuning Capacitors (from 0 to 120pF in steps of 8pF)
+	uint32_t              measureResonanceFrequency(display_frequency_source_t source, uint8_t tuningCapacitance);
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	/*
+	starts a resonance frequency calibration, continued by updateCalibration(). unlike calibrateResonanceFrequency() 
+	it does not block, e.g. to calibrate several sensors at once (see AS3935Array). 
+	@param state (by reference, write only) state of the calibration. 
+	@param division_ratio LCO division ratio. 
+	@return true if the calibration was started, false if the sensor is powered down. */
+	bool beginCalibration(calibration_state_t &state, uint8_t division_ratio);
+
+	/*
+	continues a calibration started with beginCalibration(). finishes the frequency measurement in progress if 
+	enough edges have been counted and starts the next one. call about once per millisecond. 
+	@param state (by reference) state of the calibration. 
+	@return true if the calibration is done, false otherwise. */
+	bool updateCalibration(calibration_state_t &state);
+#endif
+
+protected:
+	/*
+	reads the masked value from the register. 
+	@param reg register to read.
+	@param mask mask of value.
+	@return masked value in register. */
+	uint8_t readRegisterValue(uint8_t reg, uint8_t mask);
+	
+	/*
+	sets values in a register. 
+	@param reg register to set values in
+	@param mask bits of register to set value in
+	@param value value to set */
+	void writeRegisterValue(uint8_t reg, uint8_t mask, uint8_t value);
+
+	/*
+	reads a register via the bus, counting the access if bus statistics are enabled. 
+	@param reg register to read. 
+	@return register content*/
+	uint8_t busRead(uint8_t reg);
+
+	/*
+	writes a register via the bus, counting the access if bus statistics are enabled. 
+	@param reg register to write to. 
+	@param value value to write to register. */
+	void busWrite(uint8_t reg, uint8_t value);
+
+	/*
+	reads consecutive registers via the bus, in a single transaction if Bus provides readRegisters(), counting the 
+	accesses if bus statistics are enabled. 
+	@param reg first register to read. 
+	@param values (write only) register contents. 
+	@param count number of registers to read. */
+	void busReadRegisters(uint8_t reg, uint8_t *values, uint8_t count);
+
+	/*
+	calibrates the RCOs of a powered up sensor. the interrupt is detached meanwhile, so the SRCO displayed on the IRQ 
+	pin is not taken for an event. the interrupt mode is restored afterwards, an event that arrived meanwhile is 
+	reported by getInterruptTimestamp(). 
+	@return true if both RCOs were calibrated successfully, false otherwise. */
+	bool runRCOCalibration();
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	/*
+	displays an oscillator on the IRQ pin and starts counting its edges. 
+	@param source oscillator to measure. 
+	@param tuningCapacitance tuning capacitor setting, LCO only. 
+	@param timeout (by reference, write only) end of the measurement in microseconds. 
+	@return divider of the frequency displayed on the IRQ pin, 0 if the measurement could not be started. */
+	int32_t startFrequencyMeasurement(display_frequency_source_t source, uint8_t tuningCapacitance, uint64_t &timeout);
+
+	/*
+	stops displaying an oscillator on the IRQ pin. 
+	@param source oscillator measured. 
+	@param tuningCapacitance tuning capacitor setting, LCO only. 
+	@param frequency measured frequency, 0 if the measurement failed. */
+	void stopFrequencyMeasurement(display_frequency_source_t source, uint8_t tuningCapacitance, uint32_t frequency);
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+	/*
+	measures the tuning capacitor settings around the estimate with the full number of samples. 
+	@param state (by reference) state of the calibration. */
+	void beginFineCalibration(calibration_state_t &state);
+#endif
+
+private:
+	//burst read with Bus::readRegisters(), selected if Bus provides it
+	template <class B>
+	auto readBurst(B *bus, uint8_t reg, uint8_t *values, uint8_t count, int) -> 
+		decltype(bus->readRegisters(reg, values, count), void())
+	{
+		bus->readRegisters(reg, values, count);
+	}
+
+	//fallback for buses without burst read
+	template <class B>
+	void readBurst(B *bus, uint8_t reg, uint8_t *values, uint8_t count, long)
+	{
+		for (uint8_t i = 0; i < count; i++)
+			values[i] = bus->readRegister(reg + i);
+	}
+};
+
+template <class Bus>
+bool AS3935Driver<Bus>::begin()
+{
+	AS3935MI_OPERATION();
+
+	if (!this->beginInterface())
+		return false;
+
+	writePowerDown(false);
+
+	setInterruptMode(AS3935_INTERRUPT_DETACHED);
+	resetToDefaults();
+
+	return true;
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::beginWarm()
+{
+	AS3935MI_OPERATION();
+
+	if (!this->beginInterface())
+		return AS3935_BEGIN_FAILED;
+
+	uint8_t tun_cap = 0;
+	bool configured = false;
+	{
+		//read the state without accesses of other tasks in between, the lock is released before begin() delays
+		AS3935MI_LOCK();
+
+		uint8_t config[3];
+		busReadRegisters(AS3935_REGISTER_AFE_GB, config, 3);
+
+		tun_cap = busRead(AS3935_REGISTER_TUN_CAP);
+
+		uint8_t calibration[2];
+		busReadRegisters(AS3935_REGISTER_TRCO_CALIB_NOK, calibration, 2);
+
+		const uint8_t afe = getMaskedBits(config[0], AS3935_MASK_AFE_GB);
+		configured = 
+			((afe == AS3935_INDOORS) || (afe == AS3935_OUTDOORS)) &&
+			!getMaskedBits(config[0], AS3935_MASK_PWD) &&
+			!getMaskedBits(tun_cap, AS3935_MASK_DISP_LCO | AS3935_MASK_DISP_SRCO | AS3935_MASK_DISP_TRCO) &&
+			(getMaskedBits(calibration[0], AS3935_MASK_TRCO_CALIB_ALL) == 0b10) &&
+			(getMaskedBits(calibration[1], AS3935_MASK_SRCO_CALIB_ALL) == 0b10);
+
+		if (configured)
+			tuning_cap_cache_ = getMaskedBits(tun_cap, AS3935_MASK_TUN_CAP);
+	}
+
+	if (!configured)
+		return begin() ? AS3935_BEGIN_COLD : AS3935_BEGIN_FAILED;
+
+	setInterruptMode(AS3935_INTERRUPT_NORMAL);
+	latchPendingInterrupt();
+
+	return AS3935_BEGIN_WARM;
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readStormDistance()
+{
+	AS3935MI_OPERATION();
+
+	return readRegisterValue(AS3935_REGISTER_DISTANCE, AS3935_MASK_DISTANCE);
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readInterruptSource()
+{
+	AS3935MI_OPERATION();
+
+	interrupt_timestamp_ = 0;
+	return readRegisterValue(AS3935_REGISTER_INT, AS3935_MASK_INT);
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readEvent(AS3935Event &event)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	//readInterruptSource() clears the interrupt timestamp, so copy it first
+	const uint32_t timestamp = getInterruptTimestamp();
+	event.timestamp = (timestamp != 0) ? timestamp : nowMillis();
+
+	event.source = readInterruptSource();
+	event.energy = 0;
+	event.distance = 0;
+
+	switch (event.source)
+	{
+	case AS3935_INT_L:
+		event.energy = readEnergy();
+		event.distance = readStormDistance();
+		break;
+	case AS3935_INT_DUPDATE:
+		event.distance = readStormDistance();
+		break;
+	default:
+		break;
+	}
+
+#ifdef AS3935MI_ENABLE_LOCKING
+	updateCachedEvent(event);
+#endif
+
+	return event.source;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::readPowerDown()
+{
+	AS3935MI_OPERATION();
+
+	return (readRegisterValue(AS3935_REGISTER_PWD, AS3935_MASK_PWD) == 1 ? true : false);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writePowerDown(bool enabled)
+{
+	AS3935MI_OPERATION();
+
+	writeRegisterValue(AS3935_REGISTER_PWD, AS3935_MASK_PWD, enabled ? 1 : 0);
+	if (!enabled) {
+		delayMicros(AS3935_TIMEOUT);
+	}
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::readMaskDisturbers()
+{
+	AS3935MI_OPERATION();
+
+	return (readRegisterValue(AS3935_REGISTER_MASK_DIST, AS3935_MASK_MASK_DIST) == 1 ? true : false);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writeMaskDisturbers(bool enabled)
+{
+	AS3935MI_OPERATION();
+
+	writeRegisterValue(AS3935_REGISTER_MASK_DIST, AS3935_MASK_MASK_DIST, enabled ? 1 : 0);
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readAFE()
+{
+	AS3935MI_OPERATION();
+
+	return readRegisterValue(AS3935_REGISTER_AFE_GB, AS3935_MASK_AFE_GB);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writeAFE(uint8_t afe_setting)
+{
+	AS3935MI_OPERATION();
+
+	writeRegisterValue(AS3935_REGISTER_AFE_GB, AS3935_MASK_AFE_GB, afe_setting);
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readNoiseFloorThreshold()
+{
+	AS3935MI_OPERATION();
+
+	return readRegisterValue(AS3935_REGISTER_NF_LEV, AS3935_MASK_NF_LEV);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writeNoiseFloorThreshold(uint8_t threshold)
+{
+	AS3935MI_OPERATION();
+
+	if (threshold > AS3935_NFL_7)
+		return;
+
+	writeRegisterValue(AS3935_REGISTER_NF_LEV, AS3935_MASK_NF_LEV, threshold);
+
+	delayMicros(AS3935_TIMEOUT);
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readWatchdogThreshold()
+{
+	AS3935MI_OPERATION();
+
+	return readRegisterValue(AS3935_REGISTER_WDTH, AS3935_MASK_WDTH);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writeWatchdogThreshold(uint8_t threshold)
+{
+	AS3935MI_OPERATION();
+
+	if (threshold > AS3935_WDTH_15)
+		return;
+
+	writeRegisterValue(AS3935_REGISTER_WDTH, AS3935_MASK_WDTH, threshold);
+
+	delayMicros(AS3935_TIMEOUT);
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readSpikeRejection()
+{
+	AS3935MI_OPERATION();
+
+	return readRegisterValue(AS3935_REGISTER_SREJ, AS3935_MASK_SREJ);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writeSpikeRejection(uint8_t threshold)
+{
+	AS3935MI_OPERATION();
+
+	if (threshold > AS3935_SREJ_15)
+		return;
+
+	writeRegisterValue(AS3935_REGISTER_SREJ, AS3935_MASK_SREJ, threshold);
+
+	delayMicros(AS3935_TIMEOUT);
+}
+
+template <class Bus>
+uint32_t AS3935Driver<Bus>::readEnergy()
+{
+	AS3935MI_OPERATION();
+
+	uint32_t energy = 0;
+	//from https://www.eevblog.com/forum/microcontrollers/define-mmsbyte-for-as3935-lightning-detector/
+	//Reg 0x04: Energy word, bits 0 : 7
+	//Reg 0x05 : Energy word, bits 8 : 15
+	//Reg 0x06 : Energy word, bits 16 : 20
+	//energy |= LSB
+	//energy |= (MSB << 8)
+	//energy |= (MMSB << 16)
+	energy |= static_cast<uint32_t>(readRegisterValue(AS3935_REGISTER_S_LIG_L, AS3935_MASK_S_LIG_L));
+	energy |= (static_cast<uint32_t>(readRegisterValue(AS3935_REGISTER_S_LIG_M, AS3935_MASK_S_LIG_M)) << 8);
+	energy |= (static_cast<uint32_t>(readRegisterValue(AS3935_REGISTER_S_LIG_MM, AS3935_MASK_S_LIG_MM)) << 16);
+
+	return energy;
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readAntennaTuning()
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	// Do not call readRegisterValue(AS3935_REGISTER_TUN_CAP, AS3935_MASK_TUN_CAP)
+	// here as we need to be able to detect read errors.
+	const uint8_t return_value = busRead(AS3935_REGISTER_TUN_CAP);
+	if (return_value != static_cast<uint8_t>(-1)) {
+		// No read error, so update the tuning_cap_cache_
+		tuning_cap_cache_ = return_value & AS3935_MASK_TUN_CAP;
+	} else {
+		return tuning_cap_cache_ & AS3935_MASK_TUN_CAP;
+	}
+
+	return return_value & AS3935_MASK_TUN_CAP;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::writeAntennaTuning(uint8_t tuning)
+{
+	AS3935MI_OPERATION();
+
+	if ((tuning & ~AS3935_MASK_TUN_CAP) != 0) {
+		return false;
+	}
+
+	AS3935MI_LOCK();
+	tuning_cap_cache_ = tuning;
+	writeRegisterValue(AS3935_REGISTER_TUN_CAP, AS3935_MASK_TUN_CAP, tuning);
+	return true;
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readDivisionRatio()
+{
+	AS3935MI_OPERATION();
+
+	return readRegisterValue(AS3935_REGISTER_LCO_FDIV, AS3935_MASK_LCO_FDIV);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writeDivisionRatio(uint8_t ratio)
+{
+	AS3935MI_OPERATION();
+
+	writeRegisterValue(AS3935_REGISTER_LCO_FDIV, AS3935_MASK_LCO_FDIV, ratio);
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readMinLightnings()
+{
+	AS3935MI_OPERATION();
+
+	return readRegisterValue(AS3935_REGISTER_MIN_NUM_LIGH, AS3935_MASK_MIN_NUM_LIGH);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writeMinLightnings(uint8_t number)
+{
+	AS3935MI_OPERATION();
+
+	writeRegisterValue(AS3935_REGISTER_MIN_NUM_LIGH, AS3935_MASK_MIN_NUM_LIGH, number);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::resetToDefaults()
+{
+	AS3935MI_OPERATION();
+
+	busWrite(AS3935_REGISTER_PRESET_DEFAULT, AS3935_DIRECT_CMD);
+
+	delayMicros(AS3935_TIMEOUT);
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	//the defaults are the expected configuration now
+	if (integrity_interval_ms_ != 0)
+		setIntegrityCheckInterval(integrity_interval_ms_);
+#endif
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::calibrateRCO()
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	//cannot calibrate if in power down mode.
+	if (readPowerDown())
+		return false;
+
+	return runRCOCalibration();
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::runRCOCalibration()
+{
+	//the 1.1 MHz SRCO on the IRQ pin must not reach the interrupt service routine
+	const interrupt_mode_t mode = mode_;
+	if (mode == AS3935_INTERRUPT_NORMAL)
+		setInterruptMode(AS3935_INTERRUPT_DETACHED);
+
+	//issue calibration command
+	busWrite(AS3935_REGISTER_CALIB_RCO, AS3935_DIRECT_CMD);
+
+	//expose 1.1 MHz SRCO clock on IRQ pin
+	displaySrcoOnIrq(true);
+
+	//wait for calibration to finish...
+	delayMicros(AS3935_TIMEOUT);
+
+	//stop exposing clock on IRQ pin
+	displaySrcoOnIrq(false);
+
+	//check calibration results. bits will be set if calibration failed.
+	bool success_TRCO = (readRegisterValue(AS3935_REGISTER_TRCO_CALIB_NOK, AS3935_MASK_TRCO_CALIB_ALL) == 0b10);
+	bool success_SRCO = (readRegisterValue(AS3935_REGISTER_SRCO_CALIB_NOK, AS3935_MASK_SRCO_CALIB_ALL) == 0b10);
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	//the integrity check expects the RCOs calibrated from now on
+	integrity_rco_calibrated_ = success_TRCO && success_SRCO;
+#endif
+
+	if (mode == AS3935_INTERRUPT_NORMAL)
+	{
+		setInterruptMode(mode);
+		latchPendingInterrupt();
+	}
+
+	return (success_TRCO && success_SRCO);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::readSnapshot(register_snapshot_t &snapshot)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	busReadRegisters(AS3935_REGISTER_AFE_GB, snapshot.registers, 9);
+	busReadRegisters(AS3935_REGISTER_TRCO_CALIB_DONE, snapshot.registers + 9, 2);
+
+	//the reserved bits of register 0x00 are never set, unless the read failed
+	if (snapshot.registers[AS3935_REGISTER_AFE_GB] == static_cast<uint8_t>(-1))
+		return false;
+
+	tuning_cap_cache_ = snapshot.registers[AS3935_REGISTER_TUN_CAP] & AS3935_MASK_TUN_CAP;
+
+	return true;
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::restore(const register_snapshot_t &snapshot)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	uint8_t current[9];
+	busReadRegisters(AS3935_REGISTER_AFE_GB, current, 9);
+
+	uint8_t written = 0;
+	for (uint8_t reg = AS3935_REGISTER_AFE_GB; reg <= AS3935_REGISTER_TUN_CAP; reg++)
+	{
+		//registers 0x04 - 0x07 and the interrupt bits of register 0x03 are read only
+		if ((reg > AS3935_REGISTER_INT) && (reg < AS3935_REGISTER_TUN_CAP))
+			continue;
+
+		const uint8_t read_only = (reg == AS3935_REGISTER_INT) ? AS3935_MASK_INT : 0;
+		if (((current[reg] ^ snapshot.registers[reg]) & ~read_only) == 0)
+			continue;
+
+		busWrite(reg, snapshot.registers[reg]);
+		written++;
+	}
+
+	tuning_cap_cache_ = snapshot.registers[AS3935_REGISTER_TUN_CAP] & AS3935_MASK_TUN_CAP;
+
+	return written;
+}
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+template <class Bus>
+bool AS3935Driver<Bus>::setIntegrityCheckInterval(uint32_t interval_ms)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	integrity_interval_ms_ = 0;
+	if (interval_ms == 0)
+		return true;
+
+	busReadRegisters(AS3935_REGISTER_AFE_GB, integrity_registers_, 4);
+	integrity_registers_[4] = busRead(AS3935_REGISTER_TUN_CAP);
+
+	uint8_t calibration[2];
+	busReadRegisters(AS3935_REGISTER_TRCO_CALIB_NOK, calibration, 2);
+
+	//the reserved bits of register 0x00 are never set, unless the read failed
+	if (integrity_registers_[0] == static_cast<uint8_t>(-1))
+		return false;
+
+	integrity_rco_calibrated_ = 
+		(getMaskedBits(calibration[0], AS3935_MASK_TRCO_CALIB_ALL) == 0b10) &&
+		(getMaskedBits(calibration[1], AS3935_MASK_SRCO_CALIB_ALL) == 0b10);
+
+	integrity_interval_ms_ = interval_ms;
+	integrity_check_ms_ = nowMillis();
+	integrity_ok_ms_ = integrity_check_ms_;
+
+	return true;
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::checkIntegrity()
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	if ((integrity_interval_ms_ == 0) || (mode_ == AS3935_INTERRUPT_CALIBRATION))
+		return AS3935_INTEGRITY_IDLE;
+
+#ifdef AS3935MI_ENABLE_SUSPEND
+	if (suspended_)
+		return AS3935_INTEGRITY_IDLE;
+#endif
+
+	const uint32_t start = static_cast<uint32_t>(nowMicros());
+	integrity_check_ms_ = nowMillis();
+	integrity_statistics_.checks++;
+
+	uint8_t current[3];
+	busReadRegisters(AS3935_REGISTER_AFE_GB, current, 3);
+	const uint8_t tuning = busRead(AS3935_REGISTER_TUN_CAP);
+
+	uint8_t calibration[2];
+	busReadRegisters(AS3935_REGISTER_TRCO_CALIB_NOK, calibration, 2);
+
+	integrity_statistics_.check_usec = static_cast<uint32_t>(nowMicros()) - start;
+
+	//a reset clears the RCO calibration, which also reveals a reset of a sensor configured with the defaults
+	const bool calibration_lost = integrity_rco_calibrated_ && !(current[0] & AS3935_MASK_PWD) && 
+		((getMaskedBits(calibration[0], AS3935_MASK_TRCO_CALIB_ALL) != 0b10) || 
+		(getMaskedBits(calibration[1], AS3935_MASK_SRCO_CALIB_ALL) != 0b10));
+
+	uint8_t result = AS3935_INTEGRITY_OK;
+
+	const uint8_t *expected = integrity_registers_;
+	if (current[0] == static_cast<uint8_t>(-1))
+	{
+		result = AS3935_INTEGRITY_FAILED;
+	}
+	else if (((current[0] ^ expected[0]) & AS3935_MASK_AFE_GB) || 
+		((current[1] ^ expected[1]) & (AS3935_MASK_NF_LEV | AS3935_MASK_WDTH)) || 
+		((current[2] ^ expected[2]) & (AS3935_MASK_MIN_NUM_LIGH | AS3935_MASK_SREJ)) || 
+		((tuning ^ expected[4]) & AS3935_MASK_TUN_CAP) || 
+		calibration_lost)
+	{
+		integrity_statistics_.restored++;
+		integrity_statistics_.detection_ms = integrity_check_ms_ - integrity_ok_ms_;
+
+		//restore the configuration, keeping the power down state
+		busWrite(AS3935_REGISTER_AFE_GB, (expected[0] & ~AS3935_MASK_PWD) | (current[0] & AS3935_MASK_PWD));
+		for (uint8_t reg = AS3935_REGISTER_NF_LEV; reg <= AS3935_REGISTER_CL_STAT; reg++)
+		{
+			if (current[reg] != expected[reg])
+				busWrite(reg, expected[reg]);
+		}
+		busWrite(AS3935_REGISTER_INT, expected[3]);
+
+		//the calibrated tuning capacitor setting is restored with the RCO calibration
+		tuning_cap_cache_ = expected[4] & AS3935_MASK_TUN_CAP;
+		if (current[0] & AS3935_MASK_PWD)
+		{
+			busWrite(AS3935_REGISTER_TUN_CAP, tuning_cap_cache_);
+			result = AS3935_INTEGRITY_RESTORED;
+		}
+		else
+		{
+			result = calibrateRCO() ? AS3935_INTEGRITY_RESTORED : AS3935_INTEGRITY_FAILED;
+		}
+	}
+
+	if (result == AS3935_INTEGRITY_OK)
+		integrity_ok_ms_ = integrity_check_ms_;
+	else if (result == AS3935_INTEGRITY_FAILED)
+		integrity_statistics_.failures++;
+
+	integrity_statistics_.total_usec += static_cast<uint32_t>(nowMicros()) - start;
+
+	return result;
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::updateIntegrityCheck()
+{
+	if ((integrity_interval_ms_ == 0) || (nowMillis() - integrity_check_ms_ < integrity_interval_ms_))
+		return AS3935_INTEGRITY_IDLE;
+
+	//the event is read first
+	if (hasIRQ() && ((interrupt_timestamp_ != 0) || (digitalRead(irq_) == HIGH)))
+		return AS3935_INTEGRITY_IDLE;
+
+	return checkIntegrity();
+}
+#endif
+
+#ifdef AS3935MI_ENABLE_SUSPEND
+template <class Bus>
+bool AS3935Driver<Bus>::suspend()
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	if (suspended_ || (mode_ == AS3935_INTERRUPT_CALIBRATION))
+		return false;
+
+	for (uint8_t i = 0; i < 4; i++)
+		suspend_registers_[i] = busRead(AS3935_REGISTER_AFE_GB + i);
+
+	//the reserved bits of register 0x00 are never set, unless the read failed
+	if (suspend_registers_[0] == static_cast<uint8_t>(-1))
+		return false;
+
+	readAntennaTuning();
+
+	suspend_registers_[0] &= ~AS3935_MASK_PWD;
+	busWrite(AS3935_REGISTER_PWD, suspend_registers_[0] | AS3935_MASK_PWD);
+
+	suspend_millis_ = nowMillis();
+	suspended_ = true;
+
+	return true;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::resume(bool checkAntenna)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	if (!suspended_)
+		return false;
+
+	const uint32_t start = static_cast<uint32_t>(nowMicros());
+	resume_statistics_.suspended_ms = nowMillis() - suspend_millis_;
+	resume_statistics_.frequency = 0;
+
+	//power up and restore the settings. writing register 0x00 first powers the sensor up.
+	for (uint8_t i = 0; i < 4; i++)
+		busWrite(AS3935_REGISTER_AFE_GB + i, suspend_registers_[i]);
+
+	suspended_ = false;
+
+	//the RCOs must be calibrated after every power up (datasheet p36). displaying the SRCO also restores the tuning 
+	//capacitor setting. 
+	bool success = runRCOCalibration();
+
+	if (checkAntenna)
+	{
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+		const interrupt_mode_t mode = mode_;
+
+		const uint32_t frequency = measureResonanceFrequency(display_frequency_source_t::LCO, tuning_cap_cache_);
+		resume_statistics_.frequency = static_cast<int32_t>(frequency);
+
+		//the measurement changed the division ratio
+		busWrite(AS3935_REGISTER_LCO_FDIV, suspend_registers_[3]);
+		setInterruptMode(mode);
+
+		constexpr int allowedDeviation = 500000 * AS3935MI_ALLOWED_DEVIATION;
+		if (abs(500000 - resume_statistics_.frequency) >= allowedDeviation)
+			success = false;
+#else
+		//the resonance frequency can not be measured in this configuration
+		success = false;
+#endif
+	}
+
+	resume_statistics_.resume_usec = static_cast<uint32_t>(nowMicros()) - start;
+	resume_statistics_.resume_nj = static_cast<uint32_t>(static_cast<uint64_t>(resume_statistics_.resume_usec) * 
+		AS3935MI_LISTENING_CURRENT_UA * AS3935MI_SUPPLY_MV / 1000000ull);
+	resume_statistics_.saved_uj = static_cast<uint32_t>(static_cast<uint64_t>(resume_statistics_.suspended_ms) * 
+		(AS3935MI_LISTENING_CURRENT_UA - AS3935MI_POWER_DOWN_CURRENT_UA) * AS3935MI_SUPPLY_MV / 1000000ull);
+
+	return success;
+}
+#endif
+
+#ifndef AS3935MI_DISABLE_CALIBRATION
+template <class Bus>
+bool AS3935Driver<Bus>::calibrateResonanceFrequency(int32_t& frequency, uint8_t division_ratio)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	calibration_state_t state;
+	if (!beginCalibration(state, division_ratio))
+		return false;
+
+	do {
+		delayMillis(1);
+	} while (!updateCalibration(state));
+
+	frequency = state.frequency;
+
+	return state.success;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::calibrateResonanceFrequency(int32_t& frequency)
+{
+	return calibrateResonanceFrequency(frequency, calibration_mode_division_ratio_);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::calibrateResonanceFrequency()
+{
+	int32_t frequency = 0;
+	return calibrateResonanceFrequency(frequency, calibration_mode_division_ratio_);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::beginCalibration(calibration_state_t &state, uint8_t division_ratio)
+{
+	if (!hasIRQ() || readPowerDown())
+		return false;
+
+	setCalibrationDivisionRatio(division_ratio);
+
+	state.nr_samples = nr_calibration_samples_;
+
+	calibrated_ant_cap_ = -1;
+
+	state.best_diff = 500000;
+	state.best_cap = -1;
+	state.frequency = 0;
+	state.freq_0 = 0;
+	state.success = false;
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_TABLE
+	// Clear previous calibration results
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		setAntCapFrequency(i, 0);
+	}
+#endif
+
+    // When set to calibrate all ant_cap, the 
+	state.attempt = calibrate_all_ant_cap_ ? 0 : 2;
+	state.lowest_cap = 0;
+	state.highest_cap = 15;
+
+	// Find upper and lower bound of ant_caps to test using more samples
+	if (state.attempt > 0) {
+		--state.attempt;
+		state.phase = AS3935_CALIBRATION_COARSE;
+		state.cap = 0;
+		state.divider = startFrequencyMeasurement(display_frequency_source_t::LCO, state.cap, state.timeout);
+	} else {
+		beginFineCalibration(state);
+	}
+
+	return true;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::updateCalibration(calibration_state_t &state)
+{
+	if (state.phase == AS3935_CALIBRATION_DONE)
+		return true;
+
+	uint32_t freq = 0;
+	if (state.divider != 0) {
+		freq = computeCalibratedFrequency(state.divider);
+		if ((freq == 0) && (nowMicros() < state.timeout)) {
+			return false;
+		}
+
+		stopFrequencyMeasurement(display_frequency_source_t::LCO, state.cap, freq);
+	}
+
+	if (state.phase == AS3935_CALIBRATION_COARSE) {
+		if (state.cap == 0) {
+			state.freq_0 = freq;
+			state.cap = 15;
+			state.divider = startFrequencyMeasurement(display_frequency_source_t::LCO, state.cap, state.timeout);
+			return false;
+		}
+
+		const int32_t freq_0 = state.freq_0;
+		const int32_t freq_15 = freq;
+
+		if ((freq_0 == 0 || freq_15 == 0) || (freq_0 == freq_15)) {
+			setFrequencyMeasureNrSamples(nr_calibration_samples_ * 2);
+
+			if (state.attempt > 0) {
+				--state.attempt;
+				state.cap = 0;
+				state.divider = startFrequencyMeasurement(display_frequency_source_t::LCO, state.cap, state.timeout);
+				return false;
+			}
+		} else {
+			const int estimated_cap = map(500000, freq_0, freq_15, 0, 15);
+			if (estimated_cap <= 0) {
+				state.highest_cap = 1;
+			} else if (estimated_cap >= 15) {
+				state.lowest_cap = 14;
+			} else {
+				state.lowest_cap = estimated_cap - 1;
+				state.highest_cap = estimated_cap + 1;
+			}
+		}
+
+		beginFineCalibration(state);
+		return false;
+	}
+
+	if (freq == 0) {
+		// restore nr of samples set by user
+		setFrequencyMeasureNrSamples(state.nr_samples);
+		state.phase = AS3935_CALIBRATION_DONE;
+		return true;
+	}
+
+	const uint32_t freq_diff = abs(500000 - static_cast<int32_t>(freq));
+
+	if (freq_diff < state.best_diff) {
+		state.best_diff = freq_diff;
+		state.best_cap  = state.cap;
+		state.frequency = freq;
+	}
+
+	if (state.cap < state.highest_cap) {
+		++state.cap;
+		state.divider = startFrequencyMeasurement(display_frequency_source_t::LCO, state.cap, state.timeout);
+		return false;
+	}
+
+	// restore nr of samples set by user
+	setFrequencyMeasureNrSamples(state.nr_samples);
+	state.phase = AS3935_CALIBRATION_DONE;
+
+	if (state.best_cap < 0) {
+		state.frequency = 0;
+		return true;
+	}
+
+	calibrated_ant_cap_ = state.best_cap;
+
+	writeAntennaTuning(calibrated_ant_cap_);
+
+	// Check for allowed deviation
+	constexpr uint32_t allowedDeviation = 500000 * AS3935MI_ALLOWED_DEVIATION;
+	state.success = state.best_diff < allowedDeviation;
+
+	return true;
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::beginFineCalibration(calibration_state_t &state)
+{
+	// Now test with higher number of samples to get better accuracy
+	if (nr_calibration_samples_ < AS3935MI_NR_CALIBRATION_SAMPLES) {
+		setFrequencyMeasureNrSamples(AS3935MI_NR_CALIBRATION_SAMPLES);
+	}
+
+	state.phase = AS3935_CALIBRATION_FINE;
+	state.cap = state.lowest_cap;
+	state.divider = startFrequencyMeasurement(display_frequency_source_t::LCO, state.cap, state.timeout);
+}
+#endif
+
+template <class Bus>
+bool AS3935Driver<Bus>::checkConnection()
+{
+	AS3935MI_OPERATION();
+
+	uint8_t afe = readAFE();
+
+	return ((afe == AS3935_INDOORS) || (afe == AS3935_OUTDOORS));
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::selfTest()
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	const uint8_t afe_gb = busRead(AS3935_REGISTER_AFE_GB);
+	const uint8_t afe = getMaskedBits(afe_gb, AS3935_MASK_AFE_GB);
+	if ((afe != AS3935_INDOORS) && (afe != AS3935_OUTDOORS))
+		return AS3935_SELF_TEST_CONNECTION;
+
+	uint8_t failures = 0;
+
+	uint8_t calibration[2];
+	busReadRegisters(AS3935_REGISTER_TRCO_CALIB_NOK, calibration, 2);
+	if (getMaskedBits(calibration[0], AS3935_MASK_TRCO_CALIB_ALL) != 0b10)
+		failures |= AS3935_SELF_TEST_TRCO;
+	if (getMaskedBits(calibration[1], AS3935_MASK_SRCO_CALIB_ALL) != 0b10)
+		failures |= AS3935_SELF_TEST_SRCO;
+
+	if (getMaskedBits(afe_gb, AS3935_MASK_PWD))
+		return failures | AS3935_SELF_TEST_POWERED_DOWN;
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+	if (!hasIRQ() || (mode_ == AS3935_INTERRUPT_CALIBRATION))
+		return failures;
+
+	const interrupt_mode_t mode = mode_;
+
+	//the TRCO runs while the sensor is powered up, so it can be displayed without a settling time
+	setInterruptMode(AS3935_INTERRUPT_CALIBRATION);
+	displayTrcoOnIrq(true);
+
+	const uint32_t edges = (nr_calibration_samples_ < AS3935MI_SELF_TEST_EDGES) ? 
+		nr_calibration_samples_ : AS3935MI_SELF_TEST_EDGES;
+	const uint32_t start = static_cast<uint32_t>(nowMicros());
+	while ((interrupt_count_ < edges) && (static_cast<uint32_t>(nowMicros()) - start < AS3935MI_SELF_TEST_TIMEOUT_US))
+		delayMicros(50);
+
+	if (interrupt_count_ < edges)
+		failures |= AS3935_SELF_TEST_IRQ;
+
+	setInterruptMode(AS3935_INTERRUPT_DETACHED);
+	displayTrcoOnIrq(false);
+
+	setInterruptMode(mode);
+	if (mode == AS3935_INTERRUPT_NORMAL)
+		latchPendingInterrupt();
+#endif
+
+	return failures;
+}
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+template <class Bus>
+bool AS3935Driver<Bus>::checkIRQ()
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	if (!hasIRQ())
+		return false;
+
+	// Only need a quick check, so set nr of samples low as we're not yet interested in an accurate measurement
+	const uint32_t cur_nr_samples = nr_calibration_samples_;
+	setFrequencyMeasureNrSamples(128);
+	const uint32_t freq = measureResonanceFrequency(display_frequency_source_t::LCO);
+	setFrequencyMeasureNrSamples(cur_nr_samples);
+
+	// Expected LCO frequency is several kHz, so we should see at the very least see 1 kHz
+    return freq > 1000;
+}
+#endif
+
+template <class Bus>
+void AS3935Driver<Bus>::clearStatistics()
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	writeRegisterValue(AS3935_REGISTER_CL_STAT, AS3935_MASK_CL_STAT, 1);
+	writeRegisterValue(AS3935_REGISTER_CL_STAT, AS3935_MASK_CL_STAT, 0);
+	writeRegisterValue(AS3935_REGISTER_CL_STAT, AS3935_MASK_CL_STAT, 1);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::decreaseNoiseFloorThreshold()
+{
+	uint8_t nf_lev = AS3935_NFL_0;
+	return decreaseNoiseFloorThreshold(nf_lev);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::decreaseNoiseFloorThreshold(uint8_t &nf_lev)
+{
+	AS3935MI_OPERATION();
+
+	nf_lev = readNoiseFloorThreshold();
+
+	if (nf_lev == AS3935_NFL_0)
+		return false;
+
+	writeNoiseFloorThreshold(--nf_lev);
+
+	return true;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::increaseNoiseFloorThreshold()
+{
+	uint8_t nf_lev = AS3935_NFL_0;
+	return increaseNoiseFloorThreshold(nf_lev);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::increaseNoiseFloorThreshold(uint8_t &nf_lev)
+{
+	AS3935MI_OPERATION();
+
+	nf_lev = readNoiseFloorThreshold();
+
+	if (nf_lev >= AS3935_NFL_7)
+		return false;
+
+	writeNoiseFloorThreshold(++nf_lev);
+
+	return true;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::decreaseWatchdogThreshold()
+{
+	uint8_t wdth = AS3935_WDTH_0;
+	return decreaseWatchdogThreshold(wdth);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::decreaseWatchdogThreshold(uint8_t &wdth)
+{
+	AS3935MI_OPERATION();
+
+	wdth = readWatchdogThreshold();
+
+	if (wdth == AS3935_WDTH_0)
+		return false;
+
+	writeWatchdogThreshold(--wdth);
+
+	return true;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::increaseWatchdogThreshold()
+{
+	uint8_t wdth = AS3935_WDTH_0;
+	return increaseWatchdogThreshold(wdth);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::increaseWatchdogThreshold(uint8_t &wdth)
+{
+	AS3935MI_OPERATION();
+
+	wdth = readWatchdogThreshold();
+
+	if (wdth >= AS3935_WDTH_15)
+		return false;
+
+	writeWatchdogThreshold(++wdth);
+
+	return true;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::decreaseSpikeRejection()
+{
+	uint8_t srej = AS3935_SREJ_0;
+	return decreaseSpikeRejection(srej);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::decreaseSpikeRejection(uint8_t &srej)
+{
+	AS3935MI_OPERATION();
+
+	srej = readSpikeRejection();
+
+	if (srej == AS3935_SREJ_0)
+		return false;
+
+	writeSpikeRejection(--srej);
+
+	return true;
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::increaseSpikeRejection()
+{
+	uint8_t srej = AS3935_SREJ_0;
+	return increaseSpikeRejection(srej);
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::increaseSpikeRejection(uint8_t &srej)
+{
+	AS3935MI_OPERATION();
+
+	srej = readSpikeRejection();
+
+	if (srej >= AS3935_SREJ_15)
+		return false;
+
+	writeSpikeRejection(++srej);
+
+	return true;
+}
+
+#ifdef AS3935MI_ENABLE_AFE_PROBE
+template <class Bus>
+void AS3935Driver<Bus>::beginAFEProbe(uint32_t window_ms, uint8_t max_nf_lev)
+{
+	AS3935MI_OPERATION();
+
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		afe_probe_stats_[i] = afe_probe_stats_t();
+	}
+
+	afe_probe_window_ms_ = window_ms;
+	afe_probe_max_nf_lev_ = (max_nf_lev > AS3935_NFL_7) ? static_cast<uint8_t>(AS3935_NFL_7) : max_nf_lev;
+	afe_probe_nf_lev_ = readNoiseFloorThreshold();
+
+	writeAFE(AS3935_INDOORS);
+
+	afe_probe_phase_ = AS3935_AFE_PROBE_INDOORS;
+	afe_probe_start_ = nowMicros();
+}
+
+template <class Bus>
+bool AS3935Driver<Bus>::updateAFEProbe(uint8_t interrupt_source)
+{
+	AS3935MI_OPERATION();
+
+	if (afe_probe_phase_ == AS3935_AFE_PROBE_IDLE)
+		return false;
+
+	afe_probe_stats_t &stats = afe_probe_stats_[afe_probe_phase_ == AS3935_AFE_PROBE_INDOORS ? 0 : 1];
+
+	switch (interrupt_source)
+	{
+	case AS3935_INT_NH:
+		if (stats.noise_high < UINT16_MAX)
+			stats.noise_high++;
+		break;
+	case AS3935_INT_D:
+		if (stats.disturbers < UINT16_MAX)
+			stats.disturbers++;
+		break;
+	case AS3935_INT_L:
+		if (stats.lightnings < UINT16_MAX)
+			stats.lightnings++;
+		break;
+	default:
+		break;
+	}
+
+	if (nowMicros() - afe_probe_start_ < afe_probe_window_ms_ * 1000ull)
+		return false;
+
+	//the noise floor threshold may have been increased by the application in response to noise level too high 
+	//interrupts. the threshold required for a gain setting indicates the sensitivity lost with this setting.
+	stats.nf_lev = readNoiseFloorThreshold();
+
+	if (afe_probe_phase_ == AS3935_AFE_PROBE_INDOORS)
+	{
+		//start the second window under the same conditions as the first one
+		writeNoiseFloorThreshold(afe_probe_nf_lev_);
+		writeAFE(AS3935_OUTDOORS);
+
+		afe_probe_phase_ = AS3935_AFE_PROBE_OUTDOORS;
+		afe_probe_start_ = nowMicros();
+
+		return false;
+	}
+
+	afe_probe_phase_ = AS3935_AFE_PROBE_IDLE;
+	afe_probe_result_ = selectAFEProbeResult();
+
+	//persist the selected setting together with the noise floor threshold observed with it
+	writeAFE(afe_probe_result_);
+	writeNoiseFloorThreshold(afe_probe_stats_[afe_probe_result_ == AS3935_INDOORS ? 0 : 1].nf_lev);
+
+	return true;
+}
+#endif
+
+template <class Bus>
+void AS3935Driver<Bus>::displayLcoOnIrq(bool enable)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	// With display of any frequency, the device may sometimes report NAK when reading registers
+	// So for this reason we're now writing directly and not try to read first, patch bits, write
+	uint8_t value = tuning_cap_cache_;
+	if (enable) {
+		value |= AS3935_MASK_DISP_LCO;
+	}
+	busWrite(AS3935_REGISTER_DISP_LCO, value);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::displaySrcoOnIrq(bool enable)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	uint8_t value = tuning_cap_cache_;
+	if (enable) {
+		value |= AS3935_MASK_DISP_SRCO;
+	}
+	busWrite(AS3935_REGISTER_DISP_SRCO, value);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::displayTrcoOnIrq(bool enable)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	uint8_t value = tuning_cap_cache_;
+	if (enable) {
+		value |= AS3935_MASK_DISP_TRCO;
+	}
+	busWrite(AS3935_REGISTER_DISP_TRCO, value);
+}
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+template <class Bus>
+bool AS3935Driver<Bus>::validateCurrentResonanceFrequency(int32_t& frequency)
+{
+	AS3935MI_OPERATION();
+
+	frequency = measureResonanceFrequency(
+		display_frequency_source_t::LCO,
+		readAntennaTuning());
+
+	// Check for allowed deviation
+	constexpr int allowedDeviation = 500000 * AS3935MI_ALLOWED_DEVIATION;
+
+	return abs(500000 - frequency) < allowedDeviation;
+}
+
+template <class Bus>
+int32_t AS3935Driver<Bus>::measureResonanceFrequency(display_frequency_source_t source)
+{
+	return measureResonanceFrequency(
+		source,
+		readAntennaTuning());
+}
+#endif
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::readRegisterValue(uint8_t reg, uint8_t mask)
+{
+	return getMaskedBits(busRead(reg), mask);
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::writeRegisterValue(uint8_t reg, uint8_t mask, uint8_t value)
+{
+	AS3935MI_LOCK();
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	uint8_t *expected = getIntegrityRegister(reg);
+	const uint8_t previous = expected ? *expected : 0;
+#endif
+
+	uint8_t reg_val = busRead(reg);
+	busWrite(reg, setMaskedBits(reg_val, mask, value));
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	//only the written bits are expected, the others may have been lost since the last integrity check
+	if (expected)
+		*expected = setMaskedBits(previous, mask, value);
+#endif
+}
+
+template <class Bus>
+uint8_t AS3935Driver<Bus>::busRead(uint8_t reg)
+{
+	AS3935MI_LOCK();
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	const uint32_t start = static_cast<uint32_t>(nowMicros());
+	const uint8_t value = this->readRegister(reg);
+	bus_statistics_.bus_usec += static_cast<uint32_t>(nowMicros()) - start;
+	bus_statistics_.reads++;
+	bus_statistics_.bytes += 2;
+#else
+	const uint8_t value = this->readRegister(reg);
+#endif
+
+#ifdef AS3935MI_ENABLE_LOCKING
+	updateCachedRegister(reg, value);
+#endif
+
+	return value;
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::busWrite(uint8_t reg, uint8_t value)
+{
+	AS3935MI_LOCK();
+
+#ifdef AS3935MI_ENABLE_INTEGRITY_CHECK
+	//track the expected configuration for the integrity check
+	uint8_t *expected = getIntegrityRegister(reg);
+	if (expected)
+		*expected = value;
+#endif
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	const uint32_t start = static_cast<uint32_t>(nowMicros());
+	this->writeRegister(reg, value);
+	bus_statistics_.bus_usec += static_cast<uint32_t>(nowMicros()) - start;
+	bus_statistics_.writes++;
+	bus_statistics_.bytes += 2;
+#else
+	this->writeRegister(reg, value);
+#endif
+
+#ifdef AS3935MI_ENABLE_LOCKING
+	if (reg == AS3935_REGISTER_PRESET_DEFAULT)
+		resetCachedRegisters();
+	else
+		updateCachedRegister(reg, value);
+#endif
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::busReadRegisters(uint8_t reg, uint8_t *values, uint8_t count)
+{
+	AS3935MI_LOCK();
+
+#ifdef AS3935MI_ENABLE_BUS_STATISTICS
+	const uint32_t start = static_cast<uint32_t>(nowMicros());
+	readBurst(static_cast<Bus *>(this), reg, values, count, 0);
+	bus_statistics_.bus_usec += static_cast<uint32_t>(nowMicros()) - start;
+	bus_statistics_.reads += count;
+	bus_statistics_.bytes += 1 + count;
+#else
+	readBurst(static_cast<Bus *>(this), reg, values, count, 0);
+#endif
+
+#ifdef AS3935MI_ENABLE_LOCKING
+	for (uint8_t i = 0; i < count; i++)
+		updateCachedRegister(reg + i, values[i]);
+#endif
+}
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_MEASUREMENT
+template <class Bus>
+uint32_t AS3935Driver<Bus>::measureResonanceFrequency(display_frequency_source_t source, uint8_t tuningCapacitance)
+{
+	AS3935MI_OPERATION();
+	AS3935MI_LOCK();
+
+	uint64_t timeout = 0;
+	const int32_t divider = startFrequencyMeasurement(source, tuningCapacitance, timeout);
+	if (divider == 0) {
+		return 0u;
+	}
+
+	uint32_t freq = 0;
+
+	while (freq == 0 && (nowMicros() < timeout)) {
+		delayMillis(1);
+		freq = computeCalibratedFrequency(divider);
+	}
+
+	stopFrequencyMeasurement(source, tuningCapacitance, freq);
+
+	return freq;
+}
+
+template <class Bus>
+int32_t AS3935Driver<Bus>::startFrequencyMeasurement(display_frequency_source_t source, uint8_t tuningCapacitance, 
+	uint64_t &timeout)
+{
+	// the edges can not be counted without IRQ pin
+	if (!hasIRQ()) {
+		return 0;
+	}
+
+	setInterruptMode(interrupt_mode_t::AS3935_INTERRUPT_DETACHED);
+
+//	delayMicroseconds(AS3935_TIMEOUT);
+
+	unsigned sourceFreq_kHz = 500;
+	int32_t divider = 1;
+
+	// display LCO on IRQ
+	switch (source) {
+		case display_frequency_source_t::LCO:
+			// set tuning capacitors
+			if (!writeAntennaTuning(tuningCapacitance)) {
+				return 0;
+			}
+			displayLcoOnIrq(true);
+			writeDivisionRatio(calibration_mode_division_ratio_);
+			divider = 16 << static_cast<uint32_t>(calibration_mode_division_ratio_);
+			sourceFreq_kHz = 500;
+			break;
+
+			// TD-er: Do not try to measure the 1.1 MHz signal as the ESP32 will not be able to keep up with all the interrupts.
+		case display_frequency_source_t::SRCO:
+			displaySrcoOnIrq(true);
+			sourceFreq_kHz = 1100;
+			break;
+		case display_frequency_source_t::TRCO:
+			displayTrcoOnIrq(true);
+			sourceFreq_kHz = 33;
+			break;
+	}
+
+	setInterruptMode(interrupt_mode_t::AS3935_INTERRUPT_CALIBRATION);
+
+	// Need to give enough time for the sensor to set the LCO signal on the IRQ pin
+	delayMicros(AS3935_TIMEOUT);
+	calibration_end_micros_	  = 0ul;
+	interrupt_count_		  = 0ul;
+	calibration_start_micros_ = static_cast<uint32_t>(nowMicros());
+
+	// Wait for the amount of samples to be counted (or timeout)
+	// Typically this takes 32 msec for the 500 kHz LCO when taking 1000 samples
+	unsigned expectedDuration = (divider * nr_calibration_samples_) / sourceFreq_kHz;
+	if (expectedDuration < 10) {
+		// For low nr of samples, we should still keep some minimum timeout of 10 msec.
+		expectedDuration = 10;
+	}
+
+	timeout = nowMicros() + (2000ull * expectedDuration);
+
+	return divider;
+}
+
+template <class Bus>
+void AS3935Driver<Bus>::stopFrequencyMeasurement(display_frequency_source_t source, uint8_t tuningCapacitance, 
+	uint32_t frequency)
+{
+	// Need to disable interrupts first or else sending I2C commands may fail
+	setInterruptMode(interrupt_mode_t::AS3935_INTERRUPT_DETACHED);
+
+	// stop displaying LCO on IRQ
+	displayLcoOnIrq(false);
+
+#ifndef AS3935MI_DISABLE_FREQUENCY_TABLE
+	if (source == display_frequency_source_t::LCO) {
+		setAntCapFrequency(tuningCapacitance, frequency);
+	}
+#else
+	(void) source;
+	(void) tuningCapacitance;
+	(void) frequency;
+#endif
+}
+#endif
+
+#endif /* AS3935DRIVER_H_ */
@@ -0,0 +1,33 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935EVENT_H_
+#define AS3935EVENT_H_
+
+#include <stdint.h>
+
+//a single event reported by the AS3935, as read by AS3935MI::readEvent().
+struct AS3935Event
+{
+	uint32_t timestamp;		//time of the interrupt in milliseconds (millis())
+	uint32_t energy;		//lightning energy, 20 bits. no physical meaning. only valid for lightning events.
+	uint8_t source;			//interrupt source as AS3935MI::interrupt_name_t
+	uint8_t distance;		//storm distance in km. only valid for lightning and distance update events.
+};
+
+#endif /* AS3935EVENT_H_ */
@@ -0,0 +1,224 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935EventLog.h"
+
+AS3935EventLog::AS3935EventLog(uint8_t *buffer, size_t size) :
+	buffer_(buffer),
+	size_(buffer ? size : 0),
+	tail_(0),
+	used_(0),
+	count_(0),
+	tail_time_(0),
+	head_time_(0),
+	dropped_(0)
+{
+}
+
+bool AS3935EventLog::append(const AS3935Event &event)
+{
+	if (size_ < AS3935_EVENTLOG_MAX_RECORD_SIZE)
+		return false;
+
+	//the first record's delta refers to the timestamp 0
+	if (count_ == 0)
+	{
+		tail_time_ = 0;
+		head_time_ = 0;
+	}
+
+	//unsigned subtraction keeps deltas valid across a millis() overflow
+	const uint32_t delta = event.timestamp - head_time_;
+
+	//the sensor reports 20 bits, larger values would exceed AS3935_EVENTLOG_MAX_RECORD_SIZE
+	const uint32_t energy = event.energy & AS3935_EVENTLOG_MASK_ENERGY;
+
+	uint8_t header = event.source & AS3935_EVENTLOG_MASK_SOURCE;
+	uint8_t size = 1 + varintSize(delta);
+
+	if (energy != 0)
+	{
+		header |= AS3935_EVENTLOG_FLAG_ENERGY;
+		size += varintSize(energy);
+	}
+
+	if (event.distance != 0)
+	{
+		header |= AS3935_EVENTLOG_FLAG_DISTANCE;
+		size += 1;
+	}
+
+	//a record never exceeds AS3935_EVENTLOG_MAX_RECORD_SIZE, so this loop runs a bounded number of times
+	while ((size_ - used_ < size) && (count_ != 0))
+		dropOldest();
+
+	//the log may have been emptied by dropping records
+	if (count_ == 0)
+		tail_time_ = head_time_;
+
+	put(header);
+	putVarint(delta);
+
+	if (header & AS3935_EVENTLOG_FLAG_ENERGY)
+		putVarint(energy);
+
+	if (header & AS3935_EVENTLOG_FLAG_DISTANCE)
+		put(event.distance);
+
+	head_time_ = event.timestamp;
+	count_++;
+
+	return true;
+}
+
+void AS3935EventLog::clear()
+{
+	tail_ = 0;
+	used_ = 0;
+	count_ = 0;
+	tail_time_ = 0;
+	head_time_ = 0;
+}
+
+AS3935EventLog::Iterator AS3935EventLog::iterator() const
+{
+	return Iterator(this, tail_, used_, tail_time_);
+}
+
+void AS3935EventLog::dropOldest()
+{
+	if (count_ == 0)
+		return;
+
+	uint32_t delta = 0;
+	const uint8_t size = recordSize(buffer_[tail_], advance(tail_), delta);
+
+	tail_ += size;
+	if (tail_ >= size_)
+		tail_ -= size_;
+
+	used_ -= size;
+	count_--;
+	tail_time_ += delta;
+	dropped_++;
+}
+
+void AS3935EventLog::put(uint8_t value)
+{
+	size_t index = tail_ + used_;
+	if (index >= size_)
+		index -= size_;
+
+	buffer_[index] = value;
+	used_++;
+}
+
+void AS3935EventLog::putVarint(uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		put(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+
+	put(static_cast<uint8_t>(value));
+}
+
+uint32_t AS3935EventLog::getVarint(size_t &index) const
+{
+	uint32_t value = 0;
+	uint8_t shift = 0;
+	uint8_t byte = 0;
+
+	do
+	{
+		byte = buffer_[index];
+		index = advance(index);
+
+		value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+		shift += 7;
+	} while ((byte & 0x80) && (shift < 35));
+
+	return value;
+}
+
+uint8_t AS3935EventLog::recordSize(uint8_t header, size_t index, uint32_t &delta) const
+{
+	const size_t start = index;
+	delta = getVarint(index);
+
+	if (header & AS3935_EVENTLOG_FLAG_ENERGY)
+		getVarint(index);
+
+	size_t size = (index >= start) ? index - start : index + size_ - start;
+
+	if (header & AS3935_EVENTLOG_FLAG_DISTANCE)
+		size++;
+
+	return static_cast<uint8_t>(size + 1);
+}
+
+uint8_t AS3935EventLog::varintSize(uint32_t value)
+{
+	uint8_t size = 1;
+
+	while (value >= 0x80)
+	{
+		value >>= 7;
+		size++;
+	}
+
+	return size;
+}
+
+AS3935EventLog::Iterator::Iterator(const AS3935EventLog *log, size_t index, size_t remaining, uint32_t timestamp) :
+	log_(log),
+	index_(index),
+	remaining_(remaining),
+	timestamp_(timestamp)
+{
+}
+
+bool AS3935EventLog::Iterator::next(AS3935Event &event)
+{
+	if (remaining_ == 0)
+		return false;
+
+	const uint8_t header = log_->buffer_[index_];
+
+	uint32_t delta = 0;
+	const uint8_t size = log_->recordSize(header, log_->advance(index_), delta);
+
+	size_t index = log_->advance(index_);
+	log_->getVarint(index);
+
+	timestamp_ += delta;
+
+	event.timestamp = timestamp_;
+	event.source = header & AS3935_EVENTLOG_MASK_SOURCE;
+	event.energy = (header & AS3935_EVENTLOG_FLAG_ENERGY) ? log_->getVarint(index) : 0;
+	event.distance = (header & AS3935_EVENTLOG_FLAG_DISTANCE) ? log_->buffer_[index] : 0;
+
+	index_ += size;
+	if (index_ >= log_->size_)
+		index_ -= log_->size_;
+
+	remaining_ -= size;
+
+	return true;
+}
@@ -0,0 +1,161 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935EVENTLOG_H_
+#define AS3935EVENTLOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AS3935Event.h"
+
+//compact event log stored in a fixed size circular byte buffer supplied by the user. 
+//each event is stored as a header byte (interrupt source and present fields), the time since the previous 
+//event as varint, the lightning energy as varint and the storm distance. when the buffer is full, the 
+//oldest events are discarded. 
+class AS3935EventLog
+{
+public:
+	class Iterator
+	{
+	public:
+		/*
+		reads the next event from the log. 
+		@param event (by reference, write only) will hold the next event.
+		@return true if an event was read, false if no more events are available. */
+		bool next(AS3935Event &event);
+
+	private:
+		friend class AS3935EventLog;
+
+		Iterator(const AS3935EventLog *log, size_t index, size_t remaining, uint32_t timestamp);
+
+		const AS3935EventLog *log_;
+		size_t index_;			//buffer index of the next record
+		size_t remaining_;		//number of bytes left to read
+		uint32_t timestamp_;	//timestamp of the previous record
+	};
+
+	//maximum size of a single record in bytes: header, time delta, energy (20 bits) and distance
+	static const uint8_t AS3935_EVENTLOG_MAX_RECORD_SIZE = 1 + 5 + 3 + 1;
+
+	//bits of the lightning energy stored, the width reported by the sensor
+	static const uint32_t AS3935_EVENTLOG_MASK_ENERGY = 0xFFFFFul;
+
+	/*
+	@param buffer memory to store events in. must stay valid during the lifetime of this object.
+	@param size size of buffer in bytes. must be at least AS3935_EVENTLOG_MAX_RECORD_SIZE. */
+	AS3935EventLog(uint8_t *buffer, size_t size);
+
+	/*
+	appends an event to the log, discarding the oldest events if necessary. 
+	@param event event to append. only the lower 20 bits of the energy are stored. 
+	@return true on success, false if the buffer is too small to hold a single event. */
+	bool append(const AS3935Event &event);
+
+	/*
+	removes all events from the log. */
+	void clear();
+
+	/*
+	@return an iterator pointing to the oldest event in the log. */
+	Iterator iterator() const;
+
+	/*
+	@return number of events in the log. */
+	size_t count() const {
+		return count_;
+	}
+
+	/*
+	@return number of bytes used by the events in the log. */
+	size_t bytesUsed() const {
+		return used_;
+	}
+
+	/*
+	@return size of the buffer in bytes. */
+	size_t capacity() const {
+		return size_;
+	}
+
+	/*
+	@return total number of events discarded because the buffer was full. */
+	uint32_t dropped() const {
+		return dropped_;
+	}
+
+private:
+	enum record_flags_t : uint8_t
+	{
+		AS3935_EVENTLOG_MASK_SOURCE = 0b00001111,
+		AS3935_EVENTLOG_FLAG_ENERGY = 0b00010000,
+		AS3935_EVENTLOG_FLAG_DISTANCE = 0b00100000
+	};
+
+	/*
+	discards the oldest record. */
+	void dropOldest();
+
+	/*
+	@param index buffer index.
+	@return buffer index following index. */
+	size_t advance(size_t index) const {
+		return (++index == size_) ? 0 : index;
+	}
+
+	/*
+	writes a byte at the end of the log. space must be available. */
+	void put(uint8_t value);
+
+	/*
+	writes a value as varint at the end of the log. space must be available. */
+	void putVarint(uint32_t value);
+
+	/*
+	reads a varint. 
+	@param index (by reference) buffer index to read from, will point past the varint after return.
+	@return decoded value. */
+	uint32_t getVarint(size_t &index) const;
+
+	/*
+	@param header record header byte.
+	@param index buffer index of the byte following the header. 
+	@param delta (by reference, write only) time since the previous record.
+	@return size of the record in bytes. */
+	uint8_t recordSize(uint8_t header, size_t index, uint32_t &delta) const;
+
+	/*
+	@param value value to encode.
+	@return number of bytes needed to encode value as varint. */
+	static uint8_t varintSize(uint32_t value);
+
+	uint8_t *buffer_;
+	size_t size_;
+
+	size_t tail_;			//buffer index of the oldest record
+	size_t used_;			//number of bytes in use
+	size_t count_;			//number of records in the log
+
+	uint32_t tail_time_;	//timestamp the oldest record's delta refers to
+	uint32_t head_time_;	//timestamp of the newest record
+
+	uint32_t dropped_;
+};
+
+#endif /* AS3935EVENTLOG_H_ */
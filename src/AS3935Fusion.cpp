@@ -0,0 +1,181 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Fusion.h"
+
+namespace
+{
+	//AS3935MI::AS3935_INT_L and AS3935MI::AS3935_DST_OOR, not included to keep this class independent of the driver
+	const uint8_t INT_L = 0b1000;
+	const uint8_t DST_OOR = 0b111111;
+}
+
+AS3935Fusion::AS3935Fusion(AS3935FusionSlot *slots, uint8_t size, uint32_t window, uint32_t hold) :
+	slots_(slots),
+	size_(size),
+	first_(0),
+	count_(0),
+	flushed_(0),
+	window_(window),
+	hold_(hold),
+	dropped_(0)
+{
+}
+
+bool AS3935Fusion::add(uint8_t sensor, const AS3935Event &event, uint32_t irqMicros)
+{
+	if ((event.source != INT_L) || (sensor >= AS3935_FUSION_MAX_SENSORS) || (size_ == 0))
+		return false;
+
+	const uint16_t mask = 1u << sensor;
+
+	//join the most recent open strike within the window not reported by the sensor yet. strikes are ordered by their 
+	//earliest report, older strikes can not be within the window if this one started too long ago.
+	for (uint8_t n = count_; n > flushed_; n--)
+	{
+		AS3935FusionSlot &candidate = slot(n - 1);
+		AS3935Strike &strike = candidate.strike_;
+
+		const int32_t offset = static_cast<int32_t>(irqMicros - strike.timestamp);
+		if (offset > static_cast<int32_t>(window_))
+			break;
+
+		if (strike.sensors & mask)
+			continue;
+
+		//span of the strike including this report
+		const uint32_t duration = (offset >= 0) ? 
+			((static_cast<uint32_t>(offset) > strike.duration) ? static_cast<uint32_t>(offset) : strike.duration) : 
+			strike.duration + static_cast<uint32_t>(-offset);
+		if (duration > window_)
+			continue;
+
+		strike.duration = duration;
+
+		if (event.energy < strike.energy_min)
+			strike.energy_min = event.energy;
+		if (event.energy > strike.energy_max)
+			strike.energy_max = event.energy;
+
+		strike.sensors |= mask;
+		strike.count++;
+
+		if (event.distance != DST_OOR)
+		{
+			candidate.distance_sum_ += event.distance;
+			candidate.distance_count_++;
+
+			if ((strike.distance_min == DST_OOR) || (event.distance < strike.distance_min))
+				strike.distance_min = event.distance;
+			if ((strike.distance_max == DST_OOR) || (event.distance > strike.distance_max))
+				strike.distance_max = event.distance;
+
+			strike.distance = (candidate.distance_sum_ + candidate.distance_count_ / 2) / candidate.distance_count_;
+		}
+
+		//a late report of an earlier time extends the strike backwards
+		if (offset < 0)
+		{
+			strike.timestamp = irqMicros;
+			reorder(n - 1);
+		}
+
+		return true;
+	}
+
+	//open a new strike
+	if (count_ == size_)
+	{
+		first_ = (first_ + 1) % size_;
+		count_--;
+		dropped_++;
+
+		if (flushed_)
+			flushed_--;
+	}
+
+	AS3935FusionSlot &candidate = slot(count_);
+	AS3935Strike &strike = candidate.strike_;
+
+	strike.timestamp = irqMicros;
+	strike.duration = 0;
+	strike.energy_min = event.energy;
+	strike.energy_max = event.energy;
+	strike.sensors = mask;
+	strike.count = 1;
+
+	const bool in_range = (event.distance != DST_OOR);
+	strike.distance = in_range ? event.distance : DST_OOR;
+	strike.distance_min = strike.distance;
+	strike.distance_max = strike.distance;
+	candidate.distance_sum_ = in_range ? event.distance : 0;
+	candidate.distance_count_ = in_range ? 1 : 0;
+
+	//the event may be older than strikes opened by reports read earlier
+	reorder(count_++);
+
+	return true;
+}
+
+bool AS3935Fusion::next(AS3935Strike &strike, uint32_t now)
+{
+	if (count_ == 0)
+		return false;
+
+	const AS3935Strike &oldest = slot(0).strike_;
+	if (flushed_)
+		flushed_--;
+	else if (now - oldest.timestamp <= window_ + hold_)
+		return false;
+
+	strike = oldest;
+	first_ = (first_ + 1) % size_;
+	count_--;
+
+	return true;
+}
+
+void AS3935Fusion::flush()
+{
+	flushed_ = count_;
+}
+
+void AS3935Fusion::reorder(uint8_t n)
+{
+	//strikes closed by flush() are returned first and keep their position
+	while (n > flushed_)
+	{
+		AS3935FusionSlot &previous = slot(n - 1);
+		AS3935FusionSlot &current = slot(n);
+
+		if (static_cast<int32_t>(current.strike_.timestamp - previous.strike_.timestamp) >= 0)
+			break;
+
+		const AS3935FusionSlot swap = previous;
+		previous = current;
+		current = swap;
+		n--;
+	}
+}
+
+void AS3935Fusion::clear()
+{
+	first_ = 0;
+	count_ = 0;
+	flushed_ = 0;
+}
@@ -0,0 +1,138 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935FUSION_H_
+#define AS3935FUSION_H_
+
+#include <stdint.h>
+
+#include "AS3935Event.h"
+
+//a lightning reported by one or more sensors, as returned by AS3935Fusion::next().
+struct AS3935Strike
+{
+	uint32_t timestamp;		//IRQ time of the earliest report in microseconds
+	uint32_t duration;		//time between the earliest and the latest report in microseconds
+	uint32_t energy_min;	//lowest and highest energy reported
+	uint32_t energy_max;
+	uint16_t sensors;		//bit n is set if sensor n reported the lightning
+	uint8_t count;			//number of reports
+	uint8_t distance;		//mean of the distance estimations in range in km, 0b111111 if all were out of range
+	uint8_t distance_min;	//lowest and highest distance estimation in range, 0b111111 if all were out of range
+	uint8_t distance_max;
+};
+
+class AS3935Fusion;
+
+//slot of the buffer of an AS3935Fusion, allocated by the user, e.g. AS3935FusionSlot slots[8];
+class AS3935FusionSlot
+{
+private:
+	friend class AS3935Fusion;
+
+	AS3935Strike strike_;
+	uint16_t distance_sum_;			//sum of the distance estimations in range
+	uint8_t distance_count_;		//number of distance estimations in range
+};
+
+//groups the lightning events of several sensors (e.g. managed by an AS3935Array) reported within a time window into 
+//a single strike, so one lightning seen by N sensors is reported once. 
+//
+//a lightning event joins the most recent open strike it is within the window of (measured from the earliest to the 
+//latest report) and that the sensor has not reported yet. otherwise it opens a new strike. a strike is closed and 
+//returned by next() once the window and a hold time for late reads have passed since its earliest report. 
+//open strikes are kept in a circular buffer supplied by the user, ordered by their earliest report. adding an event 
+//takes O(1) amortized time, as only strikes still within the window are compared and a late report only moves its 
+//strike past the strikes reported after it. if the buffer is full, the oldest strike is dropped. 
+class AS3935Fusion
+{
+public:
+	static const uint8_t AS3935_FUSION_MAX_SENSORS = 16;
+
+	/*
+	@param slots memory for open strikes. must stay valid during the lifetime of this object.
+	@param size number of slots, at least 1. 
+	@param window maximum time between the earliest and the latest report of a strike in microseconds. 
+	@param hold additional time to wait for reports before closing a strike in microseconds, e.g. the longest time 
+	from an IRQ to add(). */
+	AS3935Fusion(AS3935FusionSlot *slots, uint8_t size, uint32_t window, uint32_t hold);
+
+	/*
+	adds an event. events other than lightnings are ignored. 
+	@param sensor index of the reporting sensor, 0 ... AS3935_FUSION_MAX_SENSORS - 1.
+	@param event event read from the sensor. 
+	@param irqMicros IRQ time of the event in microseconds, e.g. AS3935MI::getInterruptMicros() 
+	(AS3935MI_ENABLE_INTERRUPT_MICROS) on cores with attachInterruptArg(). on other cores the interrupt time is shared 
+	by all sensors, time each IRQ pin with an interrupt service routine of its own instead. 
+	@return true if the event was added, false if it is not a lightning or sensor is invalid. */
+	bool add(uint8_t sensor, const AS3935Event &event, uint32_t irqMicros);
+
+	/*
+	returns the oldest closed strike. 
+	@param strike (by reference, write only) will hold the strike. 
+	@param now current time in microseconds, e.g. micros(). 
+	@return true if a strike was returned, false if no strike is closed. */
+	bool next(AS3935Strike &strike, uint32_t now);
+
+	/*
+	closes all open strikes, e.g. before shutting down. they are returned by next(). */
+	void flush();
+
+	/*
+	@return number of strikes in the buffer, open or closed. */
+	uint8_t count() const {
+		return count_;
+	}
+
+	/*
+	@return number of strikes dropped because the buffer was full. */
+	uint32_t getDropped() const {
+		return dropped_;
+	}
+
+	/*
+	removes all strikes. */
+	void clear();
+
+private:
+	/*
+	@param n position in the buffer, 0 is the oldest strike.
+	@return the slot. */
+	AS3935FusionSlot &slot(uint8_t n) {
+		return slots_[(first_ + n) % size_];
+	}
+
+	/*
+	moves a strike whose earliest report changed towards the start of the buffer, so the open strikes stay ordered 
+	by their earliest report. 
+	@param n position of the strike in the buffer. */
+	void reorder(uint8_t n);
+
+	AS3935FusionSlot *slots_;
+	uint8_t size_;
+	uint8_t first_;			//index of the oldest strike
+	uint8_t count_;
+	uint8_t flushed_;		//number of strikes at the start of the buffer closed by flush()
+
+	uint32_t window_;
+	uint32_t hold_;
+
+	uint32_t dropped_;
+};
+
+#endif /* AS3935FUSION_H_ */
@@ -0,0 +1,260 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Journal.h"
+
+#include "AS3935CRC.h"
+
+AS3935Journal::AS3935Journal(AS3935BlockDevice *device, uint8_t *page_buffer) :
+	device_(device),
+	buffer_(page_buffer),
+	page_size_(0),
+	page_count_(0),
+	records_per_page_(0),
+	page_(0),
+	sequence_(1),
+	records_(0),
+	pages_written_(0),
+	events_written_(0)
+{
+}
+
+bool AS3935Journal::begin()
+{
+	if (!device_ || !buffer_)
+		return false;
+
+	page_size_ = device_->pageSize();
+	page_count_ = device_->pageCount();
+
+	if ((page_count_ == 0) || (page_size_ < AS3935_JOURNAL_HEADER_SIZE + AS3935_JOURNAL_CRC_SIZE + AS3935_JOURNAL_RECORD_SIZE))
+		return false;
+
+	const uint16_t records = (page_size_ - AS3935_JOURNAL_HEADER_SIZE - AS3935_JOURNAL_CRC_SIZE) / AS3935_JOURNAL_RECORD_SIZE;
+	records_per_page_ = (records > 255) ? 255 : static_cast<uint8_t>(records);
+
+	//find the intact page with the highest sequence number. sequence numbers are compared using unsigned 
+	//subtraction so an overflow of the sequence number is handled correctly.
+	bool found = false;
+	uint32_t newest = 0;
+	uint16_t newest_page = 0;
+
+	for (uint16_t page = 0; page < page_count_; page++)
+	{
+		uint32_t sequence = 0;
+		uint8_t nr_records = 0;
+
+		if (!readPageHeader(page, sequence, nr_records))
+			continue;
+
+		if (!found || (static_cast<int32_t>(sequence - newest) > 0))
+		{
+			found = true;
+			newest = sequence;
+			newest_page = page;
+		}
+	}
+
+	if (found)
+	{
+		page_ = (newest_page + 1 == page_count_) ? 0 : newest_page + 1;
+		sequence_ = newest + 1;
+	}
+	else
+	{
+		page_ = 0;
+		sequence_ = 1;
+	}
+
+	records_ = 0;
+	pages_written_ = 0;
+	events_written_ = 0;
+
+	return true;
+}
+
+bool AS3935Journal::append(const AS3935Event &event)
+{
+	if (records_per_page_ == 0)
+		return false;
+
+	//writing the full page buffer failed before, the event is dropped unless the page can be written now
+	if ((records_ >= records_per_page_) && !flush())
+		return false;
+
+	uint8_t *record = buffer_ + AS3935_JOURNAL_HEADER_SIZE + static_cast<uint16_t>(records_) * AS3935_JOURNAL_RECORD_SIZE;
+
+	//energy uses 20 bits, the interrupt source 4 bits
+	putUint32(record, event.timestamp);
+	record[4] = static_cast<uint8_t>(event.energy);
+	record[5] = static_cast<uint8_t>(event.energy >> 8);
+	record[6] = static_cast<uint8_t>(((event.energy >> 16) & 0x0F) | (event.source << 4));
+	record[7] = event.distance;
+
+	if (++records_ < records_per_page_)
+		return true;
+
+	return flush();
+}
+
+bool AS3935Journal::flush()
+{
+	if (records_ == 0)
+		return true;
+
+	putUint16(buffer_, AS3935_JOURNAL_MAGIC);
+	putUint32(buffer_ + 2, sequence_);
+	buffer_[6] = records_;
+	buffer_[7] = 0;
+
+	//clear unused records so the page content does not depend on previous pages
+	const uint16_t used = AS3935_JOURNAL_HEADER_SIZE + static_cast<uint16_t>(records_) * AS3935_JOURNAL_RECORD_SIZE;
+	for (uint16_t i = used; i < page_size_ - AS3935_JOURNAL_CRC_SIZE; i++)
+		buffer_[i] = 0xFF;
+
+	putUint16(buffer_ + page_size_ - AS3935_JOURNAL_CRC_SIZE, AS3935CRC16(buffer_, page_size_ - AS3935_JOURNAL_CRC_SIZE));
+
+	if (!device_->writePage(page_, buffer_))
+		return false;
+
+	pages_written_++;
+	events_written_ += records_;
+
+	page_ = (page_ + 1 == page_count_) ? 0 : page_ + 1;
+	sequence_++;
+	records_ = 0;
+
+	return true;
+}
+
+AS3935Journal::Iterator AS3935Journal::iterator()
+{
+	return Iterator(this);
+}
+
+bool AS3935Journal::readPageHeader(uint16_t page, uint32_t &sequence, uint8_t &records)
+{
+	uint8_t chunk[16];
+	uint16_t crc = 0xFFFF;
+
+	const uint16_t length = page_size_ - AS3935_JOURNAL_CRC_SIZE;
+
+	//checksum the page in small chunks so no additional page buffer is needed
+	for (uint16_t offset = 0; offset < length; offset += sizeof(chunk))
+	{
+		const uint16_t remaining = length - offset;
+		const uint16_t size = (remaining < sizeof(chunk)) ? remaining : static_cast<uint16_t>(sizeof(chunk));
+
+		if (!device_->read(page, offset, chunk, size))
+			return false;
+
+		if (offset == 0)
+		{
+			//size is at least AS3935_JOURNAL_HEADER_SIZE as a page holds at least a single record
+			if (getUint16(chunk) != AS3935_JOURNAL_MAGIC)
+				return false;
+
+			sequence = getUint32(chunk + 2);
+			records = chunk[6];
+		}
+
+		crc = AS3935CRC16(chunk, size, crc);
+	}
+
+	if (!device_->read(page, length, chunk, AS3935_JOURNAL_CRC_SIZE))
+		return false;
+
+	return (getUint16(chunk) == crc) && (records <= records_per_page_);
+}
+
+bool AS3935Journal::isJournalPage(uint16_t page, uint8_t &records)
+{
+	uint32_t sequence = 0;
+
+	if (!readPageHeader(page, sequence, records))
+		return false;
+
+	//only pages written since the memory was last wrapped around belong to the journal
+	const uint32_t age = sequence_ - sequence;
+	return (age > 0) && (age <= page_count_);
+}
+
+void AS3935Journal::putUint16(uint8_t *data, uint16_t value)
+{
+	data[0] = static_cast<uint8_t>(value);
+	data[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void AS3935Journal::putUint32(uint8_t *data, uint32_t value)
+{
+	putUint16(data, static_cast<uint16_t>(value));
+	putUint16(data + 2, static_cast<uint16_t>(value >> 16));
+}
+
+uint16_t AS3935Journal::getUint16(const uint8_t *data)
+{
+	return static_cast<uint16_t>(data[0]) | (static_cast<uint16_t>(data[1]) << 8);
+}
+
+uint32_t AS3935Journal::getUint32(const uint8_t *data)
+{
+	return static_cast<uint32_t>(getUint16(data)) | (static_cast<uint32_t>(getUint16(data + 2)) << 16);
+}
+
+AS3935Journal::Iterator::Iterator(AS3935Journal *journal) :
+	journal_(journal),
+	page_(journal->page_),
+	pages_left_(journal->page_count_),
+	record_(0),
+	records_(0)
+{
+	//the page following the newest page is the oldest page, so start there. 
+	//page_ is advanced before reading, so step back one page.
+	page_ = (page_ == 0) ? journal->page_count_ - 1 : page_ - 1;
+}
+
+bool AS3935Journal::Iterator::next(AS3935Event &event)
+{
+	while (record_ >= records_)
+	{
+		if (pages_left_ == 0)
+			return false;
+
+		pages_left_--;
+		page_ = (page_ + 1 == journal_->page_count_) ? 0 : page_ + 1;
+		record_ = 0;
+
+		if (!journal_->isJournalPage(page_, records_))
+			records_ = 0;
+	}
+
+	uint8_t record[AS3935_JOURNAL_RECORD_SIZE];
+	const uint16_t offset = AS3935_JOURNAL_HEADER_SIZE + static_cast<uint16_t>(record_) * AS3935_JOURNAL_RECORD_SIZE;
+
+	record_++;
+
+	if (!journal_->device_->read(page_, offset, record, sizeof(record)))
+		return false;
+
+	event.timestamp = getUint32(record);
+	event.energy = static_cast<uint32_t>(record[4]) | (static_cast<uint32_t>(record[5]) << 8) | (static_cast<uint32_t>(record[6] & 0x0F) << 16);
+	event.source = record[6] >> 4;
+	event.distance = record[7];
+
+	return true;
+}
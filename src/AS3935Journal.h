@@ -0,0 +1,162 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935JOURNAL_H_
+#define AS3935JOURNAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AS3935BlockDevice.h"
+#include "AS3935Event.h"
+
+//append only event journal on a AS3935BlockDevice. events are collected in a RAM page buffer and written 
+//one complete page at a time. pages are written round robin to spread wear evenly over the memory. each 
+//page carries a sequence number and a CRC, so after a power loss begin() finds the most recent intact page
+//and continues the journal after it. pages torn by a power loss during writing are skipped. 
+//
+//page layout (little endian):
+//  0: magic (2 bytes)
+//  2: sequence number (4 bytes)
+//  6: number of records (1 byte)
+//  7: reserved (1 byte)
+//  8: records (AS3935_JOURNAL_RECORD_SIZE bytes each)
+//  pageSize() - 2: CRC-16 of all preceding bytes (2 bytes)
+class AS3935Journal
+{
+public:
+	class Iterator
+	{
+	public:
+		/*
+		reads the next event from the journal. 
+		@param event (by reference, write only) will hold the next event.
+		@return true if an event was read, false if no more events are available. */
+		bool next(AS3935Event &event);
+
+	private:
+		friend class AS3935Journal;
+
+		Iterator(AS3935Journal *journal);
+
+		AS3935Journal *journal_;
+		uint16_t page_;				//page currently read
+		uint16_t pages_left_;		//number of pages not yet visited
+		uint8_t record_;			//next record within the current page
+		uint8_t records_;			//number of records in the current page
+	};
+
+	static const uint8_t AS3935_JOURNAL_HEADER_SIZE = 8;
+	static const uint8_t AS3935_JOURNAL_CRC_SIZE = 2;
+	static const uint8_t AS3935_JOURNAL_RECORD_SIZE = 8;
+
+	/*
+	@param device block device to store events on. must stay valid during the lifetime of this object. 
+	@param page_buffer RAM buffer of device->pageSize() bytes. must stay valid during the lifetime of this object. */
+	AS3935Journal(AS3935BlockDevice *device, uint8_t *page_buffer);
+
+	/*
+	scans the block device for the most recent intact page and prepares the journal to continue after it. 
+	@return true on success, false if the block device is unusable. */
+	bool begin();
+
+	/*
+	adds an event to the journal. the page buffer is written to the block device when it is full. if writing fails 
+	the full page stays buffered and is written again by the next append() or flush(), events appended while it 
+	cannot be written are dropped. 
+	@param event event to add.
+	@return true on success, false if writing a full page failed. */
+	bool append(const AS3935Event &event);
+
+	/*
+	writes all buffered events to the block device, even if the page buffer is not full. 
+	@return true on success or if no events were buffered, false otherwise. */
+	bool flush();
+
+	/*
+	@return an iterator pointing to the oldest event stored on the block device. buffered events are not included. */
+	Iterator iterator();
+
+	/*
+	@return number of events buffered in RAM. */
+	uint8_t pending() const {
+		return records_;
+	}
+
+	/*
+	@return number of events fitting into a single page. */
+	uint8_t recordsPerPage() const {
+		return records_per_page_;
+	}
+
+	/*
+	@return sequence number the next page will be written with. */
+	uint32_t sequence() const {
+		return sequence_;
+	}
+
+	/*
+	@return number of pages written since begin(). */
+	uint32_t pagesWritten() const {
+		return pages_written_;
+	}
+
+	/*
+	@return number of events written to the block device since begin(). */
+	uint32_t eventsWritten() const {
+		return events_written_;
+	}
+
+private:
+	static const uint16_t AS3935_JOURNAL_MAGIC = 0x3935;
+
+	/*
+	reads the header of a page and verifies the page's CRC. 
+	@param page page to read.
+	@param sequence (by reference, write only) sequence number of the page.
+	@param records (by reference, write only) number of records in the page. 
+	@return true if the page is intact, false otherwise. */
+	bool readPageHeader(uint16_t page, uint32_t &sequence, uint8_t &records);
+
+	/*
+	@param page page to check.
+	@param records (by reference, write only) number of records in the page. 
+	@return true if the page is intact and belongs to the current journal, false otherwise. */
+	bool isJournalPage(uint16_t page, uint8_t &records);
+
+	static void putUint16(uint8_t *data, uint16_t value);
+	static void putUint32(uint8_t *data, uint32_t value);
+	static uint16_t getUint16(const uint8_t *data);
+	static uint32_t getUint32(const uint8_t *data);
+
+	AS3935BlockDevice *device_;
+	uint8_t *buffer_;
+
+	uint16_t page_size_;
+	uint16_t page_count_;
+	uint8_t records_per_page_;
+
+	uint16_t page_;				//next page to write
+	uint32_t sequence_;			//sequence number of the next page to write
+	uint8_t records_;			//number of records in the page buffer
+
+	uint32_t pages_written_;
+	uint32_t events_written_;
+};
+
+#endif /* AS3935JOURNAL_H_ */
@@ -0,0 +1,159 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935LOCK_H_
+#define AS3935LOCK_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(ESP32)
+# include <freertos/FreeRTOS.h>
+# include <freertos/semphr.h>
+#elif defined(ARDUINO_ARCH_HOST)
+# include <mutex>
+#endif
+
+//recursive mutex serializing the bus transactions of a sensor between tasks, used with AS3935MI_ENABLE_LOCKING. 
+//FreeRTOS recursive mutex on ESP32, std::recursive_mutex in the host build. other cores run a single task, the 
+//functions do nothing there. must not be used in interrupt service routines. 
+class AS3935Mutex
+{
+public:
+#if defined(ESP32)
+	AS3935Mutex() :
+		handle_(xSemaphoreCreateRecursiveMutexStatic(&buffer_))
+	{
+	}
+#else
+	AS3935Mutex() {}
+#endif
+
+	AS3935Mutex(const AS3935Mutex &) = delete;
+	AS3935Mutex &operator=(const AS3935Mutex &) = delete;
+
+#if defined(ESP32)
+	void lock() {
+		xSemaphoreTakeRecursive(handle_, portMAX_DELAY);
+	}
+
+	void unlock() {
+		xSemaphoreGiveRecursive(handle_);
+	}
+
+private:
+	StaticSemaphore_t buffer_;
+	SemaphoreHandle_t handle_;
+#elif defined(ARDUINO_ARCH_HOST)
+	void lock() {
+		mutex_.lock();
+	}
+
+	void unlock() {
+		mutex_.unlock();
+	}
+
+private:
+	std::recursive_mutex mutex_;
+#else
+	void lock() {}
+
+	void unlock() {}
+#endif
+};
+
+//holds a mutex for the lifetime of the object. 
+class AS3935LockGuard
+{
+public:
+	AS3935LockGuard(AS3935Mutex &mutex) :
+		mutex_(mutex)
+	{
+		mutex_.lock();
+	}
+
+	~AS3935LockGuard() {
+		mutex_.unlock();
+	}
+
+	AS3935LockGuard(const AS3935LockGuard &) = delete;
+	AS3935LockGuard &operator=(const AS3935LockGuard &) = delete;
+
+private:
+	AS3935Mutex &mutex_;
+};
+
+//sequence lock: readers copy the value without taking a lock and retry if a writer changed it meanwhile. writers 
+//must be serialized by the caller by holding an AS3935Mutex, readers that keep failing take it too. T must be 
+//trivially copyable. 
+template <class T>
+class AS3935SeqLock
+{
+public:
+	//attempts of a reader before it waits for the writers' mutex
+	static const unsigned AS3935_SEQLOCK_RETRIES = 8;
+
+	AS3935SeqLock() :
+		sequence_(0),
+		value_()
+	{
+	}
+
+	/*
+	starts changing the value. readers retry until endWrite() is called. 
+	@return the value to change. */
+	T &beginWrite() {
+		const unsigned sequence = __atomic_load_n(&sequence_, __ATOMIC_RELAXED);
+		__atomic_store_n(&sequence_, sequence + 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		return value_;
+	}
+
+	/*
+	publishes the value changed after beginWrite(). */
+	void endWrite() {
+		__atomic_store_n(&sequence_, __atomic_load_n(&sequence_, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+	}
+
+	/*
+	copies the value without blocking unless writers keep changing it. after AS3935_SEQLOCK_RETRIES attempts the 
+	reader takes the writers' mutex instead of spinning, so a writer preempted by the reader (e.g. a lower priority 
+	FreeRTOS task, which taskYIELD() would not run) can finish. 
+	@param value (by reference, write only) consistent copy of the value. 
+	@param writers mutex held by the writers. */
+	void read(T &value, AS3935Mutex &writers) const {
+		for (unsigned attempt = 0; attempt < AS3935_SEQLOCK_RETRIES; attempt++) {
+			const unsigned before = __atomic_load_n(&sequence_, __ATOMIC_ACQUIRE);
+			memcpy(&value, const_cast<const T *>(&value_), sizeof(T));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			const unsigned after = __atomic_load_n(&sequence_, __ATOMIC_RELAXED);
+
+			if ((before == after) && !(before & 1u))
+				return;
+		}
+
+		AS3935LockGuard lock(writers);
+		memcpy(&value, const_cast<const T *>(&value_), sizeof(T));
+	}
+
+private:
+	unsigned sequence_;
+	T value_;
+};
+
+#endif /* AS3935LOCK_H_ */
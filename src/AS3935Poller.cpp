@@ -0,0 +1,115 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Poller.h"
+
+AS3935Poller::AS3935Poller(AS3935MI &sensor, uint32_t minInterval, uint32_t maxInterval, uint16_t maxBusLoad) :
+	sensor_(sensor),
+	min_interval_(minInterval),
+	max_interval_((maxInterval > minInterval) ? maxInterval : minInterval),
+	max_bus_load_(maxBusLoad ? maxBusLoad : 1),
+	interval_(minInterval),
+	last_poll_(0),
+	poll_usec_(0)
+{
+	//poll on the first update()
+	last_poll_ = static_cast<uint32_t>(sensor_.nowMicros()) - interval_;
+
+	resetStatistics();
+}
+
+uint8_t AS3935Poller::update(AS3935Event &event)
+{
+	const uint32_t start = static_cast<uint32_t>(sensor_.nowMicros());
+	if (start - last_poll_ < interval_)
+		return 0;
+
+	const uint8_t source = sensor_.readEvent(event);
+
+	const uint32_t end = static_cast<uint32_t>(sensor_.nowMicros());
+	const uint32_t duration = end - start;
+
+	statistics_.polls++;
+	statistics_.busy_usec += duration;
+
+	if (source != 0)
+	{
+		//the event occurred after the previous poll
+		const uint32_t latency = end - last_poll_;
+
+		statistics_.events++;
+		statistics_.latency_sum_usec += latency;
+		if (latency > statistics_.latency_max_usec)
+			statistics_.latency_max_usec = latency;
+
+		interval_ = min_interval_;
+	}
+	else
+	{
+		poll_usec_ = duration;
+
+		interval_ = (interval_ > max_interval_ / 2) ? max_interval_ : interval_ * 2;
+	}
+
+	//poll_usec_ / interval_ <= max_bus_load_ / 1000
+	const uint32_t min_interval = (poll_usec_ * 1000ul) / max_bus_load_;
+	if (interval_ < min_interval)
+		interval_ = min_interval;
+
+	last_poll_ = start;
+
+	return source;
+}
+
+AS3935Poller::statistics_t AS3935Poller::getStatistics() const
+{
+	statistics_t statistics = statistics_;
+	statistics.elapsed_usec = static_cast<uint32_t>(sensor_.nowMicros()) - statistics_start_;
+
+	return statistics;
+}
+
+uint16_t AS3935Poller::getBusLoad() const
+{
+	const statistics_t statistics = getStatistics();
+	if (statistics.elapsed_usec == 0)
+		return 0;
+
+	//busy_usec <= elapsed_usec, scaled down to avoid overflows
+	uint32_t busy = statistics.busy_usec;
+	uint32_t elapsed = statistics.elapsed_usec;
+	while (busy > 0xFFFFFFFFul / 1000ul)
+	{
+		busy >>= 1;
+		elapsed >>= 1;
+	}
+
+	return static_cast<uint16_t>((busy * 1000ul) / elapsed);
+}
+
+void AS3935Poller::resetStatistics()
+{
+	statistics_start_ = static_cast<uint32_t>(sensor_.nowMicros());
+
+	statistics_.polls = 0;
+	statistics_.events = 0;
+	statistics_.busy_usec = 0;
+	statistics_.elapsed_usec = 0;
+	statistics_.latency_max_usec = 0;
+	statistics_.latency_sum_usec = 0;
+}
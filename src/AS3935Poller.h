@@ -0,0 +1,97 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935POLLER_H_
+#define AS3935POLLER_H_
+
+#include "AS3935MI.h"
+#include "AS3935Event.h"
+
+#include <Arduino.h>
+
+//reads the events of a sensor whose IRQ pin is not connected (constructed with AS3935MI::AS3935_NO_IRQ) by polling 
+//the interrupt register. 
+//
+//the polling interval adapts to the event rate: after an event the register is polled every minInterval, each poll 
+//without event doubles the interval up to maxInterval. the interval is never shorter than needed to keep the share of 
+//time spent polling below maxBusLoad, based on the measured duration of a poll. 
+//
+//the time of an event is not known, only that it occurred between two polls. the detection latency reported is the 
+//upper bound, the time since the previous poll. note that the datasheet requires waiting 2ms after the IRQ before 
+//reading the interrupt register, a poll shortly after an event may read a lightning energy not yet calculated. 
+class AS3935Poller
+{
+public:
+	struct statistics_t
+	{
+		uint32_t polls;					//interrupt register reads
+		uint32_t events;				//events read
+		uint32_t busy_usec;				//time spent polling and reading events
+		uint32_t elapsed_usec;			//time since the statistics were reset
+		uint32_t latency_max_usec;		//highest detection latency bound
+		uint32_t latency_sum_usec;		//sum of the detection latency bounds of all events
+	};
+
+	/*
+	@param sensor sensor to poll. must stay valid during the lifetime of this object.
+	@param minInterval polling interval while events arrive in microseconds. 
+	@param maxInterval polling interval when idle in microseconds. 
+	@param maxBusLoad maximum share of time spent polling, per mille. */
+	AS3935Poller(AS3935MI &sensor, uint32_t minInterval = 2000, uint32_t maxInterval = 256000, uint16_t maxBusLoad = 10);
+
+	/*
+	polls the interrupt register if the polling interval has passed and reads the event if one occurred. call 
+	frequently, e.g. in loop(). 
+	@param event (by reference, write only) the event read if an interrupt source is returned.
+	@return interrupt source as AS3935MI::interrupt_name_t, 0 if no event occurred or the sensor was not polled. */
+	uint8_t update(AS3935Event &event);
+
+	/*
+	@return current polling interval in microseconds. */
+	uint32_t getInterval() const {
+		return interval_;
+	}
+
+	/*
+	@return statistics since the last call of resetStatistics(). */
+	statistics_t getStatistics() const;
+
+	/*
+	@return share of time spent polling and reading events since the last call of resetStatistics(), per mille. */
+	uint16_t getBusLoad() const;
+
+	/*
+	resets the statistics. */
+	void resetStatistics();
+
+private:
+	AS3935MI &sensor_;
+
+	uint32_t min_interval_;
+	uint32_t max_interval_;
+	uint16_t max_bus_load_;
+
+	uint32_t interval_;
+	uint32_t last_poll_;			//start of the last poll in microseconds
+	uint32_t poll_usec_;			//duration of the last poll without event
+
+	uint32_t statistics_start_;
+	statistics_t statistics_;
+};
+
+#endif /* AS3935POLLER_H_ */
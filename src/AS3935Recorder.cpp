@@ -0,0 +1,176 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Recorder.h"
+
+AS3935Recorder::AS3935Recorder(AS3935MI &sensor, Print &output) :
+	AS3935MI(sensor.getIrqPin()),
+	sensor_(sensor),
+	output_(output),
+	previous_(0),
+	records_(0),
+	bytes_(0),
+	display_(0),
+	division_ratio_(0),
+	irq_level_(LOW),
+	oscillator_pending_(false),
+	oscillator_display_(0),
+	oscillator_start_(0),
+	oscillator_end_(0)
+{
+}
+
+AS3935Recorder::~AS3935Recorder()
+{
+}
+
+void AS3935Recorder::flush()
+{
+	capture(micros());
+}
+
+bool AS3935Recorder::beginInterface()
+{
+	uint8_t header[AS3935TraceReader::AS3935_TRACE_HEADER_SIZE];
+	AS3935TraceReader::header(header);
+
+	output_.write(header, sizeof(header));
+	bytes_ += sizeof(header);
+
+	return sensor_.beginInterface();
+}
+
+uint8_t AS3935Recorder::readRegister(uint8_t reg)
+{
+	capture(micros());
+
+	const uint8_t value = sensor_.readRegister(reg);
+
+	AS3935TraceRecord record = AS3935TraceRecord();
+	record.type = AS3935TraceRecord::AS3935_TRACE_READ;
+	record.timestamp = micros();
+	record.reg = reg;
+	record.value = value;
+	write(record);
+
+	return value;
+}
+
+void AS3935Recorder::writeRegister(uint8_t reg, uint8_t value)
+{
+	capture(micros());
+
+	sensor_.writeRegister(reg, value);
+
+	AS3935TraceRecord record = AS3935TraceRecord();
+	record.type = AS3935TraceRecord::AS3935_TRACE_WRITE;
+	record.timestamp = micros();
+	record.reg = reg;
+	record.value = value;
+	write(record);
+
+	track(reg, value, record.timestamp);
+}
+
+void AS3935Recorder::capture(uint32_t now)
+{
+	//the driver stores the measured frequency after the oscillator has been switched off
+	if (oscillator_pending_)
+	{
+		oscillator_pending_ = false;
+
+		AS3935TraceRecord record = AS3935TraceRecord();
+		record.type = AS3935TraceRecord::AS3935_TRACE_OSCILLATOR;
+		record.timestamp = oscillator_start_;
+		record.duration = oscillator_end_ - oscillator_start_;
+
+		const int32_t frequency = getAntCapFrequency(display_ & AS3935_MASK_TUN_CAP);
+		if ((oscillator_display_ & AS3935_MASK_DISP_LCO) && (frequency > 0))
+		{
+			const uint32_t divider = 16ul << division_ratio_;
+			record.period = static_cast<uint32_t>((divider * 1000000000ull) / static_cast<uint32_t>(frequency));
+		}
+
+		write(record);
+	}
+
+	//the IRQ pin shows an oscillator, not interrupts
+	if (display_ & (AS3935_MASK_DISP_LCO | AS3935_MASK_DISP_SRCO | AS3935_MASK_DISP_TRCO))
+		return;
+
+	const uint8_t level = digitalRead(irq_);
+	if (level == irq_level_)
+		return;
+
+	irq_level_ = level;
+
+	AS3935TraceRecord record = AS3935TraceRecord();
+	record.type = AS3935TraceRecord::AS3935_TRACE_IRQ;
+	record.timestamp = now;
+	record.value = level;
+
+	//use the time the driver's interrupt service routine has seen the rising edge, if available
+	if ((level == HIGH) && (getInterruptTimestamp() != 0))
+		record.timestamp = getInterruptTimestamp() * 1000ul;
+
+	write(record);
+}
+
+void AS3935Recorder::track(uint8_t reg, uint8_t value, uint32_t now)
+{
+	const uint8_t display_mask = AS3935_MASK_DISP_LCO | AS3935_MASK_DISP_SRCO | AS3935_MASK_DISP_TRCO;
+
+	switch (reg)
+	{
+	case AS3935_REGISTER_DISP_LCO:
+		if (!(display_ & display_mask) && (value & display_mask))
+			oscillator_start_ = now;
+		else if ((display_ & display_mask) && !(value & display_mask))
+		{
+			oscillator_pending_ = true;
+			oscillator_display_ = display_ & display_mask;
+			oscillator_end_ = now;
+		}
+
+		display_ = value;
+		break;
+	case AS3935_REGISTER_LCO_FDIV:
+		//changing the division ratio restarts the displayed signal
+		if ((display_ & display_mask) && (((value & AS3935_MASK_LCO_FDIV) >> 6) != division_ratio_))
+			oscillator_start_ = now;
+
+		division_ratio_ = (value & AS3935_MASK_LCO_FDIV) >> 6;
+		break;
+	case AS3935_REGISTER_PRESET_DEFAULT:
+		display_ = 0;
+		division_ratio_ = 0;
+		break;
+	}
+}
+
+void AS3935Recorder::write(const AS3935TraceRecord &record)
+{
+	uint8_t buffer[AS3935TraceReader::AS3935_TRACE_MAX_RECORD_SIZE];
+	const uint8_t size = AS3935TraceReader::encode(record, previous_, buffer);
+
+	output_.write(buffer, size);
+
+	previous_ = record.timestamp;
+	records_++;
+	bytes_ += size;
+}
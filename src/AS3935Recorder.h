@@ -0,0 +1,101 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935RECORDER_H_
+#define AS3935RECORDER_H_
+
+#include "AS3935MI.h"
+#include "AS3935Trace.h"
+
+#include <Arduino.h>
+
+//records the bus traffic and IRQ pin activity of another sensor object (e.g. AS3935I2C) into a trace 
+//(see AS3935Trace.h), e.g. to reproduce field issues with the replay backend of the host build. 
+//use the recorder instead of the wrapped sensor, the wrapped sensor's begin() must not be called. 
+//
+//register accesses are recorded with the micros() timestamp of their completion. the IRQ pin is sampled before each register 
+//access, level changes are recorded. while an oscillator is displayed on the IRQ pin the pin is not sampled, 
+//instead the time the oscillator was displayed and, for the LCO, the signal period derived from the 
+//frequency measured by the driver is recorded. 
+class AS3935Recorder :
+	public AS3935MI
+{
+public:
+	/*
+	@param sensor sensor to record. must stay valid during the lifetime of this object.
+	@param output destination of the trace, e.g. Serial or a File. */
+	AS3935Recorder(AS3935MI &sensor, Print &output);
+	virtual ~AS3935Recorder();
+
+	/*
+	writes records held back by the recorder. call before closing the output. */
+	void flush();
+
+	/*
+	@return number of records written. */
+	uint32_t getRecordCount() const {
+		return records_;
+	}
+
+	/*
+	@return number of bytes written, including the trace header. */
+	uint32_t getBytesWritten() const {
+		return bytes_;
+	}
+
+private:
+	virtual bool beginInterface();
+
+	virtual uint8_t readRegister(uint8_t reg);
+
+	virtual void writeRegister(uint8_t reg, uint8_t value);
+
+	/*
+	records IRQ pin activity since the previous register access.
+	@param now current time in microseconds. */
+	void capture(uint32_t now);
+
+	/*
+	tracks the registers controlling the signal on the IRQ pin. 
+	@param reg register written to. 
+	@param value value written. 
+	@param now current time in microseconds. */
+	void track(uint8_t reg, uint8_t value, uint32_t now);
+
+	/*
+	writes a record to the output. */
+	void write(const AS3935TraceRecord &record);
+
+	AS3935MI &sensor_;
+	Print &output_;
+
+	uint32_t previous_;			//timestamp of the previous record
+	uint32_t records_;
+	uint32_t bytes_;
+
+	uint8_t display_;			//last value written to the display / tuning capacitor register
+	uint8_t division_ratio_;	//last LCO division ratio written
+	uint8_t irq_level_;			//last recorded IRQ pin level
+
+	bool oscillator_pending_;	//the oscillator record is written on the next register access
+	uint8_t oscillator_display_;
+	uint32_t oscillator_start_;
+	uint32_t oscillator_end_;
+};
+
+#endif /* AS3935RECORDER_H_ */
@@ -35,6 +35,32 @@ AS3935SPIClass::~AS3935SPIClass()
 }
 
 bool AS3935SPIClass::beginInterface()
+{
+	return AS3935SPIClassBus(spi_, cs_).beginInterface();
+}
+
+uint8_t AS3935SPIClass::readRegister(uint8_t reg)
+{
+	return AS3935SPIClassBus(spi_, cs_).readRegister(reg);
+}
+
+void AS3935SPIClass::writeRegister(uint8_t reg, uint8_t value)
+{
+	AS3935SPIClassBus(spi_, cs_).writeRegister(reg, value);
+}
+
+void AS3935SPIClass::readRegisters(uint8_t reg, uint8_t *values, uint8_t count)
+{
+	AS3935SPIClassBus(spi_, cs_).readRegisters(reg, values, count);
+}
+
+AS3935SPIClassBus::AS3935SPIClassBus(SPIClass *spi, uint8_t cs) :
+	spi_(spi),
+	cs_(cs)
+{
+}
+
+bool AS3935SPIClassBus::beginInterface()
 {
 	if (!spi_)
 		return false;
@@ -45,7 +71,7 @@ bool AS3935SPIClass::beginInterface()
 	return true;
 }
 
-uint8_t AS3935SPIClass::readRegister(uint8_t reg)
+uint8_t AS3935SPIClassBus::readRegister(uint8_t reg)
 {
 	if (!spi_)
 		return 0;
@@ -58,7 +84,7 @@ uint8_t AS3935SPIClass::readRegister(uint8_t reg)
 	spi_->setFrequency(1000000);
 	//spi_->setClockDivider(SPI_CLOCK_DIV16);
 #else
-	spi_->beginTransaction(spi_settings_);
+	spi_->beginTransaction(AS3935SPIClass::spi_settings_);
 #endif
     
 	digitalWrite(cs_, LOW);				//select sensor
@@ -76,7 +102,7 @@ uint8_t AS3935SPIClass::readRegister(uint8_t reg)
 	return return_value;
 }
 
-void AS3935SPIClass::writeRegister(uint8_t reg, uint8_t value)
+void AS3935SPIClassBus::writeRegister(uint8_t reg, uint8_t value)
 {
 	if (!spi_)
 		return;
@@ -87,7 +113,7 @@ void AS3935SPIClass::writeRegister(uint8_t reg, uint8_t value)
 	spi_->setFrequency(1000000);
 	//spi_->setClockDivider(SPI_CLOCK_DIV16);
 #else
-	spi_->beginTransaction(spi_settings_);
+	spi_->beginTransaction(AS3935SPIClass::spi_settings_);
 #endif   
 
 	digitalWrite(cs_, LOW);				//select sensor
@@ -101,3 +127,33 @@ void AS3935SPIClass::writeRegister(uint8_t reg, uint8_t value)
 	spi_->endTransaction();
 #endif
 }
+
+void AS3935SPIClassBus::readRegisters(uint8_t reg, uint8_t *values, uint8_t count)
+{
+	if (!spi_)
+	{
+		memset(values, 0, count);
+		return;
+	}
+
+#ifdef ESP32
+    spi_->setBitOrder(MSBFIRST);
+    spi_->setDataMode(SPI_MODE1);
+	spi_->setFrequency(1000000);
+#else
+	spi_->beginTransaction(AS3935SPIClass::spi_settings_);
+#endif
+
+	digitalWrite(cs_, LOW);				//select sensor
+
+	spi_->transfer((reg & 0x3F) | 0x40);	//select first register and set pin 7 (indicates read)
+
+	for (uint8_t i = 0; i < count; i++)
+		values[i] = spi_->transfer(0);
+
+	digitalWrite(cs_, HIGH);			//deselect sensor
+
+#ifndef ESP32
+	spi_->endTransaction();
+#endif
+}
@@ -40,11 +40,40 @@ protected:
 	static SPISettings spi_settings_;     //spi settings object. is the same for all AS3935 sensors
 
 private:
+	friend class AS3935SPIClassBus;
+
 	virtual bool beginInterface();
 
 	virtual uint8_t readRegister(uint8_t reg);
 
 	virtual void writeRegister(uint8_t reg, uint8_t value);
+
+	virtual void readRegisters(uint8_t reg, uint8_t *values, uint8_t count);
+};
+
+//SPI bus for AS3935Driver<Bus>, binds the sensor to a SPIClass object at compile time. e.g.
+//AS3935Driver<AS3935SPIClassBus> as3935(PIN_IRQ, AS3935SPIClassBus(&SPI, PIN_CS));
+class AS3935SPIClassBus
+{
+public:
+	AS3935SPIClassBus(SPIClass *spi, uint8_t cs);
+
+private:
+	template <class Bus> friend class AS3935Driver;
+	friend class AS3935SPIClass;
+
+	bool beginInterface();
+
+	uint8_t readRegister(uint8_t reg);
+
+	void writeRegister(uint8_t reg, uint8_t value);
+
+	//reads consecutive registers in a single transfer, the sensor increments the register address
+	void readRegisters(uint8_t reg, uint8_t *values, uint8_t count);
+
+	SPIClass *spi_;
+
+	uint8_t cs_;
 };
 
 #endif /* AS3935SPICLASS_H_ */
@@ -0,0 +1,317 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Stream.h"
+
+#include "AS3935CRC.h"
+
+AS3935Stream::AS3935Stream(uint8_t *buffer, size_t size) :
+	buffer_(buffer),
+	size_(buffer ? size : 0),
+	length_(0),
+	position_(0),
+	code_position_(0),
+	code_(1),
+	crc_(0xFFFF),
+	overflow_(false)
+{
+}
+
+size_t AS3935Stream::encodeEvent(const AS3935Event &event)
+{
+	beginFrame(AS3935_FRAME_EVENT);
+	putUint32(event.timestamp);
+	put(event.source);
+	putUint24(event.energy);
+	put(event.distance);
+
+	return endFrame();
+}
+
+size_t AS3935Stream::encodeCalibration(int8_t calibrated_ant_cap, const int32_t *frequencies, uint8_t count)
+{
+	beginFrame(AS3935_FRAME_CALIBRATION);
+	put(static_cast<uint8_t>(calibrated_ant_cap));
+	put(count);
+
+	for (uint8_t i = 0; i < count; i++)
+		putVarint(static_cast<uint32_t>(frequencies[i]));
+
+	return endFrame();
+}
+
+size_t AS3935Stream::encodeRegisters(uint8_t first, const uint8_t *values, uint8_t count)
+{
+	beginFrame(AS3935_FRAME_REGISTERS);
+	put(first);
+
+	for (uint8_t i = 0; i < count; i++)
+		put(values[i]);
+
+	return endFrame();
+}
+
+void AS3935Stream::beginFrame(uint8_t type)
+{
+	length_ = 0;
+	code_position_ = 0;
+	position_ = 1;
+	code_ = 1;
+	crc_ = 0xFFFF;
+	overflow_ = (size_ < 2);
+
+	put(type);
+}
+
+size_t AS3935Stream::endFrame()
+{
+	//the CRC covers the frame type and payload only
+	const uint16_t crc = crc_;
+	putUint16(crc);
+
+	finishBlock();
+
+	if (overflow_ || (position_ > size_))
+		return 0;
+
+	//finishBlock() reserved a byte for the next block's code, which is used as frame delimiter
+	buffer_[position_ - 1] = 0x00;
+	length_ = position_;
+
+	return length_;
+}
+
+void AS3935Stream::put(uint8_t value)
+{
+	crc_ = AS3935CRC16(&value, 1, crc_);
+	putEncoded(value);
+}
+
+void AS3935Stream::putEncoded(uint8_t value)
+{
+	if (value == 0)
+	{
+		finishBlock();
+		return;
+	}
+
+	if (position_ < size_)
+		buffer_[position_] = value;
+	else
+		overflow_ = true;
+
+	position_++;
+
+	if (++code_ == 0xFF)
+		finishBlock();
+}
+
+void AS3935Stream::finishBlock()
+{
+	if (code_position_ < size_)
+		buffer_[code_position_] = code_;
+	else
+		overflow_ = true;
+
+	code_position_ = position_++;
+	code_ = 1;
+}
+
+void AS3935Stream::putUint16(uint16_t value)
+{
+	put(static_cast<uint8_t>(value));
+	put(static_cast<uint8_t>(value >> 8));
+}
+
+void AS3935Stream::putUint24(uint32_t value)
+{
+	putUint16(static_cast<uint16_t>(value));
+	put(static_cast<uint8_t>(value >> 16));
+}
+
+void AS3935Stream::putUint32(uint32_t value)
+{
+	putUint16(static_cast<uint16_t>(value));
+	putUint16(static_cast<uint16_t>(value >> 16));
+}
+
+void AS3935Stream::putVarint(uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		put(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+
+	put(static_cast<uint8_t>(value));
+}
+
+AS3935StreamDecoder::AS3935StreamDecoder(uint8_t *buffer, size_t size) :
+	buffer_(buffer),
+	size_(buffer ? size : 0),
+	length_(0),
+	frame_length_(0),
+	code_(0),
+	block_zero_(false),
+	discard_(false),
+	errors_(0)
+{
+}
+
+bool AS3935StreamDecoder::push(uint8_t value)
+{
+	//the buffer is reused for the next frame, so the previous frame can no longer be decoded
+	frame_length_ = 0;
+
+	if (value == 0x00)
+	{
+		//end of frame. a frame holds at least the frame type and the CRC.
+		bool valid = !discard_ && (code_ == 0) && (length_ >= 3);
+
+		if (valid)
+		{
+			const uint16_t crc = static_cast<uint16_t>(buffer_[length_ - 2]) | (static_cast<uint16_t>(buffer_[length_ - 1]) << 8);
+			valid = (AS3935CRC16(buffer_, length_ - 2) == crc);
+		}
+
+		if (valid)
+			frame_length_ = length_ - 2;
+		else if (length_ != 0 || discard_)
+			errors_++;
+
+		reset();
+
+		return valid;
+	}
+
+	if (discard_)
+		return false;
+
+	if (code_ == 0)
+	{
+		//start of a new block. the implicit 0x00 of the previous block is only added if data follows.
+		if (block_zero_)
+		{
+			if (length_ >= size_)
+			{
+				discard_ = true;
+				return false;
+			}
+
+			buffer_[length_++] = 0x00;
+		}
+
+		code_ = value - 1;
+		block_zero_ = (value != 0xFF);
+
+		return false;
+	}
+
+	if (length_ >= size_)
+	{
+		discard_ = true;
+		return false;
+	}
+
+	buffer_[length_++] = value;
+	code_--;
+
+	return false;
+}
+
+uint8_t AS3935StreamDecoder::type() const
+{
+	return (frame_length_ > 0) ? buffer_[0] : 0;
+}
+
+bool AS3935StreamDecoder::decodeEvent(AS3935Event &event) const
+{
+	if ((type() != AS3935Stream::AS3935_FRAME_EVENT) || (frame_length_ != 10))
+		return false;
+
+	const uint8_t *data = buffer_ + 1;
+
+	event.timestamp = static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+		(static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+	event.source = data[4];
+	event.energy = static_cast<uint32_t>(data[5]) | (static_cast<uint32_t>(data[6]) << 8) | (static_cast<uint32_t>(data[7]) << 16);
+	event.distance = data[8];
+
+	return true;
+}
+
+bool AS3935StreamDecoder::decodeCalibration(int8_t &calibrated_ant_cap, int32_t *frequencies, uint8_t &count) const
+{
+	if ((type() != AS3935Stream::AS3935_FRAME_CALIBRATION) || (frame_length_ < 3))
+		return false;
+
+	calibrated_ant_cap = static_cast<int8_t>(buffer_[1]);
+
+	const uint8_t nr_frequencies = buffer_[2];
+	size_t index = 3;
+
+	for (uint8_t i = 0; i < nr_frequencies; i++)
+	{
+		uint32_t value = 0;
+		uint8_t shift = 0;
+		uint8_t byte = 0;
+
+		do
+		{
+			if ((index >= frame_length_) || (shift >= 35))
+				return false;
+
+			byte = buffer_[index++];
+			value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			shift += 7;
+		} while (byte & 0x80);
+
+		if (i < count)
+			frequencies[i] = static_cast<int32_t>(value);
+	}
+
+	if (nr_frequencies < count)
+		count = nr_frequencies;
+
+	return index == frame_length_;
+}
+
+bool AS3935StreamDecoder::decodeRegisters(uint8_t &first, uint8_t *values, uint8_t &count) const
+{
+	if ((type() != AS3935Stream::AS3935_FRAME_REGISTERS) || (frame_length_ < 2))
+		return false;
+
+	first = buffer_[1];
+
+	const size_t nr_registers = frame_length_ - 2;
+	if (nr_registers < count)
+		count = static_cast<uint8_t>(nr_registers);
+
+	for (uint8_t i = 0; i < count; i++)
+		values[i] = buffer_[2 + i];
+
+	return true;
+}
+
+void AS3935StreamDecoder::reset()
+{
+	length_ = 0;
+	code_ = 0;
+	block_zero_ = false;
+	discard_ = false;
+}
@@ -0,0 +1,206 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935STREAM_H_
+#define AS3935STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AS3935Event.h"
+
+//encodes events, calibration results and register contents into compact binary frames. 
+//a frame consists of a frame type byte, the frame payload and a CRC-16 of both (little endian). the frame
+//is COBS encoded and terminated by a 0x00 byte, so a receiver can resynchronize at any 0x00 byte. 
+//
+//frame payloads (multi byte values little endian):
+//  AS3935_FRAME_EVENT:        timestamp (4 bytes), interrupt source (1 byte), energy (3 bytes), distance (1 byte)
+//  AS3935_FRAME_CALIBRATION:  calibrated tuning capacitor (1 byte, signed), number of frequencies (1 byte), 
+//                             frequency of each tuning capacitor in Hz (varint, -1 is encoded as 0xFFFFFFFF)
+//  AS3935_FRAME_REGISTERS:    address of the first register (1 byte), register contents (1 byte each)
+//
+//frames are written into a user supplied buffer, no dynamic memory is used. 
+class AS3935Stream
+{
+public:
+	enum frame_type_t : uint8_t
+	{
+		AS3935_FRAME_EVENT = 0x01,
+		AS3935_FRAME_CALIBRATION = 0x02,
+		AS3935_FRAME_REGISTERS = 0x03
+	};
+
+	//encoded size of an event frame: COBS code byte, frame type, payload, CRC and frame delimiter. the 12 bytes 
+	//of an event frame fit into one COBS block, so 0x00 bytes in it do not add to the size.
+	static const uint8_t AS3935_STREAM_EVENT_FRAME_SIZE = 1 + 1 + 9 + 2 + 1;
+
+	/*
+	@param buffer memory to encode frames into. must stay valid during the lifetime of this object.
+	@param size size of buffer in bytes. */
+	AS3935Stream(uint8_t *buffer, size_t size);
+
+	/*
+	encodes an event. 
+	@param event event to encode.
+	@return size of the encoded frame in bytes, 0 if the buffer is too small. */
+	size_t encodeEvent(const AS3935Event &event);
+
+	/*
+	encodes the results of the last resonance frequency calibration. 
+	@param calibrated_ant_cap tuning capacitor selected by the calibration, -1 if no calibration was performed.
+	@param frequencies measured frequency for each tuning capacitor.
+	@param count number of elements in frequencies. 
+	@return size of the encoded frame in bytes, 0 if the buffer is too small. */
+	size_t encodeCalibration(int8_t calibrated_ant_cap, const int32_t *frequencies, uint8_t count);
+
+	/*
+	encodes the results of the last resonance frequency calibration of a sensor. 
+	@param sensor sensor (e.g. AS3935MI) to encode calibration results of. 
+	@return size of the encoded frame in bytes, 0 if the buffer is too small. */
+	template <class Sensor>
+	size_t encodeCalibration(const Sensor &sensor)
+	{
+		int32_t frequencies[16];
+
+		for (uint8_t i = 0; i < 16; i++)
+			frequencies[i] = sensor.getAntCapFrequency(i);
+
+		return encodeCalibration(sensor.getCalibratedAntCap(), frequencies, 16);
+	}
+
+	/*
+	encodes the contents of consecutive registers. 
+	@param first address of the first register.
+	@param values register contents.
+	@param count number of registers.
+	@return size of the encoded frame in bytes, 0 if the buffer is too small. */
+	size_t encodeRegisters(uint8_t first, const uint8_t *values, uint8_t count);
+
+	/*
+	@return pointer to the last encoded frame. */
+	const uint8_t *data() const {
+		return buffer_;
+	}
+
+	/*
+	@return size of the last encoded frame in bytes, 0 if encoding failed. */
+	size_t size() const {
+		return length_;
+	}
+
+private:
+	/*
+	starts encoding a new frame. 
+	@param type frame type as frame_type_t. */
+	void beginFrame(uint8_t type);
+
+	/*
+	finishes the current frame by adding the CRC and frame delimiter.
+	@return size of the encoded frame, 0 if the buffer was too small. */
+	size_t endFrame();
+
+	/*
+	adds a byte to the frame and updates the CRC. */
+	void put(uint8_t value);
+
+	/*
+	adds a byte to the COBS encoded output. */
+	void putEncoded(uint8_t value);
+
+	/*
+	closes the current COBS block. */
+	void finishBlock();
+
+	void putUint16(uint16_t value);
+	void putUint24(uint32_t value);
+	void putUint32(uint32_t value);
+	void putVarint(uint32_t value);
+
+	uint8_t *buffer_;
+	size_t size_;
+
+	size_t length_;			//size of the last encoded frame
+	size_t position_;		//next buffer index to write to
+	size_t code_position_;	//buffer index of the current COBS block's code byte
+	uint8_t code_;			//current COBS block's code
+	uint16_t crc_;
+	bool overflow_;
+};
+
+//decodes frames created by AS3935Stream, e.g. on the receiving side of a serial connection.
+class AS3935StreamDecoder
+{
+public:
+	/*
+	@param buffer memory to decode frames into. must be large enough to hold the largest expected frame. 
+	@param size size of buffer in bytes. */
+	AS3935StreamDecoder(uint8_t *buffer, size_t size);
+
+	/*
+	feeds a received byte into the decoder. 
+	@param value received byte.
+	@return true if a complete frame with valid CRC has been received, false otherwise. the frame can be 
+	decoded until the next byte is fed into the decoder. */
+	bool push(uint8_t value);
+
+	/*
+	@return frame type of the last received frame as AS3935Stream::frame_type_t. */
+	uint8_t type() const;
+
+	/*
+	@param event (by reference, write only) will hold the decoded event.
+	@return true if the last received frame is a valid event frame, false otherwise. */
+	bool decodeEvent(AS3935Event &event) const;
+
+	/*
+	@param calibrated_ant_cap (by reference, write only) will hold the calibrated tuning capacitor.
+	@param frequencies will hold the measured frequencies.
+	@param count (by reference) size of frequencies, will hold the number of decoded frequencies. 
+	@return true if the last received frame is a valid calibration frame, false otherwise. */
+	bool decodeCalibration(int8_t &calibrated_ant_cap, int32_t *frequencies, uint8_t &count) const;
+
+	/*
+	@param first (by reference, write only) will hold the address of the first register.
+	@param values will hold the register contents. 
+	@param count (by reference) size of values, will hold the number of decoded registers. 
+	@return true if the last received frame is a valid register frame, false otherwise. */
+	bool decodeRegisters(uint8_t &first, uint8_t *values, uint8_t &count) const;
+
+	/*
+	@return number of frames discarded due to an invalid CRC, invalid encoding or insufficient buffer size. */
+	uint32_t errors() const {
+		return errors_;
+	}
+
+private:
+	/*
+	resets the decoder to wait for the next frame. */
+	void reset();
+
+	uint8_t *buffer_;
+	size_t size_;
+
+	size_t length_;			//number of decoded bytes of the current frame
+	size_t frame_length_;	//payload size of the last complete frame, including the type byte
+	uint8_t code_;			//remaining bytes in the current COBS block
+	bool block_zero_;		//current COBS block is followed by a 0x00 byte
+	bool discard_;			//the current frame is invalid and is discarded
+	uint32_t errors_;
+};
+
+#endif /* AS3935STREAM_H_ */
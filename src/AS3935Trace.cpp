@@ -0,0 +1,176 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "AS3935Trace.h"
+
+AS3935TraceReader::AS3935TraceReader(const uint8_t *data, size_t length) :
+	data_(data),
+	length_(length),
+	index_(0),
+	timestamp_(0),
+	valid_(false)
+{
+	uint8_t expected[AS3935_TRACE_HEADER_SIZE];
+	header(expected);
+
+	if (length_ < AS3935_TRACE_HEADER_SIZE)
+		return;
+
+	for (uint8_t i = 0; i < AS3935_TRACE_HEADER_SIZE; i++)
+	{
+		if (data_[i] != expected[i])
+			return;
+	}
+
+	valid_ = true;
+	rewind();
+}
+
+bool AS3935TraceReader::next(AS3935TraceRecord &record)
+{
+	if (!valid_ || (index_ >= length_))
+		return false;
+
+	const size_t start = index_;
+
+	record = AS3935TraceRecord();
+	record.type = data_[index_++];
+
+	uint32_t delta = 0;
+	if (!getVarint(delta))
+	{
+		index_ = start;
+		return false;
+	}
+
+	//zigzag decoding
+	const int32_t signed_delta = static_cast<int32_t>(delta >> 1) ^ -static_cast<int32_t>(delta & 1);
+	record.timestamp = timestamp_ + static_cast<uint32_t>(signed_delta);
+
+	bool ok = true;
+	switch (record.type)
+	{
+	case AS3935TraceRecord::AS3935_TRACE_READ:
+	case AS3935TraceRecord::AS3935_TRACE_WRITE:
+		ok = (index_ + 2 <= length_);
+		if (ok)
+		{
+			record.reg = data_[index_++];
+			record.value = data_[index_++];
+		}
+		break;
+	case AS3935TraceRecord::AS3935_TRACE_IRQ:
+		ok = (index_ + 1 <= length_);
+		if (ok)
+			record.value = data_[index_++];
+		break;
+	case AS3935TraceRecord::AS3935_TRACE_OSCILLATOR:
+		ok = getVarint(record.duration) && getVarint(record.period);
+		break;
+	default:
+		ok = false;
+		break;
+	}
+
+	if (!ok)
+	{
+		index_ = start;
+		return false;
+	}
+
+	timestamp_ = record.timestamp;
+	return true;
+}
+
+void AS3935TraceReader::rewind()
+{
+	index_ = AS3935_TRACE_HEADER_SIZE;
+	timestamp_ = 0;
+}
+
+void AS3935TraceReader::header(uint8_t *header)
+{
+	header[0] = 'A';
+	header[1] = 'T';
+	header[2] = static_cast<uint8_t>(AS3935_TRACE_VERSION);
+	header[3] = static_cast<uint8_t>(AS3935_TRACE_VERSION >> 8);
+}
+
+uint8_t AS3935TraceReader::encode(const AS3935TraceRecord &record, uint32_t previous, uint8_t *buffer)
+{
+	uint8_t size = 0;
+
+	buffer[size++] = record.type;
+
+	//zigzag encoding, records may be written out of order by a few milliseconds
+	const int32_t delta = static_cast<int32_t>(record.timestamp - previous);
+	size += putVarint((static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31), buffer + size);
+
+	switch (record.type)
+	{
+	case AS3935TraceRecord::AS3935_TRACE_READ:
+	case AS3935TraceRecord::AS3935_TRACE_WRITE:
+		buffer[size++] = record.reg;
+		buffer[size++] = record.value;
+		break;
+	case AS3935TraceRecord::AS3935_TRACE_IRQ:
+		buffer[size++] = record.value;
+		break;
+	case AS3935TraceRecord::AS3935_TRACE_OSCILLATOR:
+		size += putVarint(record.duration, buffer + size);
+		size += putVarint(record.period, buffer + size);
+		break;
+	}
+
+	return size;
+}
+
+bool AS3935TraceReader::getVarint(uint32_t &value)
+{
+	value = 0;
+	uint8_t shift = 0;
+	uint8_t byte = 0;
+
+	do
+	{
+		if ((index_ >= length_) || (shift >= 35))
+			return false;
+
+		byte = data_[index_++];
+
+		value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+
+	return true;
+}
+
+uint8_t AS3935TraceReader::putVarint(uint32_t value, uint8_t *buffer)
+{
+	uint8_t size = 0;
+
+	while (value >= 0x80)
+	{
+		buffer[size++] = static_cast<uint8_t>(value) | 0x80;
+		value >>= 7;
+	}
+
+	buffer[size++] = static_cast<uint8_t>(value);
+
+	return size;
+}
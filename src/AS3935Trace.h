@@ -0,0 +1,114 @@
+//Yet Another Arduino ams AS3935 'Franklin' lightning sensor library 
+// Copyright (c) 2018-2019 Gregor Christandl <christandlg@yahoo.com>
+// home: https://bitbucket.org/christandlg/as3935mi
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef AS3935TRACE_H_
+#define AS3935TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+//binary trace of the bus traffic and IRQ pin activity of a sensor, written by AS3935Recorder. 
+//the trace starts with a 4 byte header ("AT" and the format version, 2 bytes). each record consists of the 
+//record type byte, the time since the previous record in microseconds (signed, zigzag varint) and a payload:
+//  AS3935_TRACE_READ:        register address (1 byte), value returned by the sensor (1 byte)
+//  AS3935_TRACE_WRITE:       register address (1 byte), value written (1 byte)
+//  AS3935_TRACE_IRQ:         new level of the IRQ pin (1 byte)
+//  AS3935_TRACE_OSCILLATOR:  time the oscillator was displayed on the IRQ pin in microseconds (varint), 
+//                            period of the signal on the IRQ pin in nanoseconds (varint, 0 if unknown)
+struct AS3935TraceRecord
+{
+	enum record_type_t : uint8_t
+	{
+		AS3935_TRACE_READ = 0x01,
+		AS3935_TRACE_WRITE = 0x02,
+		AS3935_TRACE_IRQ = 0x03,
+		AS3935_TRACE_OSCILLATOR = 0x04
+	};
+
+	uint8_t type;
+	uint32_t timestamp;		//time in microseconds (micros() of the recording device)
+	uint8_t reg;			//register address of reads and writes
+	uint8_t value;			//register value of reads and writes, pin level of IRQ records
+	uint32_t duration;		//duration of oscillator records in microseconds
+	uint32_t period;		//signal period of oscillator records in nanoseconds
+};
+
+//reads the records of a trace stored in memory.
+class AS3935TraceReader
+{
+public:
+	static const uint8_t AS3935_TRACE_HEADER_SIZE = 4;
+	static const uint16_t AS3935_TRACE_VERSION = 1;
+
+	/*
+	@param data trace. must stay valid during the lifetime of this object. 
+	@param length length of the trace in bytes. */
+	AS3935TraceReader(const uint8_t *data, size_t length);
+
+	/*
+	@return true if the trace starts with a valid header, false otherwise. */
+	bool valid() const {
+		return valid_;
+	}
+
+	/*
+	reads the next record. 
+	@param record (by reference, write only) will hold the next record.
+	@return true if a record was read, false at the end of the trace or if the trace is truncated or invalid. */
+	bool next(AS3935TraceRecord &record);
+
+	/*
+	restarts reading at the first record. */
+	void rewind();
+
+	/*
+	writes a trace header. 
+	@param header (write only) AS3935_TRACE_HEADER_SIZE bytes. */
+	static void header(uint8_t *header);
+
+	/*
+	encodes a record. 
+	@param record record to encode.
+	@param previous timestamp of the previous record.
+	@param buffer (write only) AS3935_TRACE_MAX_RECORD_SIZE bytes. 
+	@return size of the encoded record in bytes. */
+	static uint8_t encode(const AS3935TraceRecord &record, uint32_t previous, uint8_t *buffer);
+
+	//maximum size of a single encoded record in bytes
+	static const uint8_t AS3935_TRACE_MAX_RECORD_SIZE = 1 + 5 + 5 + 5;
+
+private:
+	/*
+	reads a varint. 
+	@param value (by reference, write only) decoded value.
+	@return true on success, false if the trace is truncated. */
+	bool getVarint(uint32_t &value);
+
+	/*
+	writes a value as varint. 
+	@return number of bytes written. */
+	static uint8_t putVarint(uint32_t value, uint8_t *buffer);
+
+	const uint8_t *data_;
+	size_t length_;
+	size_t index_;
+	uint32_t timestamp_;
+	bool valid_;
+};
+
+#endif /* AS3935TRACE_H_ */
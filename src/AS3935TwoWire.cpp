@@ -31,15 +31,41 @@ AS3935TwoWire::~AS3935TwoWire()
 }
 
 bool AS3935TwoWire::beginInterface()
+{
+	return AS3935TwoWireBus(wire_, address_).beginInterface();
+}
+
+uint8_t AS3935TwoWire::readRegister(uint8_t reg)
+{
+	return AS3935TwoWireBus(wire_, address_).readRegister(reg);
+}
+
+void AS3935TwoWire::writeRegister(uint8_t reg, uint8_t value)
+{
+	AS3935TwoWireBus(wire_, address_).writeRegister(reg, value);
+}
+
+void AS3935TwoWire::readRegisters(uint8_t reg, uint8_t *values, uint8_t count)
+{
+	AS3935TwoWireBus(wire_, address_).readRegisters(reg, values, count);
+}
+
+AS3935TwoWireBus::AS3935TwoWireBus(TwoWire *wire, uint8_t address) :
+	wire_(wire),
+	address_(address)
+{
+}
+
+bool AS3935TwoWireBus::beginInterface()
 {
 	if (!wire_)
 		return false;
 
 	switch (address_)
 	{
-	case AS3935I2C_A01:
-	case AS3935I2C_A10:
-	case AS3935I2C_A11:
+	case AS3935TwoWire::AS3935I2C_A01:
+	case AS3935TwoWire::AS3935I2C_A10:
+	case AS3935TwoWire::AS3935I2C_A11:
 		break;
 	default:
 		//return false if an invalid I2C address was given.
@@ -49,7 +75,7 @@ bool AS3935TwoWire::beginInterface()
 	return true;
 }
 
-uint8_t AS3935TwoWire::readRegister(uint8_t reg)
+uint8_t AS3935TwoWireBus::readRegister(uint8_t reg)
 {
 	if (!wire_)
 		return 0;
@@ -69,7 +95,7 @@ uint8_t AS3935TwoWire::readRegister(uint8_t reg)
 	return wire_->read();
 }
 
-void AS3935TwoWire::writeRegister(uint8_t reg, uint8_t value)
+void AS3935TwoWireBus::writeRegister(uint8_t reg, uint8_t value)
 {
 	if (!wire_)
 		return;
@@ -78,4 +104,26 @@ void AS3935TwoWire::writeRegister(uint8_t reg, uint8_t value)
 	wire_->write(reg);
 	wire_->write(value);
 	wire_->endTransmission();
+}
+
+void AS3935TwoWireBus::readRegisters(uint8_t reg, uint8_t *values, uint8_t count)
+{
+	if (!wire_)
+	{
+		memset(values, 0, count);
+		return;
+	}
+
+#if defined(ARDUINO_SAM_DUE)
+	//see readRegister()
+	wire_->requestFrom(address_, count, reg, 1, true);
+#else
+	wire_->beginTransmission(address_);
+	wire_->write(reg);
+	wire_->endTransmission(false);
+	wire_->requestFrom(address_, count);
+#endif
+
+	for (uint8_t i = 0; i < count; i++)
+		values[i] = wire_->read();
 }
\ No newline at end of file
@@ -50,6 +50,33 @@ private:
 	virtual uint8_t readRegister(uint8_t reg);
 
 	virtual void writeRegister(uint8_t reg, uint8_t value);
+
+	virtual void readRegisters(uint8_t reg, uint8_t *values, uint8_t count);
+};
+
+//I2C bus for AS3935Driver<Bus>, binds the sensor to a TwoWire object at compile time. e.g.
+//AS3935Driver<AS3935TwoWireBus> as3935(PIN_IRQ, AS3935TwoWireBus(&Wire, AS3935TwoWire::AS3935I2C_A01));
+class AS3935TwoWireBus
+{
+public:
+	AS3935TwoWireBus(TwoWire *wire, uint8_t address);
+
+private:
+	template <class Bus> friend class AS3935Driver;
+	friend class AS3935TwoWire;
+
+	bool beginInterface();
+
+	uint8_t readRegister(uint8_t reg);
+
+	void writeRegister(uint8_t reg, uint8_t value);
+
+	//reads consecutive registers in a single transfer, the sensor increments the register address
+	void readRegisters(uint8_t reg, uint8_t *values, uint8_t count);
+
+	TwoWire *wire_;
+
+	uint8_t address_;
 };
 
 #endif /* AS3935TWOWIRE_H_ */